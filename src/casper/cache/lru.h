@@ -0,0 +1,201 @@
+/**
+ * @file lru.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_CACHE_LRU_H_
+#define CASPER_CACHE_LRU_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <stddef.h> // size_t
+
+#include <list>
+#include <functional>
+
+namespace casper
+{
+
+    namespace cache
+    {
+    
+        /**
+         * @brief Least recently used entries list, shared by all caches.
+         *
+         *        Not thread safe, owners are expected to hold their own lock; entries are kept least recently used
+         *        first, \link Touch \link moves one to the end without copying it.
+         *
+         *        \link Release \link is called for every entry that leaves the list, so owned resources
+         *        ( and any accounting kept by owner ) are handled in a single place.
+         */
+        template <typename E>
+        class LRU final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            typedef typename std::list<E>::iterator       Iterator;
+            typedef typename std::list<E>::const_iterator ConstIterator;
+            typedef std::function<void(E&)>               Release;
+            
+        private: // Const Data
+            
+            const size_t  capacity_; //!< Maximum number of entries.
+            const Release release_;  //!< Optional, called for every entry that leaves the list.
+            
+        private: // Data
+            
+            std::list<E>  entries_;  //!< Least recently used first.
+            
+        public: // Constructor(s) / Destructor
+            
+            LRU () = delete;
+            
+            /**
+             * @brief Default constructor.
+             *
+             * @param a_capacity Maximum number of entries.
+             * @param a_release  Optional, called for every entry that leaves the list.
+             */
+            LRU (const size_t a_capacity, const Release a_release = nullptr)
+             : capacity_(a_capacity), release_(a_release)
+            {
+                /* empty */
+            }
+            
+            /**
+             * @brief Destructor.
+             */
+            virtual ~LRU ()
+            {
+                Clear();
+            }
+            
+        public: // Method(s) / Function(s)
+            
+            /**
+             * @brief Mark an entry as the most recently used one.
+             *
+             * @param a_it Entry to move to the end of the list.
+             */
+            inline void Touch (Iterator a_it)
+            {
+                entries_.splice(entries_.end(), entries_, a_it);
+            }
+            
+            /**
+             * @brief Add an entry as the most recently used one, evicting least recently used ones to respect capacity.
+             *
+             * @param a_entry Entry to add.
+             *
+             * @return Number of entries evicted.
+             */
+            inline size_t Push (E&& a_entry)
+            {
+                size_t evicted = 0;
+                while ( entries_.size() > 0 && entries_.size() >= capacity_ ) {
+                    Evict();
+                    evicted++;
+                }
+                entries_.push_back(std::move(a_entry));
+                return evicted;
+            }
+            
+            /**
+             * @brief Release and remove the least recently used entry.
+             */
+            inline void Evict ()
+            {
+                Erase(entries_.begin());
+            }
+            
+            /**
+             * @brief Release and remove an entry.
+             *
+             * @param a_it Entry to remove.
+             *
+             * @return Iterator following removed entry.
+             */
+            inline Iterator Erase (Iterator a_it)
+            {
+                if ( nullptr != release_ ) {
+                    release_(*a_it);
+                }
+                return entries_.erase(a_it);
+            }
+            
+            /**
+             * @brief Release and remove all entries that match a predicate.
+             *
+             * @param a_predicate Returns true for entries to remove.
+             */
+            inline void EraseIf (const std::function<bool(const E&)>& a_predicate)
+            {
+                for ( auto it = entries_.begin() ; entries_.end() != it ; ) {
+                    if ( true == a_predicate(*it) ) {
+                        it = Erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            
+            /**
+             * @brief Find the first entry that matches a predicate.
+             *
+             * @param a_predicate Returns true for the wanted entry.
+             *
+             * @return Matching entry, \link end \link if none.
+             */
+            inline Iterator Find (const std::function<bool(const E&)>& a_predicate)
+            {
+                for ( auto it = entries_.begin() ; entries_.end() != it ; ++it ) {
+                    if ( true == a_predicate(*it) ) {
+                        return it;
+                    }
+                }
+                return entries_.end();
+            }
+            
+            /**
+             * @brief Release and remove all entries.
+             */
+            inline void Clear ()
+            {
+                while ( entries_.size() > 0 ) {
+                    Evict();
+                }
+            }
+            
+        public: // Inline Method(s) / Function(s)
+            
+            inline size_t        size     () const { return entries_.size(); }
+            inline size_t        capacity () const { return capacity_;       }
+            inline Iterator      begin    ()       { return entries_.begin(); }
+            inline Iterator      end      ()       { return entries_.end();   }
+            inline ConstIterator begin    () const { return entries_.begin(); }
+            inline ConstIterator end      () const { return entries_.end();   }
+            
+        }; // end of class 'LRU'
+    
+    } // end of namespace 'cache'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_CACHE_LRU_H_
@@ -0,0 +1,255 @@
+/**
+ * @file hex.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/codec/hex.h"
+
+#include "cc/exception.h"
+#include "cc/types.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @brief Encode bytes to upper case hex, using the widest vector unit available.
+ *
+ * @param a_bytes Bytes to encode.
+ * @param a_size  Number of bytes to encode.
+ * @param o_hex   Where to write hex characters to, must have room for 2 * a_size characters ( no NUL is written ).
+ */
+void casper::codec::Hex::Encode (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool sk_avx2_ = __builtin_cpu_supports("avx2");
+    if ( true == sk_avx2_ ) {
+        EncodeAVX2(a_bytes, a_size, o_hex);
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    EncodeSSE2(a_bytes, a_size, o_hex);
+#else
+    EncodeScalar(a_bytes, a_size, o_hex);
+#endif
+}
+
+/**
+ * @brief Decode hex characters ( upper or lower case ) to bytes, using the widest vector unit available.
+ *
+ * @param a_hex    Hex characters to decode.
+ * @param a_length Number of characters to decode, must be even.
+ * @param o_bytes  Where to write decoded bytes to, must have room for a_length / 2 bytes.
+ *
+ * @return Number of decoded bytes.
+ */
+size_t casper::codec::Hex::Decode (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes)
+{
+    if ( 0 != ( a_length % 2 ) ) {
+        throw ::cc::Exception("Unable to decode hex data: odd number of characters ( " SIZET_FMT " )!", a_length);
+    }
+#if defined(__SSE2__)
+    DecodeSSE2(a_hex, a_length, o_bytes);
+#else
+    DecodeScalar(a_hex, a_length, o_bytes, 0);
+#endif
+    return a_length / 2;
+}
+
+// MARK: - [PRIVATE] - Static Method(s) / Function(s)
+
+/**
+ * @brief Encode bytes to upper case hex, one byte at a time.
+ *
+ * @param a_bytes Bytes to encode.
+ * @param a_size  Number of bytes to encode.
+ * @param o_hex   Where to write hex characters to.
+ */
+void casper::codec::Hex::EncodeScalar (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex)
+{
+    static const char* const sk_digits_ = "0123456789ABCDEF";
+    for ( size_t idx = 0 ; idx < a_size ; ++idx ) {
+        o_hex[2 * idx]     = static_cast<unsigned char>(sk_digits_[( a_bytes[idx] & 0xF0 ) >> 4]);
+        o_hex[2 * idx + 1] = static_cast<unsigned char>(sk_digits_[( a_bytes[idx] & 0x0F )]);
+    }
+}
+
+/**
+ * @brief Decode hex characters to bytes, one byte at a time.
+ *
+ * @param a_hex      Hex characters to decode.
+ * @param a_length   Number of characters to decode, must be even.
+ * @param o_bytes    Where to write decoded bytes to.
+ * @param a_position Position of a_hex in the original input, for error reporting.
+ */
+void casper::codec::Hex::DecodeScalar (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes, const size_t a_position)
+{
+    // ... 0xFF marks an invalid character ...
+    static const struct Table {
+        unsigned char values_[256];
+        Table () {
+            for ( size_t idx = 0 ; idx < 256 ; ++idx ) {
+                values_[idx] = 0xFF;
+            }
+            for ( unsigned char idx = 0 ; idx < 10 ; ++idx ) {
+                values_['0' + idx] = idx;
+            }
+            for ( unsigned char idx = 0 ; idx < 6 ; ++idx ) {
+                values_['A' + idx] = static_cast<unsigned char>(10 + idx);
+                values_['a' + idx] = static_cast<unsigned char>(10 + idx);
+            }
+        }
+    } sk_table_;
+    
+    for ( size_t idx = 0 ; idx < a_length ; idx += 2 ) {
+        const unsigned char hi = sk_table_.values_[a_hex[idx]];
+        const unsigned char lo = sk_table_.values_[a_hex[idx + 1]];
+        if ( 0xFF == hi || 0xFF == lo ) {
+            const size_t at = ( 0xFF == hi ? idx : idx + 1 );
+            throw ::cc::Exception("Unable to decode hex data: invalid character 0x%02X at position " SIZET_FMT "!",
+                                  static_cast<unsigned>(a_hex[at]), a_position + at);
+        }
+        o_bytes[idx / 2] = static_cast<unsigned char>(( hi << 4 ) | lo);
+    }
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @brief Encode bytes to upper case hex, 16 bytes at a time.
+ *
+ * @param a_bytes Bytes to encode.
+ * @param a_size  Number of bytes to encode.
+ * @param o_hex   Where to write hex characters to.
+ */
+void casper::codec::Hex::EncodeSSE2 (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex)
+{
+    const __m128i mask   = _mm_set1_epi8(0x0F);
+    const __m128i zero   = _mm_set1_epi8('0');
+    const __m128i nine   = _mm_set1_epi8(9);
+    const __m128i letter = _mm_set1_epi8('A' - '0' - 10);
+    
+    // ... nibble ( 0..15 ) to ascii: '0' + n, plus 7 when n > 9 ...
+    const auto ascii = [&] (const __m128i a_nibbles) -> __m128i {
+        return _mm_add_epi8(_mm_add_epi8(a_nibbles, zero), _mm_and_si128(_mm_cmpgt_epi8(a_nibbles, nine), letter));
+    };
+    
+    size_t idx = 0;
+    for ( ; idx + 16 <= a_size ; idx += 16 ) {
+        const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_bytes + idx));
+        const __m128i hi = ascii(_mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        const __m128i lo = ascii(_mm_and_si128(v, mask));
+        // ... interleave high and low nibbles ...
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o_hex + 2 * idx)     , _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o_hex + 2 * idx + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    
+    // ... tail ...
+    EncodeScalar(a_bytes + idx, a_size - idx, o_hex + 2 * idx);
+}
+
+/**
+ * @brief Decode hex characters to bytes, 32 characters at a time.
+ *
+ * @param a_hex    Hex characters to decode.
+ * @param a_length Number of characters to decode, must be even.
+ * @param o_bytes  Where to write decoded bytes to.
+ */
+void casper::codec::Hex::DecodeSSE2 (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes)
+{
+    const __m128i below_0 = _mm_set1_epi8('0' - 1);
+    const __m128i above_9 = _mm_set1_epi8('9' + 1);
+    const __m128i below_a = _mm_set1_epi8('a' - 1);
+    const __m128i above_f = _mm_set1_epi8('f' + 1);
+    const __m128i lower   = _mm_set1_epi8(0x20);
+    const __m128i zero    = _mm_set1_epi8('0');
+    const __m128i ten_a   = _mm_set1_epi8('a' - 10);
+    const __m128i low8    = _mm_set1_epi16(0x00FF);
+    
+    // ... ascii to nibble, sets o_valid to all ones for each valid character; bytes >= 0x80 are negative so they never pass ...
+    const auto nibbles = [&] (const __m128i a_chars, __m128i& o_valid) -> __m128i {
+        const __m128i is_digit  = _mm_and_si128(_mm_cmpgt_epi8(a_chars, below_0), _mm_cmpgt_epi8(above_9, a_chars));
+        const __m128i folded    = _mm_or_si128(a_chars, lower);
+        const __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(folded, below_a), _mm_cmpgt_epi8(above_f, folded));
+        o_valid = _mm_or_si128(is_digit, is_letter);
+        return _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(a_chars, zero)), _mm_andnot_si128(is_digit, _mm_sub_epi8(folded, ten_a)));
+    };
+    
+    // ... pairs of nibbles, as 16 bit lanes ( little endian: high nibble is the low byte ), to bytes ...
+    const auto pack = [&] (const __m128i a_nibbles) -> __m128i {
+        return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(a_nibbles, low8), 4), _mm_srli_epi16(a_nibbles, 8));
+    };
+    
+    size_t idx = 0;
+    for ( ; idx + 32 <= a_length ; idx += 32 ) {
+        __m128i       valid_a, valid_b;
+        const __m128i a = nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_hex + idx))     , valid_a);
+        const __m128i b = nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_hex + idx + 16)), valid_b);
+        if ( 0xFFFF != _mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) ) {
+            // ... let scalar version report the offending character ...
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o_bytes + idx / 2), _mm_packus_epi16(pack(a), pack(b)));
+    }
+    
+    // ... tail ( or invalid block ) ...
+    DecodeScalar(a_hex + idx, a_length - idx, o_bytes + idx / 2, idx);
+}
+
+#endif // __SSE2__
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * @brief Encode bytes to upper case hex, 32 bytes at a time.
+ *
+ * @param a_bytes Bytes to encode.
+ * @param a_size  Number of bytes to encode.
+ * @param o_hex   Where to write hex characters to.
+ */
+__attribute__((target("avx2")))
+void casper::codec::Hex::EncodeAVX2 (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex)
+{
+    const __m256i mask   = _mm256_set1_epi8(0x0F);
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+                                            '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    
+    size_t idx = 0;
+    for ( ; idx + 32 <= a_size ; idx += 32 ) {
+        const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_bytes + idx));
+        const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, mask));
+        // ... unpack works per 128 bit lane: [0..7|16..23] and [8..15|24..31] ...
+        const __m256i a  = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i b  = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o_hex + 2 * idx)     , _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o_hex + 2 * idx + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    
+    // ... tail ...
+    EncodeScalar(a_bytes + idx, a_size - idx, o_hex + 2 * idx);
+}
+
+#endif // __x86_64__ || __i386__
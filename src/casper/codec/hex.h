@@ -0,0 +1,68 @@
+/**
+ * @file hex.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_CODEC_HEX_H_
+#define CASPER_CODEC_HEX_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <stddef.h> // size_t
+
+namespace casper
+{
+
+    namespace codec
+    {
+    
+        class Hex final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Constructor(s) / Destructor
+            
+            Hex () = delete;
+            
+        public: // Static Method(s) / Function(s)
+            
+            static void   Encode (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex);
+            static size_t Decode (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes);
+            
+        private: // Static Method(s) / Function(s)
+            
+            static void EncodeScalar (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex);
+#if defined(__SSE2__)
+            static void EncodeSSE2   (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex);
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+            static void EncodeAVX2   (const unsigned char* a_bytes, const size_t a_size, unsigned char* o_hex);
+#endif
+            
+            static void DecodeScalar (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes, const size_t a_position);
+#if defined(__SSE2__)
+            static void DecodeSSE2   (const unsigned char* a_hex, const size_t a_length, unsigned char* o_bytes);
+#endif
+            
+        }; // end of class 'Hex'
+        
+    } // end of namespace 'codec'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_CODEC_HEX_H_
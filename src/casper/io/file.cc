@@ -0,0 +1,334 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/file.h"
+
+#include "casper/io/stdio/file.h"
+#include "casper/io/posix/file.h"
+#include "casper/io/mapped/file.h"
+#include "casper/io/uring/file.h"
+
+#include <errno.h>
+#include <string.h>   // memset, strerror
+#include <strings.h>  // strcasecmp
+#include <algorithm>  // std::min, std::max
+#include <fcntl.h>    // open
+#include <unistd.h>   // read, write, close
+#include <sys/stat.h> // stat, fstat
+#if defined(__linux__)
+  #include <sys/ioctl.h>    // ioctl
+  #include <sys/sendfile.h> // sendfile
+  #include <linux/fs.h>     // FICLONE
+#endif
+
+// MARK: - STATIC CONST DATA
+
+const char* const casper::io::File::sk_err_msg_fmt_unable_to_open_file_with_            = "Unable to open file '%s': %s !";
+const char* const casper::io::File::sk_err_msg_fmt_unable_to_close_file_with_           = "Unable to close file '%s': %s !";
+const char* const casper::io::File::sk_err_msg_fmt_unable_to_stat_file_with_            = "Unable to stat file '%s': %s !";
+const char* const casper::io::File::sk_err_msg_fmt_unable_to_seek_to_position_of_file_  = "Unable to seek to file postion " SIZET_FMT ": %s !";
+const char* const casper::io::File::sk_err_msg_fmt_read_error_                          = "Unable to read data from file - %s!";
+const char* const casper::io::File::sk_err_msg_fmt_read_mismatch_                       = "Unable to read data from file - bytes read size mismatch - read " SIZET_FMT ", expecting " SIZET_FMT "!";
+const char* const casper::io::File::sk_err_msg_fmt_write_error_                         = "Unable to write data to file: %s!";
+const char* const casper::io::File::sk_err_msg_fmt_write_mismatch_                      = "Unable to write data to file: bytes written differs - wrote " SIZET_FMT ", expecting " SIZET_FMT "!";
+const char* const casper::io::File::sk_err_msg_not_open_                                = "File is not open!";
+const char* const casper::io::File::sk_err_msg_already_open_                            = "File is already open!";
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Chunk size used by buffered operations, in bytes.
+ */
+casper::io::File::File (const size_t a_buffer_size)
+ : buffer_size_(std::max(a_buffer_size, static_cast<size_t>(1)))
+{
+    mode_   = Mode::Read;
+    buffer_ = new unsigned char[buffer_size_];
+    stats_  = { 0, 0, 0.0, "" };
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::File::~File ()
+{
+    delete [] buffer_;
+}
+
+// MARK: -
+
+/**
+ * @brief Read a range of bytes, delivering them in chunks.
+ *
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::File::Read (const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    const auto start     = std::chrono::steady_clock::now();
+    size_t     offset    = a_offset;
+    size_t     remainder = a_length;
+    while ( remainder > 0 ) {
+        const size_t chunk_size = std::min(buffer_size_, remainder);
+        Read(offset, buffer_, chunk_size);
+        a_callback(buffer_, chunk_size);
+        offset    += chunk_size;
+        remainder -= chunk_size;
+    }
+    Account(a_length, start);
+}
+
+/**
+ * @brief Write the same byte value to a range of bytes.
+ *
+ * @param a_offset Offset of the first byte to write.
+ * @param a_value  Value to write.
+ * @param a_length Number of bytes to write.
+ */
+void casper::io::File::Fill (const size_t a_offset, const unsigned char a_value, const size_t a_length)
+{
+    size_t offset    = a_offset;
+    size_t remainder = a_length;
+    memset(buffer_, a_value, std::min(buffer_size_, remainder));
+    while ( remainder > 0 ) {
+        const size_t chunk_size = std::min(buffer_size_, remainder);
+        Write(offset, buffer_, chunk_size);
+        offset    += chunk_size;
+        remainder -= chunk_size;
+    }
+}
+
+// MARK: - [PROTECTED] - Method(s) / Function(s)
+
+/**
+ * @brief Account a range read in \link Stats \link.
+ *
+ * @param a_bytes Number of bytes delivered.
+ * @param a_start When range read started.
+ */
+void casper::io::File::Account (const size_t a_bytes, const std::chrono::steady_clock::time_point& a_start)
+{
+    stats_.bytes_      += a_bytes;
+    stats_.elapsed_us_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - a_start).count());
+    stats_.bandwidth_   = ( stats_.elapsed_us_ > 0 ? ( static_cast<double>(stats_.bytes_) / 1048576.0 ) / ( static_cast<double>(stats_.elapsed_us_) / 1000000.0 ) : 0.0 );
+}
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @brief Create a new \link File \link for a specific backend.
+ *
+ * @param a_settings See \link File::Settings \link.
+ *
+ * @return New instance, caller must delete it when it's no longer needed.
+ */
+casper::io::File* casper::io::File::New (const casper::io::File::Settings& a_settings)
+{
+    switch (a_settings.backend_) {
+        case File::Backend::Stdio:
+            return new casper::io::stdio::File(a_settings.buffer_size_);
+        case File::Backend::POSIX:
+            return new casper::io::posix::File(a_settings.buffer_size_);
+        case File::Backend::MMap:
+            return new casper::io::mapped::File(a_settings.buffer_size_);
+        case File::Backend::URing:
+            return new casper::io::uring::File(a_settings.buffer_size_, a_settings.queue_depth_);
+        default:
+            throw ::cc::Exception("I/O backend " UINT8_FMT " not implemented!", static_cast<uint8_t>(a_settings.backend_));
+    }
+}
+
+/**
+ * @brief Translate a C string to a \link File::Backend \link.
+ *
+ * @param a_backend Backend name, case insensitive ( 'stdio', 'posix', 'mmap' or 'uring' ).
+ *
+ * @return One of \link File::Backend \link.
+ */
+casper::io::File::Backend casper::io::File::CString2Backend (const char* const a_backend)
+{
+    for ( auto backend : { File::Backend::Stdio, File::Backend::POSIX, File::Backend::MMap, File::Backend::URing } ) {
+        if ( 0 == strcasecmp(a_backend, Backend2CString(backend)) ) {
+            return backend;
+        }
+    }
+    throw ::cc::Exception("Don't know how to translate '%s' to an I/O backend!", a_backend);
+}
+
+/**
+ * @brief Copy a file, using the cheapest strategy the filesystem supports.
+ *
+ * @param a_from      Local file URI to copy from.
+ * @param a_to        Local file URI to copy to.
+ * @param a_overwrite When true, an existing destination file is truncated.
+ * @param a_callback  Optional, called with copied bytes, in order, when they pass through userspace ( \link CopyStrategy::ReadWrite \link ).
+ *
+ * @return One of \link CopyStrategy \link, the one that was used.
+ */
+casper::io::File::CopyStrategy casper::io::File::Copy (const std::string& a_from, const std::string& a_to, const bool a_overwrite,
+                                                       const casper::io::File::Callback& a_callback)
+{
+    int          in       = -1;
+    int          out      = -1;
+    CopyStrategy strategy = CopyStrategy::None;
+    try {
+        
+        in = open(a_from.c_str(), O_RDONLY | O_CLOEXEC);
+        if ( -1 == in ) {
+            throw ::cc::Exception(sk_err_msg_fmt_unable_to_open_file_with_, a_from.c_str(), strerror(errno));
+        }
+        struct stat st;
+        if ( 0 != fstat(in, &st) ) {
+            throw ::cc::Exception(sk_err_msg_fmt_unable_to_stat_file_with_, a_from.c_str(), strerror(errno));
+        }
+        out = open(a_to.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | ( true == a_overwrite ? O_TRUNC : O_EXCL ), 0666);
+        if ( -1 == out ) {
+            throw ::cc::Exception(sk_err_msg_fmt_unable_to_open_file_with_, a_to.c_str(), strerror(errno));
+        }
+        
+        const size_t size = static_cast<size_t>(st.st_size);
+        size_t       done = 0;
+        
+#if defined(__linux__)
+        // ... share data blocks ( btrfs, xfs, ... ) ...
+        if ( 0 == ioctl(out, FICLONE, in) ) {
+            strategy = CopyStrategy::Reflink;
+            done     = size;
+        }
+        // ... in kernel copy ...
+        if ( CopyStrategy::None == strategy ) {
+            while ( done < size ) {
+                const ssize_t bw = copy_file_range(in, nullptr, out, nullptr, size - done, 0);
+                if ( -1 == bw ) {
+                    if ( EINTR == errno ) {
+                        continue;
+                    }
+                    // ... not supported by kernel or filesystem(s)? fallback only if nothing was copied yet ...
+                    if ( 0 == done && ( ENOSYS == errno || EXDEV == errno || EINVAL == errno || EOPNOTSUPP == errno ) ) {
+                        break;
+                    }
+                    throw ::cc::Exception(sk_err_msg_fmt_write_error_, strerror(errno));
+                } else if ( 0 == bw ) {
+                    throw ::cc::Exception(sk_err_msg_fmt_write_mismatch_, done, size);
+                }
+                done    += static_cast<size_t>(bw);
+                strategy = CopyStrategy::CopyFileRange;
+            }
+        }
+        if ( CopyStrategy::None == strategy ) {
+            off_t offset = 0;
+            while ( done < size ) {
+                const ssize_t bw = sendfile(out, in, &offset, size - done);
+                if ( -1 == bw ) {
+                    if ( EINTR == errno ) {
+                        continue;
+                    }
+                    if ( 0 == done && ( EINVAL == errno || ENOSYS == errno ) ) {
+                        break;
+                    }
+                    throw ::cc::Exception(sk_err_msg_fmt_write_error_, strerror(errno));
+                } else if ( 0 == bw ) {
+                    throw ::cc::Exception(sk_err_msg_fmt_write_mismatch_, done, size);
+                }
+                done    += static_cast<size_t>(bw);
+                strategy = CopyStrategy::SendFile;
+            }
+        }
+#endif
+        // ... last resort, userspace copy ...
+        if ( CopyStrategy::None == strategy && done < size ) {
+            unsigned char buffer[65536];
+            while ( done < size ) {
+                const ssize_t br = read(in, buffer, std::min(sizeof(buffer), size - done));
+                if ( -1 == br ) {
+                    if ( EINTR == errno ) {
+                        continue;
+                    }
+                    throw ::cc::Exception(sk_err_msg_fmt_read_error_, strerror(errno));
+                } else if ( 0 == br ) {
+                    throw ::cc::Exception(sk_err_msg_fmt_read_mismatch_, done, size);
+                }
+                if ( nullptr != a_callback ) {
+                    a_callback(buffer, static_cast<size_t>(br));
+                }
+                size_t written = 0;
+                while ( written < static_cast<size_t>(br) ) {
+                    const ssize_t bw = write(out, buffer + written, static_cast<size_t>(br) - written);
+                    if ( -1 == bw ) {
+                        if ( EINTR == errno ) {
+                            continue;
+                        }
+                        throw ::cc::Exception(sk_err_msg_fmt_write_error_, strerror(errno));
+                    }
+                    written += static_cast<size_t>(bw);
+                }
+                done += written;
+            }
+            strategy = CopyStrategy::ReadWrite;
+        }
+        
+        if ( 0 != close(out) ) {
+            out = -1;
+            throw ::cc::Exception(sk_err_msg_fmt_unable_to_close_file_with_, a_to.c_str(), strerror(errno));
+        }
+        out = -1;
+        (void)close(in);
+        in = -1;
+        
+    } catch (...) {
+        if ( -1 != out ) {
+            (void)close(out);
+        }
+        if ( -1 != in ) {
+            (void)close(in);
+        }
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+    return strategy;
+}
+
+/**
+ * @brief Collect file identity, used by caches to detect file changes.
+ *
+ * @param a_uri      Local file URI.
+ * @param o_identity See \link File::Identity \link.
+ *
+ * @return True when file exists, false otherwise.
+ */
+bool casper::io::File::Identify (const std::string& a_uri, casper::io::File::Identity& o_identity)
+{
+    struct stat st;
+    if ( 0 != stat(a_uri.c_str(), &st) ) {
+        return false;
+    }
+    o_identity.device_   = st.st_dev;
+    o_identity.inode_    = st.st_ino;
+    o_identity.size_     = static_cast<size_t>(st.st_size);
+#ifdef __APPLE__
+    o_identity.mtime_ns_ = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+#else
+    o_identity.mtime_ns_ = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + static_cast<int64_t>(st.st_mtim.tv_nsec);
+#endif
+    return true;
+}
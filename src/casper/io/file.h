@@ -0,0 +1,229 @@
+/**
+ * @file file.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_FILE_H_
+#define CASPER_IO_FILE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+#include "cc/exception.h"
+#include "cc/types.h"
+
+#include <inttypes.h>  // uint8_t
+#include <sys/types.h> // dev_t, ino_t
+#include <string>
+#include <chrono>      // std::chrono
+#include <functional>  // std::function
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        class File : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            enum class Backend : uint8_t {
+                Stdio = 0, //!< FILE* - fseek / fread / fwrite.
+                POSIX,     //!< File descriptor - pread / pwrite.
+                MMap,      //!< Memory mapped reads, pwrite writes ( falls back to POSIX if file can't be mapped ).
+                URing      //!< Read-ahead pipeline reads ( io_uring or reader thread, see \link Stats::engine_ \link ), pwrite writes.
+            };
+            
+            enum class CopyStrategy : uint8_t {
+                None = 0,      //!< Nothing was copied.
+                Reflink,       //!< FICLONE, data blocks are shared - no data movement.
+                CopyFileRange, //!< copy_file_range, in kernel ( and server side, for some filesystems ) copy.
+                SendFile,      //!< sendfile, in kernel copy.
+                ReadWrite      //!< Userspace read / write loop.
+            };
+            
+            enum class Mode : uint8_t {
+                Read = 0,
+                ReadWrite
+            };
+            
+            typedef struct {
+                Backend backend_;     //!< One of \link Backend \link.
+                size_t  buffer_size_; //!< Chunk size used by buffered operations, in bytes.
+                size_t  queue_depth_; //!< Number of buffers kept in flight by read-ahead backends.
+            } Settings;
+            
+            typedef struct {
+                size_t      bytes_;      //!< Number of bytes delivered by range reads.
+                uint64_t    elapsed_us_; //!< Time spent in range reads, including callbacks, in microseconds.
+                double      bandwidth_;  //!< Achieved range read bandwidth, in MiB/s.
+                const char* engine_;     //!< Engine that served range reads - 'io_uring' or 'thread' for read-ahead backends, empty otherwise.
+            } Stats;
+            
+            typedef struct {
+                dev_t   device_;   //!< File device.
+                ino_t   inode_;    //!< File inode.
+                size_t  size_;     //!< File size, in bytes.
+                int64_t mtime_ns_; //!< File modification time, in nanoseconds.
+            } Identity;
+            
+            typedef std::function<void(const unsigned char*, const size_t&)> Callback;
+            
+        protected: // Static Const Data
+            
+            static const char* const sk_err_msg_fmt_unable_to_open_file_with_;
+            static const char* const sk_err_msg_fmt_unable_to_close_file_with_;
+            static const char* const sk_err_msg_fmt_unable_to_stat_file_with_;
+            static const char* const sk_err_msg_fmt_unable_to_seek_to_position_of_file_;
+            static const char* const sk_err_msg_fmt_read_error_;
+            static const char* const sk_err_msg_fmt_read_mismatch_;
+            static const char* const sk_err_msg_fmt_write_error_;
+            static const char* const sk_err_msg_fmt_write_mismatch_;
+            static const char* const sk_err_msg_not_open_;
+            static const char* const sk_err_msg_already_open_;
+            
+        protected: // Const Data
+            
+            const size_t   buffer_size_;
+            
+        protected: // Data
+            
+            std::string    uri_;
+            Mode           mode_;
+            unsigned char* buffer_;
+            Stats          stats_;
+            
+        public: // Constructor(s) / Destructor
+            
+            File () = delete;
+            File (const size_t a_buffer_size);
+            
+            virtual ~File ();
+            
+        public: // Pure Virtual Method(s) / Function(s)
+            
+            virtual void   Open  (const std::string& a_uri, const Mode a_mode) = 0;
+            virtual size_t Size  () = 0;
+            virtual void   Read  (const size_t a_offset, unsigned char* o_buffer, const size_t a_length) = 0;
+            virtual void   Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length) = 0;
+            virtual void   Close () = 0;
+            
+        public: // Virtual Method(s) / Function(s)
+            
+            virtual void   Read  (const size_t a_offset, const size_t a_length, Callback a_callback);
+            virtual void   Fill  (const size_t a_offset, const unsigned char a_value, const size_t a_length);
+            
+        public: // Inline Method(s) / Function(s)
+            
+            const std::string& uri         () const;
+            const size_t&      buffer_size () const;
+            const Stats&       stats       () const;
+            
+        protected: // Method(s) / Function(s)
+            
+            void Account (const size_t a_bytes, const std::chrono::steady_clock::time_point& a_start);
+            
+        public: // Static Method(s) / Function(s)
+            
+            static File*             New             (const Settings& a_settings);
+            static const char* const Backend2CString (const Backend& a_backend);
+            static Backend           CString2Backend (const char* const a_backend);
+            static CopyStrategy      Copy            (const std::string& a_from, const std::string& a_to, const bool a_overwrite, const Callback& a_callback = nullptr);
+            static const char* const CopyStrategy2CString (const CopyStrategy& a_strategy);
+            static bool              Identify        (const std::string& a_uri, Identity& o_identity);
+            
+        }; // end of class 'File'
+        
+        /**
+         * @return R/O access to currently open file URI.
+         */
+        inline const std::string& File::uri () const
+        {
+            return uri_;
+        }
+        
+        /**
+         * @return R/O access to chunk size used by buffered operations.
+         */
+        inline const size_t& File::buffer_size () const
+        {
+            return buffer_size_;
+        }
+        
+        /**
+         * @return R/O access to range reads statistics.
+         */
+        inline const File::Stats& File::stats () const
+        {
+            return stats_;
+        }
+        
+        /**
+         * @brief Translate a \link File::Backend \link to a C string.
+         *
+         * @param a_backend One of \link File::Backend \link.
+         *
+         * @return Backend as C string.
+         */
+        inline const char* const File::Backend2CString (const File::Backend& a_backend)
+        {
+            switch(a_backend) {
+                case File::Backend::Stdio:
+                    return "stdio";
+                case File::Backend::POSIX:
+                    return "posix";
+                case File::Backend::MMap:
+                    return "mmap";
+                case File::Backend::URing:
+                    return "uring";
+                default:
+                    throw ::cc::Exception("Don't know how to translate I/O backend " UINT8_FMT " to string!", static_cast<uint8_t>(a_backend));
+            }
+        }
+        
+        /**
+         * @brief Translate a \link File::CopyStrategy \link to a C string.
+         *
+         * @param a_strategy One of \link File::CopyStrategy \link.
+         *
+         * @return Strategy as C string.
+         */
+        inline const char* const File::CopyStrategy2CString (const File::CopyStrategy& a_strategy)
+        {
+            switch(a_strategy) {
+                case File::CopyStrategy::None:
+                    return "none";
+                case File::CopyStrategy::Reflink:
+                    return "reflink";
+                case File::CopyStrategy::CopyFileRange:
+                    return "copy_file_range";
+                case File::CopyStrategy::SendFile:
+                    return "sendfile";
+                case File::CopyStrategy::ReadWrite:
+                    return "read/write";
+                default:
+                    throw ::cc::Exception("Don't know how to translate copy strategy " UINT8_FMT " to string!", static_cast<uint8_t>(a_strategy));
+            }
+        }
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_FILE_H_
@@ -0,0 +1,146 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/mapped/file.h"
+
+#include "cc/exception.h"
+#include "cc/macros.h"
+
+#include <string.h>   // memcpy
+#include <unistd.h>   // sysconf
+#include <sys/mman.h> // mmap, madvise, munmap
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Chunk size used by buffered operations, in bytes.
+ */
+casper::io::mapped::File::File (const size_t a_buffer_size)
+ : casper::io::posix::File(a_buffer_size)
+{
+    map_      = nullptr;
+    map_size_ = 0;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::mapped::File::~File ()
+{
+    Unmap();
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from io::posix::File
+
+/**
+ * @brief Open a file and map it in to memory.
+ *
+ * @param a_uri  Local file URI.
+ * @param a_mode One of \link Mode \link.
+ */
+void casper::io::mapped::File::Open (const std::string& a_uri, const casper::io::File::Mode a_mode)
+{
+    casper::io::posix::File::Open(a_uri, a_mode);
+    
+    const size_t size = Size();
+    if ( 0 == size ) {
+        return;
+    }
+    
+    // ... writes are done with pwrite, a shared mapping keeps reads coherent with them ...
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if ( MAP_FAILED == map ) {
+        // ... not fatal, fallback to pread ...
+        return;
+    }
+    
+    map_      = static_cast<unsigned char*>(map);
+    map_size_ = size;
+}
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to read.
+ * @param o_buffer Where to write read bytes to.
+ * @param a_length Number of bytes to read.
+ */
+void casper::io::mapped::File::Read (const size_t a_offset, unsigned char* o_buffer, const size_t a_length)
+{
+    if ( false == IsMapped(a_offset, a_length) ) {
+        casper::io::posix::File::Read(a_offset, o_buffer, a_length);
+    } else {
+        memcpy(o_buffer, map_ + a_offset, a_length);
+    }
+}
+
+/**
+ * @brief Read a range of bytes, delivering them in a single chunk straight from mapped memory.
+ *
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver bytes.
+ */
+void casper::io::mapped::File::Read (const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    if ( false == IsMapped(a_offset, a_length) ) {
+        casper::io::posix::File::Read(a_offset, a_length, a_callback);
+        return;
+    }
+    if ( 0 == a_length ) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    // ... hints only, failures are harmless ...
+    const size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = ( a_offset / page ) * page;
+    (void)madvise(map_ + start, a_length + ( a_offset - start ), MADV_SEQUENTIAL);
+    (void)madvise(map_ + start, a_length + ( a_offset - start ), MADV_WILLNEED);
+    // ... no copies ...
+    a_callback(map_ + a_offset, a_length);
+    Account(a_length, now);
+}
+
+/**
+ * @brief Unmap and close the currently open file.
+ */
+void casper::io::mapped::File::Close ()
+{
+    Unmap();
+    casper::io::posix::File::Close();
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Release mapped memory, if any.
+ */
+void casper::io::mapped::File::Unmap ()
+{
+    if ( nullptr == map_ ) {
+        return;
+    }
+    (void)munmap(map_, map_size_);
+    map_      = nullptr;
+    map_size_ = 0;
+}
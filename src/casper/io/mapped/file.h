@@ -0,0 +1,86 @@
+/**
+ * @file file.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_MAPPED_FILE_H_
+#define CASPER_IO_MAPPED_FILE_H_
+
+#include "casper/io/posix/file.h"
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        namespace mapped
+        {
+        
+            class File final : public ::casper::io::posix::File
+            {
+                
+            private: // Data
+                
+                unsigned char* map_;
+                size_t         map_size_;
+                
+            public: // Constructor(s) / Destructor
+                
+                File () = delete;
+                File (const size_t a_buffer_size);
+                
+                virtual ~File ();
+                
+            public: // Inherited Method(s) / Function(s) from io::posix::File
+                
+                virtual void Open  (const std::string& a_uri, const Mode a_mode);
+                virtual void Read  (const size_t a_offset, unsigned char* o_buffer, const size_t a_length);
+                virtual void Read  (const size_t a_offset, const size_t a_length, Callback a_callback);
+                virtual void Close ();
+                
+            public: // Inline Method(s) / Function(s)
+                
+                bool IsMapped (const size_t a_offset, const size_t a_length) const;
+                
+            private: // Method(s) / Function(s)
+                
+                void Unmap ();
+                
+            }; // end of class 'File'
+            
+            /**
+             * @brief Check if a range of bytes is available in mapped memory.
+             *
+             * @param a_offset Offset of the first byte.
+             * @param a_length Number of bytes.
+             *
+             * @return True if range can be served from mapped memory, false otherwise.
+             */
+            inline bool File::IsMapped (const size_t a_offset, const size_t a_length) const
+            {
+                return ( nullptr != map_ && a_offset <= map_size_ && a_length <= ( map_size_ - a_offset ) );
+            }
+        
+        } // end of namespace 'mapped'
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_MAPPED_FILE_H_
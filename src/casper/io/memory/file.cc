@@ -0,0 +1,196 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/memory/file.h"
+
+#include "cc/exception.h"
+#include "cc/macros.h"
+
+#include <string.h> // memcpy
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Chunk size used by buffered operations, in bytes.
+ */
+casper::io::memory::File::File (const size_t a_buffer_size)
+ : casper::io::File(a_buffer_size)
+{
+    bytes_  = nullptr;
+    size_   = 0;
+    vector_ = nullptr;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::memory::File::~File ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from io::File
+
+/**
+ * @brief Not supported, memory files are opened from a buffer.
+ *
+ * @param a_uri  Local file URI.
+ * @param a_mode One of \link Mode \link.
+ */
+void casper::io::memory::File::Open (const std::string& a_uri, const casper::io::File::Mode /* a_mode */)
+{
+    throw ::cc::Exception(sk_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), "memory files must be opened from a buffer");
+}
+
+/**
+ * @return Buffer size, in bytes.
+ */
+size_t casper::io::memory::File::Size ()
+{
+    if ( nullptr == bytes_ && nullptr == vector_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    return ( nullptr != vector_ ? vector_->size() : size_ );
+}
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to read.
+ * @param o_buffer Where to write read bytes to.
+ * @param a_length Number of bytes to read.
+ */
+void casper::io::memory::File::Read (const size_t a_offset, unsigned char* o_buffer, const size_t a_length)
+{
+    Check(a_offset, a_length);
+    memcpy(o_buffer, Data() + a_offset, a_length);
+}
+
+/**
+ * @brief Read a range of bytes, delivering them in a single chunk straight from memory.
+ *
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver bytes.
+ */
+void casper::io::memory::File::Read (const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    Check(a_offset, a_length);
+    if ( 0 == a_length ) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    a_callback(Data() + a_offset, a_length);
+    Account(a_length, now);
+}
+
+/**
+ * @brief Write an exact number of bytes, buffer grows if needed.
+ *
+ * @param a_offset Offset of the first byte to write.
+ * @param a_bytes  Bytes to write.
+ * @param a_length Number of bytes to write.
+ */
+void casper::io::memory::File::Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length)
+{
+    if ( nullptr == vector_ ) {
+        throw ::cc::Exception(sk_err_msg_fmt_write_error_, ( nullptr == bytes_ ? sk_err_msg_not_open_ : "buffer is read only" ));
+    }
+    if ( vector_->size() < a_offset + a_length ) {
+        vector_->resize(a_offset + a_length, 0);
+    }
+    if ( 0 != a_length ) {
+        memcpy(vector_->data() + a_offset, a_bytes, a_length);
+    }
+}
+
+/**
+ * @brief Release buffer reference.
+ */
+void casper::io::memory::File::Close ()
+{
+    if ( nullptr == bytes_ && nullptr == vector_ ) {
+        return;
+    }
+    bytes_  = nullptr;
+    size_   = 0;
+    vector_ = nullptr;
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Open a read only buffer.
+ *
+ * @param a_bytes Buffer, must outlive this object ( or until \link Close \link is called ).
+ * @param a_size  Buffer size, in bytes.
+ */
+void casper::io::memory::File::Open (const unsigned char* a_bytes, const size_t a_size)
+{
+    if ( nullptr != bytes_ || nullptr != vector_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_already_open_);
+    }
+    bytes_ = a_bytes;
+    size_  = a_size;
+    uri_   = "memory://";
+    mode_  = Mode::Read;
+}
+
+/**
+ * @brief Open a read / write buffer.
+ *
+ * @param a_buffer Buffer, must outlive this object ( or until \link Close \link is called ).
+ */
+void casper::io::memory::File::Open (std::vector<unsigned char>& a_buffer)
+{
+    if ( nullptr != bytes_ || nullptr != vector_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_already_open_);
+    }
+    vector_ = &a_buffer;
+    uri_    = "memory://";
+    mode_   = Mode::ReadWrite;
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @return Currently open buffer data.
+ */
+const unsigned char* casper::io::memory::File::Data () const
+{
+    return ( nullptr != vector_ ? vector_->data() : bytes_ );
+}
+
+/**
+ * @brief Ensure a range of bytes is available.
+ *
+ * @param a_offset Offset of the first byte.
+ * @param a_length Number of bytes.
+ */
+void casper::io::memory::File::Check (const size_t a_offset, const size_t a_length)
+{
+    const size_t size = Size();
+    if ( a_offset > size || a_length > ( size - a_offset ) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_read_mismatch_, ( a_offset > size ? 0 : size - a_offset ), a_length);
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/posix/file.h"
+
+#include "cc/exception.h"
+#include "cc/macros.h"
+
+#include <errno.h>
+#include <string.h>   // strerror
+#include <fcntl.h>    // open, posix_fadvise
+#include <unistd.h>   // pread, pwrite, close
+#include <sys/stat.h> // fstat
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Chunk size used by buffered operations, in bytes.
+ */
+casper::io::posix::File::File (const size_t a_buffer_size)
+ : casper::io::File(a_buffer_size)
+{
+    fd_ = -1;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::posix::File::~File ()
+{
+    if ( -1 != fd_ ) {
+        (void)close(fd_);
+    }
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from io::File
+
+/**
+ * @brief Open a file.
+ *
+ * @param a_uri  Local file URI.
+ * @param a_mode One of \link Mode \link.
+ */
+void casper::io::posix::File::Open (const std::string& a_uri, const casper::io::File::Mode a_mode)
+{
+    if ( -1 != fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_already_open_);
+    }
+    fd_ = open(a_uri.c_str(), ( Mode::ReadWrite == a_mode ? O_RDWR : O_RDONLY ) | O_CLOEXEC);
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), strerror(errno));
+    }
+    uri_  = a_uri;
+    mode_ = a_mode;
+}
+
+/**
+ * @return File size, in bytes.
+ */
+size_t casper::io::posix::File::Size ()
+{
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    struct stat st;
+    if ( 0 != fstat(fd_, &st) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_stat_file_with_, uri_.c_str(), strerror(errno));
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to read.
+ * @param o_buffer Where to write read bytes to.
+ * @param a_length Number of bytes to read.
+ */
+void casper::io::posix::File::Read (const size_t a_offset, unsigned char* o_buffer, const size_t a_length)
+{
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    size_t done = 0;
+    while ( done < a_length ) {
+        const ssize_t br = pread(fd_, o_buffer + done, a_length - done, static_cast<off_t>(a_offset + done));
+        if ( -1 == br ) {
+            if ( EINTR == errno ) {
+                continue;
+            }
+            throw ::cc::Exception(sk_err_msg_fmt_read_error_, strerror(errno));
+        } else if ( 0 == br ) {
+            throw ::cc::Exception(sk_err_msg_fmt_read_mismatch_, done, a_length);
+        }
+        done += static_cast<size_t>(br);
+    }
+}
+
+/**
+ * @brief Read a range of bytes, delivering them in chunks.
+ *
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::posix::File::Read (const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    // ... hint only, failure is harmless ...
+    (void)posix_fadvise(fd_, static_cast<off_t>(a_offset), static_cast<off_t>(a_length), POSIX_FADV_SEQUENTIAL);
+    // ... buffered read ...
+    casper::io::File::Read(a_offset, a_length, a_callback);
+}
+
+/**
+ * @brief Write an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to write.
+ * @param a_bytes  Bytes to write.
+ * @param a_length Number of bytes to write.
+ */
+void casper::io::posix::File::Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length)
+{
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    size_t done = 0;
+    while ( done < a_length ) {
+        const ssize_t bw = pwrite(fd_, a_bytes + done, a_length - done, static_cast<off_t>(a_offset + done));
+        if ( -1 == bw ) {
+            if ( EINTR == errno ) {
+                continue;
+            }
+            throw ::cc::Exception(sk_err_msg_fmt_write_error_, strerror(errno));
+        } else if ( 0 == bw ) {
+            throw ::cc::Exception(sk_err_msg_fmt_write_mismatch_, done, a_length);
+        }
+        done += static_cast<size_t>(bw);
+    }
+}
+
+/**
+ * @brief Close the currently open file.
+ */
+void casper::io::posix::File::Close ()
+{
+    if ( -1 == fd_ ) {
+        return;
+    }
+    const int fd = fd_;
+    fd_ = -1;
+    if ( 0 != close(fd) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_close_file_with_, uri_.c_str(), strerror(errno));
+    }
+}
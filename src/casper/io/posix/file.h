@@ -0,0 +1,66 @@
+/**
+ * @file file.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_POSIX_FILE_H_
+#define CASPER_IO_POSIX_FILE_H_
+
+#include "casper/io/file.h"
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        namespace posix
+        {
+        
+            class File : public ::casper::io::File
+            {
+                
+            protected: // Data
+                
+                int fd_;
+                
+            public: // Constructor(s) / Destructor
+                
+                File () = delete;
+                File (const size_t a_buffer_size);
+                
+                virtual ~File ();
+                
+            public: // Inherited Method(s) / Function(s) from io::File
+                
+                virtual void   Open  (const std::string& a_uri, const Mode a_mode);
+                virtual size_t Size  ();
+                virtual void   Read  (const size_t a_offset, unsigned char* o_buffer, const size_t a_length);
+                virtual void   Read  (const size_t a_offset, const size_t a_length, Callback a_callback);
+                virtual void   Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length);
+                virtual void   Close ();
+                
+            }; // end of class 'File'
+        
+        } // end of namespace 'posix'
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_POSIX_FILE_H_
@@ -0,0 +1,307 @@
+/**
+ * @file read_ahead.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/read_ahead.h"
+
+#include "cc/exception.h"
+#include "cc/types.h"
+
+#include <errno.h>
+#include <string.h>  // strerror
+#include <unistd.h>  // pread
+#include <algorithm> // std::min, std::max
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <exception> // std::exception_ptr
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_depth      Number of buffers to keep in flight.
+ * @param a_chunk_size Size of each buffer, in bytes.
+ */
+casper::io::ReadAhead::ReadAhead (const size_t a_depth, const size_t a_chunk_size)
+ : depth_(std::max(a_depth, static_cast<size_t>(2))), chunk_size_(std::max(a_chunk_size, static_cast<size_t>(1)))
+{
+    for ( size_t idx = 0 ; idx < depth_ ; ++idx ) {
+        buffers_.push_back(new unsigned char[chunk_size_]);
+    }
+    engine_ = Engine::Thread;
+#ifdef CASPER_IO_URING
+    // ... kernel might not support it ( or it's blocked ), fallback to reader thread ...
+    if ( 0 == io_uring_queue_init(static_cast<unsigned>(depth_), &ring_, 0) ) {
+        engine_ = Engine::URing;
+    }
+#endif
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::ReadAhead::~ReadAhead ()
+{
+#ifdef CASPER_IO_URING
+    if ( Engine::URing == engine_ ) {
+        io_uring_queue_exit(&ring_);
+    }
+#endif
+    for ( auto buffer : buffers_ ) {
+        delete [] buffer;
+    }
+}
+
+// MARK: -
+
+/**
+ * @brief Read a range of bytes, delivering them in order while next chunks are being read.
+ *
+ * @param a_fd       File descriptor.
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::ReadAhead::Read (const int a_fd, const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    // ... nothing to overlap?
+    if ( a_length <= chunk_size_ ) {
+        if ( a_length > 0 ) {
+            PRead(a_fd, buffers_[0], a_length, a_offset);
+            a_callback(buffers_[0], a_length);
+        }
+        return;
+    }
+#ifdef CASPER_IO_URING
+    if ( Engine::URing == engine_ ) {
+        ReadWithURing(a_fd, a_offset, a_length, a_callback);
+        return;
+    }
+#endif
+    ReadWithThread(a_fd, a_offset, a_length, a_callback);
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Read a range of bytes using a reader thread.
+ *
+ * @param a_fd       File descriptor.
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::ReadAhead::ReadWithThread (const int a_fd, const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    const size_t count = ( a_length + chunk_size_ - 1 ) / chunk_size_;
+    
+    std::mutex              mutex;
+    std::condition_variable cv;
+    size_t                  produced = 0;
+    size_t                  consumed = 0;
+    bool                    aborted  = false;
+    std::exception_ptr      error    = nullptr;
+    
+    // ... producer: keeps up to depth_ chunks ahead of consumer ...
+    std::thread reader([&] () {
+        for ( size_t idx = 0 ; idx < count ; ++idx ) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return aborted || idx < consumed + depth_; });
+                if ( true == aborted ) {
+                    return;
+                }
+            }
+            const size_t offset = idx * chunk_size_;
+            try {
+                PRead(a_fd, buffers_[idx % depth_], std::min(chunk_size_, a_length - offset), a_offset + offset);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                cv.notify_all();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                produced = idx + 1;
+            }
+            cv.notify_all();
+        }
+    });
+    
+    // ... consumer: hash ( or whatever ) chunk N while N+1..N+depth_ are being read ...
+    try {
+        for ( size_t idx = 0 ; idx < count ; ++idx ) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return nullptr != error || idx < produced; });
+                if ( idx >= produced ) {
+                    std::rethrow_exception(error);
+                }
+            }
+            const size_t offset = idx * chunk_size_;
+            a_callback(buffers_[idx % depth_], std::min(chunk_size_, a_length - offset));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed = idx + 1;
+            }
+            cv.notify_all();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+        }
+        cv.notify_all();
+        reader.join();
+        throw;
+    }
+    
+    reader.join();
+}
+
+#ifdef CASPER_IO_URING
+
+/**
+ * @brief Read a range of bytes using io_uring.
+ *
+ * @param a_fd       File descriptor.
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::ReadAhead::ReadWithURing (const int a_fd, const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    const size_t count = ( a_length + chunk_size_ - 1 ) / chunk_size_;
+    
+    std::vector<ssize_t> results(depth_, -1);
+    size_t               submitted = 0;
+    size_t               consumed  = 0;
+    size_t               in_flight = 0;
+    
+    const auto chunk_length = [this, a_length] (const size_t a_idx) -> size_t {
+        return std::min(chunk_size_, a_length - a_idx * chunk_size_);
+    };
+    
+    const auto submit = [&] () {
+        // ... a slot can only be reused after it's chunk was delivered ...
+        while ( submitted < count && submitted < consumed + depth_ ) {
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+            if ( nullptr == sqe ) {
+                break;
+            }
+            io_uring_prep_read(sqe, a_fd, buffers_[submitted % depth_], static_cast<unsigned>(chunk_length(submitted)), a_offset + submitted * chunk_size_);
+            sqe->user_data = static_cast<__u64>(submitted);
+            results[submitted % depth_] = -1;
+            ++submitted;
+            ++in_flight;
+        }
+        const int rv = io_uring_submit(&ring_);
+        if ( rv < 0 ) {
+            throw ::cc::Exception("Unable to submit read requests: %s!", strerror(-rv));
+        }
+    };
+    
+    const auto drain = [&] () {
+        while ( in_flight > 0 ) {
+            struct io_uring_cqe* cqe = nullptr;
+            if ( 0 != io_uring_wait_cqe(&ring_, &cqe) ) {
+                break;
+            }
+            io_uring_cqe_seen(&ring_, cqe);
+            --in_flight;
+        }
+    };
+    
+    try {
+        
+        // ... fill the queue ...
+        submit();
+        
+        for ( size_t idx = 0 ; idx < count ; ++idx ) {
+            const size_t slot = idx % depth_;
+            // ... wait for this chunk, completions might arrive out of order ...
+            while ( -1 == results[slot] ) {
+                struct io_uring_cqe* cqe = nullptr;
+                const int rv = io_uring_wait_cqe(&ring_, &cqe);
+                if ( 0 != rv ) {
+                    throw ::cc::Exception("Unable to wait for read completion: %s!", strerror(-rv));
+                }
+                const size_t  done = static_cast<size_t>(cqe->user_data);
+                const ssize_t res  = static_cast<ssize_t>(cqe->res);
+                io_uring_cqe_seen(&ring_, cqe);
+                --in_flight;
+                if ( res < 0 ) {
+                    throw ::cc::Exception("Unable to read data from file - %s!", strerror(static_cast<int>(-res)));
+                }
+                results[done % depth_] = res;
+            }
+            // ... short read? complete it synchronously ...
+            const size_t length = chunk_length(idx);
+            if ( static_cast<size_t>(results[slot]) < length ) {
+                const size_t br = static_cast<size_t>(results[slot]);
+                PRead(a_fd, buffers_[slot] + br, length - br, a_offset + idx * chunk_size_ + br);
+            }
+            // ... deliver chunk N while N+1..N+depth_-1 are in flight ...
+            a_callback(buffers_[slot], length);
+            // ... slot is free, reuse it ...
+            results[slot] = -1;
+            consumed      = idx + 1;
+            submit();
+        }
+        
+    } catch (...) {
+        // ... kernel might still be writing to our buffers ...
+        drain();
+        throw;
+    }
+}
+
+#endif // CASPER_IO_URING
+
+// MARK: - [PRIVATE] - Static Method(s) / Function(s)
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @param a_fd     File descriptor.
+ * @param o_buffer Where to write read bytes to.
+ * @param a_length Number of bytes to read.
+ * @param a_offset Offset of the first byte to read.
+ */
+void casper::io::ReadAhead::PRead (const int a_fd, unsigned char* o_buffer, const size_t a_length, const size_t a_offset)
+{
+    size_t done = 0;
+    while ( done < a_length ) {
+        const ssize_t br = pread(a_fd, o_buffer + done, a_length - done, static_cast<off_t>(a_offset + done));
+        if ( -1 == br ) {
+            if ( EINTR == errno ) {
+                continue;
+            }
+            throw ::cc::Exception("Unable to read data from file - %s!", strerror(errno));
+        } else if ( 0 == br ) {
+            throw ::cc::Exception("Unable to read data from file - bytes read size mismatch - read " SIZET_FMT ", expecting " SIZET_FMT "!", done, a_length);
+        }
+        done += static_cast<size_t>(br);
+    }
+}
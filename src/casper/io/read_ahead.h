@@ -0,0 +1,134 @@
+/**
+ * @file read_ahead.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_READ_AHEAD_H_
+#define CASPER_IO_READ_AHEAD_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include "casper/io/file.h"
+
+#include <inttypes.h> // uint8_t
+#include <vector>
+
+#ifdef CASPER_IO_URING
+    #include <liburing.h>
+#endif
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        /**
+         * @brief Reads a range of bytes delivering chunk N while chunks N+1..N+depth are being read.
+         *
+         *        The io_uring engine is only built when CASPER_IO_URING is defined, linking with liburing ( -luring );
+         *        otherwise, or when the kernel refuses to set up a ring, a reader thread is used - see \link engine \link.
+         */
+        class ReadAhead final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            enum class Engine : uint8_t {
+                Thread = 0, //!< A reader thread fills buffers with pread.
+                URing       //!< Reads are queued in an io_uring.
+            };
+            
+        private: // Const Data
+            
+            const size_t depth_;
+            const size_t chunk_size_;
+            
+        private: // Data
+            
+            std::vector<unsigned char*> buffers_;
+            Engine                      engine_;
+#ifdef CASPER_IO_URING
+            struct io_uring             ring_;
+#endif
+            
+        public: // Constructor(s) / Destructor
+            
+            ReadAhead () = delete;
+            ReadAhead (const size_t a_depth, const size_t a_chunk_size);
+            
+            virtual ~ReadAhead ();
+            
+        public: // Method(s) / Function(s)
+            
+            void Read (const int a_fd, const size_t a_offset, const size_t a_length, File::Callback a_callback);
+            
+        public: // Inline Method(s) / Function(s)
+            
+            const Engine& engine () const;
+            
+        public: // Static Method(s) / Function(s)
+            
+            static const char* const Engine2CString (const Engine& a_engine);
+            
+        private: // Method(s) / Function(s)
+            
+            void ReadWithThread (const int a_fd, const size_t a_offset, const size_t a_length, File::Callback a_callback);
+#ifdef CASPER_IO_URING
+            void ReadWithURing  (const int a_fd, const size_t a_offset, const size_t a_length, File::Callback a_callback);
+#endif
+            
+        private: // Static Method(s) / Function(s)
+            
+            static void PRead (const int a_fd, unsigned char* o_buffer, const size_t a_length, const size_t a_offset);
+            
+        }; // end of class 'ReadAhead'
+        
+        /**
+         * @return R/O access to the engine in use.
+         */
+        inline const ReadAhead::Engine& ReadAhead::engine () const
+        {
+            return engine_;
+        }
+        
+        /**
+         * @brief Translate a \link ReadAhead::Engine \link to a C string.
+         *
+         * @param a_engine One of \link ReadAhead::Engine \link.
+         *
+         * @return Engine as C string.
+         */
+        inline const char* const ReadAhead::Engine2CString (const ReadAhead::Engine& a_engine)
+        {
+            switch(a_engine) {
+                case ReadAhead::Engine::Thread:
+                    return "thread";
+                case ReadAhead::Engine::URing:
+                    return "io_uring";
+                default:
+                    throw ::cc::Exception("Don't know how to translate read-ahead engine " UINT8_FMT " to string!", static_cast<uint8_t>(a_engine));
+            }
+        }
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_READ_AHEAD_H_
@@ -0,0 +1,158 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/stdio/file.h"
+
+#include "cc/exception.h"
+#include "cc/macros.h"
+
+#include <errno.h>
+#include <string.h> // strerror
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Chunk size used by buffered operations, in bytes.
+ */
+casper::io::stdio::File::File (const size_t a_buffer_size)
+ : casper::io::File(a_buffer_size)
+{
+    fp_ = nullptr;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::stdio::File::~File ()
+{
+    if ( nullptr != fp_ ) {
+        (void)fclose(fp_);
+    }
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from io::File
+
+/**
+ * @brief Open a file.
+ *
+ * @param a_uri  Local file URI.
+ * @param a_mode One of \link Mode \link.
+ */
+void casper::io::stdio::File::Open (const std::string& a_uri, const casper::io::File::Mode a_mode)
+{
+    if ( nullptr != fp_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_already_open_);
+    }
+    fp_ = fopen(a_uri.c_str(), ( Mode::ReadWrite == a_mode ? "r+" : "r" ));
+    if ( nullptr == fp_ ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), strerror(errno));
+    }
+    uri_  = a_uri;
+    mode_ = a_mode;
+}
+
+/**
+ * @return File size, in bytes.
+ */
+size_t casper::io::stdio::File::Size ()
+{
+    if ( nullptr == fp_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    if ( 0 != fseek(fp_, 0, SEEK_END) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_seek_to_position_of_file_, static_cast<size_t>(0), strerror(errno));
+    }
+    const long size = ftell(fp_);
+    if ( -1 == size ) {
+        throw ::cc::Exception(sk_err_msg_fmt_read_error_, strerror(errno));
+    }
+    return static_cast<size_t>(size);
+}
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to read.
+ * @param o_buffer Where to write read bytes to.
+ * @param a_length Number of bytes to read.
+ */
+void casper::io::stdio::File::Read (const size_t a_offset, unsigned char* o_buffer, const size_t a_length)
+{
+    Seek(a_offset);
+    const size_t br = fread(o_buffer, sizeof(unsigned char), a_length, fp_);
+    if ( 0 != ferror(fp_) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_read_error_, strerror(errno));
+    } else if ( a_length != br ) {
+        throw ::cc::Exception(sk_err_msg_fmt_read_mismatch_, br, a_length);
+    }
+}
+
+/**
+ * @brief Write an exact number of bytes.
+ *
+ * @param a_offset Offset of the first byte to write.
+ * @param a_bytes  Bytes to write.
+ * @param a_length Number of bytes to write.
+ */
+void casper::io::stdio::File::Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length)
+{
+    Seek(a_offset);
+    const size_t bw = fwrite(a_bytes, sizeof(unsigned char), a_length, fp_);
+    if ( 0 != ferror(fp_) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_write_error_, strerror(errno));
+    } else if ( a_length != bw ) {
+        throw ::cc::Exception(sk_err_msg_fmt_write_mismatch_, bw, a_length);
+    }
+}
+
+/**
+ * @brief Close the currently open file.
+ */
+void casper::io::stdio::File::Close ()
+{
+    if ( nullptr == fp_ ) {
+        return;
+    }
+    FILE* fp = fp_;
+    fp_ = nullptr;
+    if ( 0 != fclose(fp) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_close_file_with_, uri_.c_str(), strerror(errno));
+    }
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Move file position indicator.
+ *
+ * @param a_offset Offset from the beginning of the file.
+ */
+void casper::io::stdio::File::Seek (const size_t a_offset)
+{
+    if ( nullptr == fp_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    if ( 0 != fseek(fp_, static_cast<long>(a_offset), SEEK_SET) ) {
+        throw ::cc::Exception(sk_err_msg_fmt_unable_to_seek_to_position_of_file_, a_offset, strerror(errno));
+    }
+}
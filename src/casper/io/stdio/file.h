@@ -0,0 +1,73 @@
+/**
+ * @file file.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_STDIO_FILE_H_
+#define CASPER_IO_STDIO_FILE_H_
+
+#include "casper/io/file.h"
+
+#include <stdio.h> // FILE
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        namespace stdio
+        {
+        
+            class File final : public ::casper::io::File
+            {
+                
+            private: // Data
+                
+                FILE* fp_;
+                
+            public: // Constructor(s) / Destructor
+                
+                File () = delete;
+                File (const size_t a_buffer_size);
+                
+                virtual ~File ();
+                
+            public: // Inherited Method(s) / Function(s) from io::File
+                
+                virtual void   Open  (const std::string& a_uri, const Mode a_mode);
+                virtual size_t Size  ();
+                virtual void   Read  (const size_t a_offset, unsigned char* o_buffer, const size_t a_length);
+                virtual void   Write (const size_t a_offset, const unsigned char* a_bytes, const size_t a_length);
+                virtual void   Close ();
+                
+                using ::casper::io::File::Read;
+                
+            private: // Method(s) / Function(s)
+                
+                void Seek (const size_t a_offset);
+                
+            }; // end of class 'File'
+        
+        } // end of namespace 'stdio'
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_STDIO_FILE_H_
@@ -0,0 +1,72 @@
+/**
+ * @file file.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/uring/file.h"
+
+#include "cc/exception.h"
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_buffer_size Size of each read-ahead buffer, in bytes.
+ * @param a_queue_depth Number of buffers kept in flight.
+ */
+casper::io::uring::File::File (const size_t a_buffer_size, const size_t a_queue_depth)
+ : casper::io::posix::File(a_buffer_size), queue_depth_(a_queue_depth)
+{
+    read_ahead_ = nullptr;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::io::uring::File::~File ()
+{
+    if ( nullptr != read_ahead_ ) {
+        delete read_ahead_;
+    }
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from io::posix::File
+
+/**
+ * @brief Read a range of bytes, delivering chunk N while chunks N+1..N+k are being read.
+ *
+ * @param a_offset   Offset of the first byte to read.
+ * @param a_length   Number of bytes to read.
+ * @param a_callback Function to call to deliver each chunk, in order.
+ */
+void casper::io::uring::File::Read (const size_t a_offset, const size_t a_length, casper::io::File::Callback a_callback)
+{
+    if ( -1 == fd_ ) {
+        throw ::cc::Exception("%s", sk_err_msg_not_open_);
+    }
+    // ... buffers and ring are only set up when needed ...
+    if ( nullptr == read_ahead_ ) {
+        read_ahead_ = new ReadAhead(queue_depth_, buffer_size_);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    read_ahead_->Read(fd_, a_offset, a_length, a_callback);
+    Account(a_length, start);
+    stats_.engine_ = ReadAhead::Engine2CString(read_ahead_->engine());
+}
@@ -0,0 +1,69 @@
+/**
+ * @file file.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_IO_URING_FILE_H_
+#define CASPER_IO_URING_FILE_H_
+
+#include "casper/io/posix/file.h"
+
+#include "casper/io/read_ahead.h"
+
+namespace casper
+{
+
+    namespace io
+    {
+    
+        namespace uring
+        {
+        
+            class File final : public ::casper::io::posix::File
+            {
+                
+            private: // Const Data
+                
+                const size_t queue_depth_;
+                
+            private: // Data
+                
+                ReadAhead* read_ahead_;
+                
+            public: // Constructor(s) / Destructor
+                
+                File () = delete;
+                File (const size_t a_buffer_size, const size_t a_queue_depth);
+                
+                virtual ~File ();
+                
+            public: // Inherited Method(s) / Function(s) from io::posix::File
+                
+                virtual void Read (const size_t a_offset, const size_t a_length, Callback a_callback);
+                
+                using ::casper::io::posix::File::Read;
+                
+            }; // end of class 'File'
+        
+        } // end of namespace 'uring'
+        
+    } // end of namespace 'io'
+    
+} // end of namespace 'casper'
+
+#endif // CASPER_IO_URING_FILE_H_
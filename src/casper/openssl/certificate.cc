@@ -21,6 +21,8 @@
 
 #include "casper/openssl/certificate.h"
 
+#include "casper/openssl/certificate_cache.h"
+
 #include "cc/exception.h"
 
 #include "cc/macros.h"
@@ -40,6 +42,8 @@
     throw cc::Exception(std::string(__tmp_msg__) + " - " + std::string(__tmp_error__)); \
 }
 
+std::atomic<casper::openssl::CertificateCache*> casper::openssl::Certificate::cache_(nullptr);
+
 /**
  * @brief Default constructor.
  *
@@ -92,7 +96,7 @@ casper::openssl::Certificate::~Certificate ()
 // MARK: -
 
 /**
- * @brief Load a \link Certificate \link.
+ * @brief Load a \link Certificate \link, from cache when enabled - see \link SetCache \link.
  *
  * @param a_certificate Certificate to load.
  *
@@ -104,6 +108,12 @@ size_t casper::openssl::Certificate::Load (const Certificate& a_certificate, X50
 {    
     // ... first release previously loaded X509 certificat ...
     Unload(o_x509);
+    // ... already parsed?
+    CertificateCache* cache = cache_.load();
+    size_t            size  = 0;
+    if ( nullptr != cache && true == cache->Get(a_certificate, o_x509, size) ) {
+        return size;
+    }
     // ... now, according to origin, load a X509 certificate ...
     if ( openssl::Certificate::Origin::Memory == a_certificate.origin_ ) {
         //
@@ -143,8 +153,13 @@ size_t casper::openssl::Certificate::Load (const Certificate& a_certificate, X50
     if ( nullptr == (*o_x509) ) {
         throw cc::Exception("%s", "Unable to load certificate - nullptr!");
     }
+    // ... keep it ...
+    size = static_cast<size_t>(i2d_X509(*(o_x509), NULL));
+    if ( nullptr != cache ) {
+        cache->Put(a_certificate, *(o_x509), size);
+    }
     // ... return it's size ...
-    return i2d_X509(*(o_x509), NULL);
+    return size;
 }
 
 /**
@@ -195,3 +210,13 @@ void casper::openssl::Certificate::Unload (std::vector<X509*>& o_chain)
     }
     o_chain.clear();
 }
+
+/**
+ * @brief Enable or disable parsed certificates cache, process wide.
+ *
+ * @param a_cache Cache to use, not owned - must outlive all \link Load \link calls, nullptr to disable.
+ */
+void casper::openssl::Certificate::SetCache (CertificateCache* a_cache)
+{
+    cache_.store(a_cache);
+}
@@ -28,6 +28,7 @@
 #include <inttypes.h> // uint8_t
 #include <vector>
 #include <string>
+#include <atomic>
 
 #include <openssl/x509.h>
 
@@ -37,6 +38,8 @@ namespace casper
     namespace openssl
     {
     
+        class CertificateCache;
+    
         class Certificate final : public ::cc::NonMovable
         {
             
@@ -69,6 +72,10 @@ namespace casper
         private: // Data
                         
             std::string data_;   //!< File URI or Data, based on provided origin.
+            
+        private: // Static Data
+            
+            static std::atomic<CertificateCache*> cache_; //!< Parsed certificates cache, not owned, nullptr if disabled.
 
         public: // Constructor(s) / Destructor
             
@@ -87,6 +94,8 @@ namespace casper
             static size_t Load   (const Certificate::Chain& a_chain, std::vector<X509*>& o_chain);
             static void   Unload (std::vector<X509*>& o_chain);
             
+            static void   SetCache (CertificateCache* a_cache);
+            
         public: // Operator(s) Overload
             
             inline Certificate& operator = (const Certificate& a_certificate) = delete;
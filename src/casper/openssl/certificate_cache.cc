@@ -0,0 +1,195 @@
+/**
+ * @file certificate_cache.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/certificate_cache.h"
+
+#include "cc/exception.h"
+
+#include <openssl/evp.h>
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_capacity  Maximum number of entries to keep.
+ * @param a_max_bytes Maximum sum of DER encoded certificates size, in bytes.
+ */
+casper::openssl::CertificateCache::CertificateCache (const size_t a_capacity, const size_t a_max_bytes)
+ : max_bytes_(a_max_bytes), bytes_(0),
+   entries_(a_capacity, [this] (Entry& a_entry) {
+       bytes_ -= a_entry.der_size_;
+       X509_free(a_entry.x509_);
+   })
+{
+    if ( 0 == a_capacity || 0 == max_bytes_ ) {
+        throw ::cc::Exception("%s", "Invalid certificate cache limits!");
+    }
+    stats_ = { 0, 0, 0 };
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::openssl::CertificateCache::~CertificateCache ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Lookup a parsed certificate.
+ *
+ * @param a_certificate Certificate to lookup.
+ * @param o_x509        Parsed certificate, a new reference that must be released by caller.
+ * @param o_size        DER encoded certificate size, in bytes.
+ *
+ * @return True when found, false otherwise.
+ */
+bool casper::openssl::CertificateCache::Get (const Certificate& a_certificate, X509** o_x509, size_t& o_size)
+{
+    std::string key;
+    int64_t     mtime_ns;
+    size_t      size;
+    if ( false == Key(a_certificate, key, mtime_ns, size) ) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    const Certificate::Origin origin = a_certificate.origin();
+    
+    const auto it = entries_.Find([origin, &key] (const Entry& a_entry) {
+        return origin == a_entry.origin_ && key == a_entry.key_;
+    });
+    if ( entries_.end() != it ) {
+        // ... file changed?
+        if ( mtime_ns != it->mtime_ns_ || size != it->size_ ) {
+            entries_.Erase(it);
+        } else if ( 1 == X509_up_ref(it->x509_) ) { // ... hand out a new reference ...
+            (*o_x509) = it->x509_;
+            o_size    = it->der_size_;
+            // ... most recently used goes last ...
+            entries_.Touch(it);
+            stats_.hits_++;
+            return true;
+        }
+    }
+    
+    stats_.misses_++;
+    
+    return false;
+}
+
+/**
+ * @brief Keep a parsed certificate.
+ *
+ * @param a_certificate Certificate that was parsed.
+ * @param a_x509        Parsed certificate, a new reference is kept - caller's one is not affected.
+ * @param a_size        DER encoded certificate size, in bytes.
+ */
+void casper::openssl::CertificateCache::Put (const Certificate& a_certificate, X509* a_x509, const size_t a_size)
+{
+    std::string key;
+    int64_t     mtime_ns;
+    size_t      size;
+    if ( nullptr == a_x509 || a_size > max_bytes_ || false == Key(a_certificate, key, mtime_ns, size) ) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    const Certificate::Origin origin = a_certificate.origin();
+    
+    // ... replace previous entry for the same certificate ...
+    const auto it = entries_.Find([origin, &key] (const Entry& a_entry) {
+        return origin == a_entry.origin_ && key == a_entry.key_;
+    });
+    if ( entries_.end() != it ) {
+        entries_.Erase(it);
+    }
+    // ... respect limits ...
+    while ( entries_.size() > 0 && bytes_ + a_size > max_bytes_ ) {
+        entries_.Evict();
+        stats_.evictions_++;
+    }
+    if ( 1 != X509_up_ref(a_x509) ) {
+        return;
+    }
+    stats_.evictions_ += entries_.Push({ origin, key, mtime_ns, size, a_x509, a_size });
+    bytes_ += a_size;
+}
+
+/**
+ * @brief Release all entries, certificates handed out remain valid.
+ */
+void casper::openssl::CertificateCache::Clear ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.Clear();
+}
+
+/**
+ * @return A copy of current statistics.
+ */
+casper::openssl::CertificateCache::Stats casper::openssl::CertificateCache::stats ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @brief Calculate a certificate cache key.
+ *
+ * @param a_certificate Certificate.
+ * @param o_key         File URI or PEM SHA256 digest.
+ * @param o_mtime_ns    File modification time, in nanoseconds, 0 for memory origin.
+ * @param o_size        File or PEM size, in bytes.
+ *
+ * @return True on success, false otherwise ( not cacheable ).
+ */
+bool casper::openssl::CertificateCache::Key (const Certificate& a_certificate, std::string& o_key, int64_t& o_mtime_ns, size_t& o_size)
+{
+    if ( Certificate::Origin::Memory == a_certificate.origin() ) {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int  length = 0;
+        if ( 1 != EVP_Digest(a_certificate.data().c_str(), a_certificate.data().length(), md, &length, EVP_sha256(), nullptr) ) {
+            return false;
+        }
+        o_key      = std::string(reinterpret_cast<const char*>(md), static_cast<size_t>(length));
+        o_mtime_ns = 0;
+        o_size     = a_certificate.data().length();
+        return true;
+    } else if ( Certificate::Origin::File == a_certificate.origin() ) {
+        io::File::Identity file;
+        if ( false == io::File::Identify(a_certificate.data(), file) ) {
+            return false;
+        }
+        o_key      = a_certificate.data();
+        o_size     = file.size_;
+        o_mtime_ns = file.mtime_ns_;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file certificate_cache.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_OPENSSL_CERTIFICATE_CACHE_H_
+#define CASPER_OPENSSL_CERTIFICATE_CACHE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+#include <mutex>
+
+#include <openssl/x509.h>
+
+#include "casper/io/file.h"
+
+#include "casper/cache/lru.h"
+
+#include "casper/openssl/certificate.h"
+
+namespace casper
+{
+
+    namespace openssl
+    {
+    
+        /**
+         * @brief Parsed X509 certificates cache.
+         *
+         *        Entries are keyed by PEM SHA256 digest ( memory origin ) or by file URI, modification time and size
+         *        ( file origin ); X509 objects are reference counted, so the ones handed out remain valid after eviction
+         *        and must be released as usual, with \link Certificate::Unload \link.
+         */
+        class CertificateCache final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            typedef struct {
+                size_t hits_;      //!< Number of successful lookups.
+                size_t misses_;    //!< Number of failed lookups.
+                size_t evictions_; //!< Number of entries evicted to respect limits.
+            } Stats;
+            
+        private: // Data Type(s)
+            
+            typedef struct {
+                Certificate::Origin origin_;
+                std::string         key_;      //!< File URI or PEM SHA256 digest.
+                int64_t             mtime_ns_; //!< File modification time, in nanoseconds, 0 for memory origin.
+                size_t              size_;     //!< File or PEM size, in bytes.
+                X509*               x509_;     //!< Parsed certificate, one reference owned.
+                size_t              der_size_; //!< DER encoded certificate size, in bytes.
+            } Entry;
+            
+        private: // Const Data
+            
+            const size_t        max_bytes_; //!< Maximum sum of DER encoded certificates size, in bytes.
+            
+        private: // Data
+            
+            std::mutex          mutex_;
+            size_t              bytes_;
+            cache::LRU<Entry>   entries_;
+            Stats               stats_;
+            
+        public: // Constructor(s) / Destructor
+            
+            CertificateCache () = delete;
+            CertificateCache (const size_t a_capacity, const size_t a_max_bytes);
+            
+            virtual ~CertificateCache ();
+            
+        public: // Method(s) / Function(s)
+            
+            bool  Get   (const Certificate& a_certificate, X509** o_x509, size_t& o_size);
+            void  Put   (const Certificate& a_certificate, X509* a_x509, const size_t a_size);
+            void  Clear ();
+            Stats stats ();
+            
+        public: // Static Method(s) / Function(s)
+            
+            static bool Key (const Certificate& a_certificate, std::string& o_key, int64_t& o_mtime_ns, size_t& o_size);
+            
+        }; // end of class 'CertificateCache'
+    
+    } // end of namespace 'openssl'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_OPENSSL_CERTIFICATE_CACHE_H_
@@ -31,10 +31,13 @@
 
 #include "cc/fs/file.h"
 
+#include <mutex>
+#include <algorithm> // std::sort
+
 #include <openssl/pem.h>
 #include <openssl/err.h>
 
-#include "casper/openssl/ts_rsp_sign.h"
+#include "casper/openssl/private_key_store.h"
 
 #define CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(a_format, ...) \
 { \
@@ -70,6 +73,22 @@ const char* const casper::openssl::P7::sk_p7_err_msg_unable_to_load_
 const char* const casper::openssl::P7::sk_p7_exp_msg_unable_to_load_              = "Unable load PKCS7 - %s!";
 const char* const casper::openssl::P7::sk_p7_err_msg_signature_validation_failed_ = "Signature validation failed!";
 
+// ... contentType attribute: SEQUENCE { 1.2.840.113549.1.9.3, SET { 1.2.840.113549.1.7.1 ( data ) } } ...
+const unsigned char casper::openssl::P7::sk_der_content_type_attr_[] = {
+    0x30, 0x18,
+        0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x03,
+        0x31, 0x0B,
+            0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x01
+};
+// ... 1.2.840.113549.1.9.5 ...
+const unsigned char casper::openssl::P7::sk_der_signing_time_oid_[]            = { 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x05 };
+// ... 1.2.840.113549.1.9.4 ...
+const unsigned char casper::openssl::P7::sk_der_message_digest_oid_[]          = { 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x04 };
+// ... 1.2.840.113549.1.9.16.2.47 ...
+const unsigned char casper::openssl::P7::sk_der_signing_certificate_v2_oid_[]  = { 0x06, 0x0B, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x10, 0x02, 0x2F };
+
+std::atomic<casper::openssl::P7TemplateCache*> casper::openssl::P7::template_cache_(nullptr);
+
 // MARK: -
 
 /**
@@ -115,7 +134,6 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
     EVP_PKEY*          key = nullptr;
     RSA*               rsa = nullptr;
     
-    ASN1_UTCTIME*      st = nullptr;
     PKCS7_SIGNER_INFO* si = nullptr;
     cc::Exception*     ex = nullptr;
     
@@ -132,26 +150,31 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
         // ... load and add other certificates in chain ...
         (void)Certificate::Load(a_chain, x509_chain);
         
-        // ... load private key ...
-        key = EVP_PKEY_new();
-        kfp = fopen(a_key.uri_.c_str(), "r");
-        if ( nullptr == kfp ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_close_file_with_, a_key.uri_.c_str(), strerror(errno));
-        }
-        if ( 0 != a_key.password_.length() ) {
-            if ( nullptr == PEM_read_RSAPrivateKey(kfp, &rsa, &casper::openssl::PrivateKey::PEMPasswordCallback, (void*)a_key.password_.c_str()) ) {
-                CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_private_key_);
-            }
+        // ... load private key, already decrypted if store is enabled ...
+        PrivateKeyStore* store = PrivateKey::store();
+        if ( nullptr != store ) {
+            key = store->Get(a_key);
         } else {
-            if ( ! PEM_read_RSAPrivateKey(kfp, &rsa, NULL, NULL) ) {
-                CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_private_key_);
+            key = EVP_PKEY_new();
+            kfp = fopen(a_key.uri_.c_str(), "r");
+            if ( nullptr == kfp ) {
+                CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_close_file_with_, a_key.uri_.c_str(), strerror(errno));
             }
+            if ( 0 != a_key.password_.length() ) {
+                if ( nullptr == PEM_read_RSAPrivateKey(kfp, &rsa, &casper::openssl::PrivateKey::PEMPasswordCallback, (void*)a_key.password_.c_str()) ) {
+                    CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_private_key_);
+                }
+            } else {
+                if ( ! PEM_read_RSAPrivateKey(kfp, &rsa, NULL, NULL) ) {
+                    CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_private_key_);
+                }
+            }
+            if ( 0 != fclose(kfp) ) {
+                CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_close_file_with_, a_key.uri_.c_str(), strerror(errno));
+            }
+            kfp = nullptr;
+            EVP_PKEY_set1_RSA(key, rsa);
         }
-        if ( 0 != fclose(kfp) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_close_file_with_, a_key.uri_.c_str(), strerror(errno));
-        }
-        kfp = nullptr;
-        EVP_PKEY_set1_RSA(key, rsa);
 
         // ... create and prepare a PKCS7 ...
         p7 = PKCS7_new();
@@ -177,12 +200,7 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
         
         // ... add signing time ...
         if ( 0 != a_signing_time.length() ) {
-            st = ASN1_UTCTIME_new();
-            ASN1_UTCTIME_set_string(st, a_signing_time.c_str());
-            if ( 1 != PKCS7_add0_attrib_signing_time(si, st) ) {
-                CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "signing time");
-            }
-            st = nullptr; // ... it will be relased once si is released ...
+            AddSigningTime(si, a_signing_time);
         }
                 
         // ... decode and add digest bytes ...
@@ -288,7 +306,7 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
 /**
  * @brief Get current time as the signing time.
  *
- * @param o_value Signing time YYMMDDHHMMSSZ - X509.
+ * @param o_value Signing time YYMMDDHHMMSSZ ( UTCTime ), or YYYYMMDDHHMMSSZ ( GeneralizedTime ) after 2049 - X509.
  */
 void casper::openssl::P7::GetSigningTime (std::string& o_value)
 {
@@ -303,91 +321,68 @@ void casper::openssl::P7::GetSigningTime (std::string& o_value)
 /**
  * @brief Calculate attributes on \link PKCS7_SIGNER_INFO \link that will be signed.
  *
- * @param a_digest      Previously calculate digest.
- * @param a_certificate Signing certificate.
+ *        The structure is fixed, so the DER SET OF attributes is encoded here instead of through OpenSSL ASN.1 items.
+ *
+ * @param a_digest       Previously calculate digest.
+ * @param a_certificate  Signing certificate, optional.
+ * @param o_signing_time Signing time to use, if empty it's set to current time.
+ * @param o_auth_attr    DER encoded signed attributes, base 64.
  */
 void casper::openssl::P7::CalculateSigningAttributes (const std::string& a_digest, const Certificate* a_certificate,
                                                       std::string& o_signing_time, std::string& o_auth_attr)
 {
-    
-    X509*              x509 = nullptr;
-    
-    PKCS7_SIGNER_INFO* si = nullptr;
-    ASN1_UTCTIME*      st = nullptr;
-
-    unsigned char*     dh = nullptr;
-    unsigned char *    ab = nullptr;
-
-    cc::Exception*     ex = nullptr;
+    X509*          x509 = nullptr;
+    unsigned char* dh   = nullptr;
+    cc::Exception* ex   = nullptr;
 
     try {
 
-        //
-        // ... load certificate ...
-        //
-        if ( nullptr != a_certificate ) {
-            (void)Certificate::Load(*a_certificate, &x509);
-        }
-
-        //
-        // ... create and prepare a SIGNER_INFO ...
-        //
-        si = PKCS7_SIGNER_INFO_new();
-        if ( nullptr == si ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_create_new_object_, "SIGNER_INFO", "nullptr");
-        }
+        std::vector<std::string> attributes;
+        attributes.reserve(4);
         
-        if ( 1 != ASN1_INTEGER_set(si->version, 1) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_set_si_field_, "version");
-        }
+        // ... content type ...
+        attributes.push_back(std::string(reinterpret_cast<const char*>(sk_der_content_type_attr_), sizeof(sk_der_content_type_attr_)));
         
-        if ( nullptr != x509 ) {
-            if ( 1 != X509_NAME_set(&si->issuer_and_serial->issuer, X509_get_issuer_name(x509)) ) {
-                CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_set_si_field_, "issuer");
-            }
-            
-            ASN1_INTEGER_free(si->issuer_and_serial->serial);
-            si->issuer_and_serial->serial = ASN1_INTEGER_dup(X509_get_serialNumber(x509));
+        // ... signing time, an invalid one is encoded as an empty UTCTime ...
+        if ( 0 == o_signing_time.length() ) {
+            GetSigningTime(o_signing_time);
         }
-         
-        // ... set digest algorithm ...
-        if ( 1 != X509_ALGOR_set0(si->digest_alg, OBJ_nid2obj(EVP_MD_type(EVP_sha256())), V_ASN1_NULL, NULL) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_set_si_field_, "digest alg");
-        }
-
-        // ... add content type ...
-        if ( 1 != PKCS7_add_attrib_content_type(si, OBJ_nid2obj(NID_pkcs7_data)) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "content type");
+        uint8_t tag = SigningTimeTag(o_signing_time);
+        if ( 0 == tag ) {
+            o_signing_time.clear();
+            tag = V_ASN1_UTCTIME;
         }
+        std::string value;
+        DER(tag, o_signing_time, value);
+        attributes.push_back(std::string());
+        Attribute(sk_der_signing_time_oid_, sizeof(sk_der_signing_time_oid_), value, attributes.back());
         
-        // ... add signing time ...
-        if ( 0 != o_signing_time.length() ) {
-            st = ASN1_UTCTIME_new();
-            ASN1_UTCTIME_set_string(st, o_signing_time.c_str());
-        } else {
-            st = X509_gmtime_adj(NULL, 0);
-        }
-        if ( 1 != PKCS7_add0_attrib_signing_time(si, st) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "signing time");
-        }
-        o_signing_time = std::string(reinterpret_cast<const char* const>(st->data), st->length);
-        st = nullptr; // ... it will be relased once si is released ...
-
         // ... decode and add document hash bytes ...
         const size_t dsz = DecodeBase64(a_digest, &dh);
-        if ( 1 != PKCS7_add1_attrib_digest(si, (const unsigned char*) dh, static_cast<int>(dsz)) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "digest");
-        }
+        value.clear();
+        DER(V_ASN1_OCTET_STRING, std::string(reinterpret_cast<const char*>(dh), dsz), value);
+        attributes.push_back(std::string());
+        Attribute(sk_der_message_digest_oid_, sizeof(sk_der_message_digest_oid_), value, attributes.back());
         
         // ... add signing certificate ....
-        if ( nullptr != x509 ) {
-            AddSigningCertificate(si, x509);
+        if ( nullptr != a_certificate ) {
+            (void)Certificate::Load(*a_certificate, &x509);
+            SigningCertificateV2(x509, value);
+            attributes.push_back(std::string());
+            Attribute(sk_der_signing_certificate_v2_oid_, sizeof(sk_der_signing_certificate_v2_oid_), value, attributes.back());
+        }
+        
+        // ... DER SET OF: elements sorted by their encodings ...
+        std::sort(attributes.begin(), attributes.end());
+        value.clear();
+        for ( const auto& attribute : attributes ) {
+            value += attribute;
         }
+        std::string auth_attr;
+        DER(V_ASN1_CONSTRUCTED | V_ASN1_SET, value, auth_attr);
         
-        // ... get auth_attr value ...
-        const int auth_attr_len = ASN1_item_i2d((ASN1_VALUE *)si->auth_attr, &ab, ASN1_ITEM_rptr(PKCS7_ATTR_SIGN));
         // ... convert it to base 64 ...
-        o_auth_attr = cc::base64_rfc4648::encode((unsigned char*)ab, auth_attr_len);
+        o_auth_attr = cc::base64_rfc4648::encode(reinterpret_cast<const unsigned char*>(auth_attr.c_str()), auth_attr.length());
 
     } catch (const cc::Exception& a_cc_exception) {
         ex = new cc::Exception(a_cc_exception);
@@ -397,33 +392,22 @@ void casper::openssl::P7::CalculateSigningAttributes (const std::string& a_diges
         (void)Certificate::Unload(&x509);
     }
     
-    if ( nullptr != si ) {
-        PKCS7_SIGNER_INFO_free(si);
-    }
-    
-    if ( nullptr != st ) {
-        ASN1_UTCTIME_free(st);
-    }
-    
     if ( nullptr != dh ) {
         delete [] dh;
     }
     
-    if ( nullptr != ab ) {
-        OPENSSL_free(ab);
-    }
-    
     if ( ex != nullptr ) {
         const cc::Exception e = cc::Exception(*ex);
         delete  ex;
         throw e;
     }
-
 }
 
 /**
  * @brief Produce a signed PCKS7 using an externally signed hash.
  *
+ *        When enabled ( see \link SetTemplateCache \link ), PKCS7 is produced by patching a previously encoded one.
+ *
  * @param a_certificate   Signing certificate.
  * @param a_chain         Other certificates in chain.
  * @param a_digest        Digest.
@@ -442,12 +426,19 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
     PKCS7_SIGNER_INFO* si   = nullptr;
     bool               f_si = true;
     cc::Exception*     ex   = nullptr;
-    ASN1_UTCTIME*      st   = nullptr;
     
     unsigned char*     dh  = nullptr;
     unsigned char*     sh  = nullptr;
     
     BIO*               bo  = nullptr;
+    
+    // ... reuse a template?
+    P7TemplateCache*   templates    = template_cache_.load();
+    std::string        template_key;
+    if ( nullptr != templates
+        && true == SignWithTemplate(*templates, a_certificate, a_chain, a_digest, a_enc_digest, a_signing_time, a_callback, template_key) ) {
+        return;
+    }
 
     try {
 
@@ -530,12 +521,7 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
 
         // ... add signing time ...
         if ( 0 != a_signing_time.length() ) {
-            st = ASN1_UTCTIME_new();
-            ASN1_UTCTIME_set_string(st, a_signing_time.c_str());
-            if ( 1 != PKCS7_add0_attrib_signing_time(si, st) ) {
-                CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "signing time");
-            }
-            st = nullptr; // ... it will be relased once si is released ...
+            AddSigningTime(si, a_signing_time);
         }
         
         // ... decode and add digest bytes ...
@@ -571,6 +557,11 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
         const size_t   size   = BIO_get_mem_data(bo, &bytes);
         
         a_callback(bytes, size);
+        
+        // ... keep it as a template for the next ones ...
+        if ( nullptr != templates && 0 != template_key.length() ) {
+            KeepTemplate(*templates, template_key, bytes, size, dh, dsz, a_signing_time, sh, esz);
+        }
 
     } catch (const cc::Exception& a_cc_exception) {
         ex = new cc::Exception(a_cc_exception);
@@ -584,10 +575,6 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
         PKCS7_SIGNER_INFO_free(si);
     }
     
-    if ( nullptr != st ) {
-        ASN1_UTCTIME_free(st);
-    }
-
     Certificate::Unload(&x509);
     Certificate::Unload(x509_chain);
     
@@ -612,7 +599,7 @@ void casper::openssl::P7::Sign (const Certificate& a_certificate, const Certific
     }
 }
 
-// MARK: - [PUBLIC] - Export a PKCS7 to a file in PEM format
+// MARK: - [PUBLIC] - Export a PKCS7 in PEM format
 
 /**
  * @brief Export a PKCS7 to a file in PEM format.
@@ -644,39 +631,108 @@ void casper::openssl::P7::Export (const PKCS7* a_pkcs7, const std::string& a_uri
  */
 void casper::openssl::P7::Export (const unsigned char* a_pkcs7, const size_t a_length, const std::string& a_uri)
 {
-    PKCS7*         p7 = nullptr;
-    BIO*           bi = nullptr;
-    cc::Exception* ex = nullptr;
-    
+    Export([a_pkcs7, a_length] (const std::function<void(const unsigned char*, const size_t&)>& a_callback) {
+        a_callback(a_pkcs7, a_length);
+    }, a_uri);
+}
+
+/**
+ * @brief Export a PKCS7 to a file in PEM format.
+ *
+ * @param a_producer Function that will deliver, in order and by chunks, the DER bytes to export.
+ * @param a_uri      Local file URI - will be overwritten.
+ */
+void casper::openssl::P7::Export (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer,
+                                  const std::string& a_uri)
+{
+    PKCS7* p7 = Load(a_producer);
     try {
-        
-        bi = BIO_new(BIO_s_mem());
-        auto bw = BIO_write(bi, a_pkcs7, static_cast<int>(a_length));
-        if ( bw != a_length ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_exp_msg_unable_to_load_, "unable to write all bytes to BIO!");
-        }
-        if ( nullptr == ( p7 = d2i_PKCS7_bio(bi, NULL) ) ) {
-            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_);
-        }
         Export(p7, a_uri);
+    } catch (...) {
+        PKCS7_free(p7);
+        throw;
+    }
+    PKCS7_free(p7);
+}
 
-    } catch (const cc::Exception& a_cc_exception) {
-        ex = new cc::Exception(a_cc_exception);
+/**
+ * @brief Export a PKCS7 to a buffer in PEM format.
+ *
+ * @param a_pkcs7 Object to export.
+ * @param o_pem   PEM data.
+ */
+void casper::openssl::P7::Export (const PKCS7* a_pkcs7, std::vector<unsigned char>& o_pem)
+{
+    BIO* bo = BIO_new(BIO_s_mem());
+    if ( nullptr == bo || 1 != PEM_write_bio_PKCS7(bo, const_cast<PKCS7*>(a_pkcs7)) ) {
+        if ( nullptr != bo ) {
+            BIO_free(bo);
+        }
+        CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_export_to_pem_);
     }
-    
-    if ( p7 != nullptr ) {
+    BUF_MEM* mem = nullptr;
+    BIO_get_mem_ptr(bo, &mem);
+    o_pem.assign(reinterpret_cast<const unsigned char*>(mem->data), reinterpret_cast<const unsigned char*>(mem->data) + mem->length);
+    BIO_free(bo);
+}
+
+/**
+ * @brief Export a PKCS7 to a buffer in PEM format.
+ *
+ * @param a_producer Function that will deliver, in order and by chunks, the DER bytes to export.
+ * @param o_pem      PEM data.
+ */
+void casper::openssl::P7::Export (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer,
+                                  std::vector<unsigned char>& o_pem)
+{
+    PKCS7* p7 = Load(a_producer);
+    try {
+        Export(p7, o_pem);
+    } catch (...) {
         PKCS7_free(p7);
+        throw;
     }
-    
-    if ( nullptr != bi ) {
-        BIO_free(bi);
+    PKCS7_free(p7);
+}
+
+/**
+ * @brief Calculate the total length of a DER encoded object from it's header ( identifier and length octets ).
+ *
+ * @param a_bytes First bytes of the DER encoded object.
+ * @param a_size  Number of available bytes.
+ *
+ * @return Total number of bytes ( header included ), 0 if not enough bytes or an indefinite / unsupported length was found.
+ */
+size_t casper::openssl::P7::DERLength (const unsigned char* a_bytes, const size_t a_size)
+{
+    // ... identifier ( low tag numbers only ) and first length octet ...
+    if ( a_size < 2 || 0x1F == ( a_bytes[0] & 0x1F ) ) {
+        return 0;
     }
-    
-    if ( ex != nullptr ) {
-        const cc::Exception e = cc::Exception(*ex);
-        delete  ex;
-        throw e;
+    // ... short form ...
+    if ( 0 == ( a_bytes[1] & 0x80 ) ) {
+        return 2 + static_cast<size_t>(a_bytes[1]);
+    }
+    // ... long form ( 0x80 is indefinite length, not allowed in DER ) ...
+    const size_t count = static_cast<size_t>(a_bytes[1] & 0x7F);
+    if ( 0 == count || count > sizeof(uint32_t) || a_size < 2 + count ) {
+        return 0;
     }
+    size_t length = 0;
+    for ( size_t idx = 0 ; idx < count ; ++idx ) {
+        length = ( length << 8 ) | static_cast<size_t>(a_bytes[2 + idx]);
+    }
+    return 2 + count + length;
+}
+
+/**
+ * @brief Enable or disable externally signed PKCS7 templates, process wide.
+ *
+ * @param a_cache Cache to use, not owned - must outlive all \link Sign \link calls, nullptr to disable.
+ */
+void casper::openssl::P7::SetTemplateCache (P7TemplateCache* a_cache)
+{
+    template_cache_.store(a_cache);
 }
 
 // MARK: - [PRIVATE] - Base 64 helpers.
@@ -719,23 +775,402 @@ size_t casper::openssl::P7::DecodeBase64 (const std::string& a_value, unsigned c
     return sz;
 }
 
-// MARK: -
+// MARK: - [PRIVATE] - Load a PKCS7
+
+/**
+ * @brief Load a DER encoded PKCS7.
+ *
+ * @param a_producer Function that will deliver, in order and by chunks, the DER bytes to load.
+ *
+ * @return New PKCS7 object, caller must free it with PKCS7_free.
+ */
+PKCS7* casper::openssl::P7::Load (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer)
+{
+    PKCS7*         p7 = nullptr;
+    BIO*           bi = nullptr;
+    cc::Exception* ex = nullptr;
+    
+    try {
+        
+        bi = BIO_new(BIO_s_mem());
+        a_producer([bi] (const unsigned char* a_bytes, const size_t& a_size) {
+            const auto bw = BIO_write(bi, a_bytes, static_cast<int>(a_size));
+            if ( bw < 0 || static_cast<size_t>(bw) != a_size ) {
+                CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_exp_msg_unable_to_load_, "unable to write all bytes to BIO!");
+            }
+        });
+        if ( nullptr == ( p7 = d2i_PKCS7_bio(bi, NULL) ) ) {
+            CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR("%s", sk_p7_err_msg_unable_to_load_);
+        }
+
+    } catch (const cc::Exception& a_cc_exception) {
+        ex = new cc::Exception(a_cc_exception);
+    }
+    
+    if ( nullptr != bi ) {
+        BIO_free(bi);
+    }
+    
+    if ( ex != nullptr ) {
+        const cc::Exception e = cc::Exception(*ex);
+        delete  ex;
+        throw e;
+    }
+    
+    return p7;
+}
+
+// MARK: - [PRIVATE] - PKCS7 templates
+
+/**
+ * @brief Produce an externally signed PKCS7 by patching a template.
+ *
+ * @param a_cache        Templates cache.
+ * @param a_certificate  Signing certificate.
+ * @param a_chain        Other certificates in chain.
+ * @param a_digest       Digest.
+ * @param a_enc_digest   Encripted digest.
+ * @param a_signing_time Signing time.
+ * @param a_callback     Function to call to deliver PCKS7 bytes.
+ * @param o_key          Template key, empty if not cacheable.
+ *
+ * @return True if PKCS7 was delivered, false if a template is not available or signing time is not valid.
+ */
+bool casper::openssl::P7::SignWithTemplate (P7TemplateCache& a_cache, const Certificate& a_certificate, const Certificate::Chain& a_chain,
+                                            const std::string& a_digest, const std::string& a_enc_digest, const std::string& a_signing_time,
+                                            const std::function<void(const unsigned char*, const size_t&)>& a_callback,
+                                            std::string& o_key)
+{
+    unsigned char*  dh = nullptr;
+    unsigned char*  sh = nullptr;
+    cc::Exception*  ex = nullptr;
+    bool            rv = false;
+    
+    o_key.clear();
+    
+    // ... patching an invalid signing time would deliver a PKCS7 the regular path never produces, let it handle it ...
+    if ( 0 != a_signing_time.length() && 0 == SigningTimeTag(a_signing_time) ) {
+        return false;
+    }
+    
+    try {
+        
+        const size_t dsz = DecodeBase64(a_digest, &dh);
+        const size_t esz = DecodeBase64(a_enc_digest, &sh);
+        
+        P7TemplateCache::Template t;
+        if ( true == P7TemplateCache::Key(a_certificate, a_chain, dsz, a_signing_time.length(), esz, o_key) ) {
+            if ( true == a_cache.Get(o_key, t) ) {
+                // ... patch values, sizes were part of the key ...
+                char* der = &t.der_[0];
+                memcpy(der + t.digest_.offset_, dh, dsz);
+                if ( 0 != t.signing_time_.size_ ) {
+                    memcpy(der + t.signing_time_.offset_, a_signing_time.c_str(), t.signing_time_.size_);
+                }
+                memcpy(der + t.enc_digest_.offset_, sh, esz);
+                a_callback(reinterpret_cast<const unsigned char*>(t.der_.c_str()), t.der_.length());
+                rv = true;
+            }
+        } else {
+            o_key.clear();
+        }
+        
+    } catch (const cc::Exception& a_cc_exception) {
+        ex = new cc::Exception(a_cc_exception);
+    }
+    
+    if ( nullptr != dh ) {
+        delete [] dh;
+    }
+    
+    if ( nullptr != sh ) {
+        delete [] sh;
+    }
+    
+    if ( ex != nullptr ) {
+        const cc::Exception e = cc::Exception(*ex);
+        delete  ex;
+        throw e;
+    }
+    
+    return rv;
+}
+
+/**
+ * @brief Locate values slots in an encoded PKCS7 and keep it as a template.
+ *
+ * @param a_cache           Templates cache.
+ * @param a_key             Template key.
+ * @param a_der             Encoded PKCS7.
+ * @param a_size            Encoded PKCS7 size, in bytes.
+ * @param a_digest          Digest bytes.
+ * @param a_digest_size     Digest size, in bytes.
+ * @param a_signing_time    Signing time, empty if not present.
+ * @param a_enc_digest      Encrypted digest bytes.
+ * @param a_enc_digest_size Encrypted digest size, in bytes.
+ */
+void casper::openssl::P7::KeepTemplate (P7TemplateCache& a_cache, const std::string& a_key, const unsigned char* a_der, const size_t a_size,
+                                        const unsigned char* a_digest, const size_t a_digest_size, const std::string& a_signing_time,
+                                        const unsigned char* a_enc_digest, const size_t a_enc_digest_size)
+{
+    P7TemplateCache::Template t;
+    t.der_          = std::string(reinterpret_cast<const char*>(a_der), a_size);
+    t.signing_time_ = { 0, 0 };
+    
+    // ... signed attributes values must be found once, otherwise it's not safe to patch them ...
+    if ( false == FindSlot(t.der_, NID_pkcs9_messageDigest, V_ASN1_OCTET_STRING,
+                           std::string(reinterpret_cast<const char*>(a_digest), a_digest_size), t.digest_) ) {
+        return;
+    }
+    if ( 0 != a_signing_time.length() ) {
+        const uint8_t tag = SigningTimeTag(a_signing_time);
+        if ( 0 == tag || false == FindSlot(t.der_, NID_pkcs9_signingTime, tag, a_signing_time, t.signing_time_) ) {
+            return;
+        }
+    }
+    
+    // ... without unsigned attributes, encrypted digest is the last value of the last signer info ...
+    std::string enc_digest;
+    DER(V_ASN1_OCTET_STRING, std::string(reinterpret_cast<const char*>(a_enc_digest), a_enc_digest_size), enc_digest);
+    if ( a_size < enc_digest.length() || 0 != t.der_.compare(a_size - enc_digest.length(), enc_digest.length(), enc_digest) ) {
+        return;
+    }
+    t.enc_digest_ = { a_size - a_enc_digest_size, a_enc_digest_size };
+    
+    a_cache.Put(a_key, t);
+}
+
+/**
+ * @brief Locate a single valued signed attribute value.
+ *
+ * @param a_der   Encoded PKCS7.
+ * @param a_nid   Attribute type NID.
+ * @param a_tag   Attribute value tag.
+ * @param a_value Attribute value.
+ * @param o_slot  Value slot.
+ *
+ * @return True if value was found exactly once, false otherwise.
+ */
+bool casper::openssl::P7::FindSlot (const std::string& a_der, const int a_nid, const uint8_t a_tag, const std::string& a_value,
+                                    P7TemplateCache::Slot& o_slot)
+{
+    // ... type OID ...
+    unsigned char* oid = nullptr;
+    const int      len = i2d_ASN1_OBJECT(OBJ_nid2obj(a_nid), &oid);
+    if ( len <= 0 ) {
+        return false;
+    }
+    std::string pattern = std::string(reinterpret_cast<const char*>(oid), static_cast<size_t>(len));
+    OPENSSL_free(oid);
+    
+    // ... SET { value } ...
+    std::string value;
+    DER(a_tag, a_value, value);
+    DER(V_ASN1_CONSTRUCTED | V_ASN1_SET, value, pattern);
+    
+    const size_t offset = a_der.find(pattern);
+    if ( std::string::npos == offset || std::string::npos != a_der.find(pattern, offset + 1) ) {
+        return false;
+    }
+    
+    o_slot = { offset + pattern.length() - a_value.length(), a_value.length() };
+    
+    return true;
+}
+
+// MARK: - [PRIVATE] - SIGNER INFO - Signed Attributes
 
 /**
- * @brief Add signing certificate.
+ * @brief Add signing certificate ( ESS signing-certificate-v2 ) attribute.
  *
  * @param a_info        See \link PKCS7_SIGNER_INFO \link.
  * @param a_certificate See \link X509 \link.
  */
 void casper::openssl::P7::AddSigningCertificate (PKCS7_SIGNER_INFO* a_info, X509* a_certificate)
 {
-    ESS_SIGNING_CERT_V2* sc = casper_ess_signing_cert_v2_new_init(EVP_sha256(), a_certificate, NULL);
-    if ( nullptr == sc ) {
+    std::string der;
+    SigningCertificateV2(a_certificate, der);
+    
+    ASN1_STRING* seq = ASN1_STRING_new();
+    if ( nullptr == seq || 1 != ASN1_STRING_set(seq, der.c_str(), static_cast<int>(der.length())) ) {
+        if ( nullptr != seq ) {
+            ASN1_STRING_free(seq);
+        }
         CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_set_si_field_, "signing-certificate");
     }
-
-    if ( 1 != casper_ess_add_signing_cert_v2(a_info, sc) ) {
-        ESS_SIGNING_CERT_V2_free(sc);
+    
+    // ... on success, seq is owned by signer info ...
+    if ( 1 != PKCS7_add_signed_attribute(a_info, NID_id_smime_aa_signingCertificateV2, V_ASN1_SEQUENCE, seq) ) {
+        ASN1_STRING_free(seq);
         CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_set_si_field_, "signing-certificate");
     }
 }
+
+/**
+ * @brief Add signing time attribute.
+ *
+ * @param a_info  See \link PKCS7_SIGNER_INFO \link.
+ * @param a_value Signing time, see \link SigningTimeTag \link - an invalid one is added as an empty UTCTime.
+ */
+void casper::openssl::P7::AddSigningTime (PKCS7_SIGNER_INFO* a_info, const std::string& a_value)
+{
+    const uint8_t valid = SigningTimeTag(a_value);
+    const int     tag   = ( 0 != valid ? valid : V_ASN1_UTCTIME );
+    
+    ASN1_STRING* st = ASN1_STRING_type_new(tag);
+    if ( nullptr == st ) {
+        CASPER_OPENSSL_P7_THROW_OPENSSL_EXCEPTION(sk_p7_err_msg_unable_to_create_new_object_, "ASN1_TIME", "nullptr");
+    }
+    if ( 0 != valid && 1 != ASN1_STRING_set(st, a_value.c_str(), static_cast<int>(a_value.length())) ) {
+        ASN1_STRING_free(st);
+        CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "signing time");
+    }
+    
+    // ... on success, st is owned by signer info ...
+    if ( 1 != PKCS7_add_signed_attribute(a_info, NID_pkcs9_signingTime, tag, st) ) {
+        ASN1_STRING_free(st);
+        CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_add_attribute_, "signing time");
+    }
+}
+
+/**
+ * @brief Obtain the DER encoded ESS SigningCertificateV2 ( RFC 5035 ) of a certificate, SHA256 hash algorithm ( omitted ).
+ *
+ *        It's calculated only once per \link X509 \link object and kept in it's 'ex data', so certificates that are
+ *        reused ( see \link CertificateCache \link ) don't need to be hashed and encoded again.
+ *
+ * @param a_x509 See \link X509 \link.
+ * @param o_der  DER encoded SigningCertificateV2.
+ */
+void casper::openssl::P7::SigningCertificateV2 (X509* a_x509, std::string& o_der)
+{
+    static std::mutex mutex;
+    static const int  index = X509_get_ex_new_index(0, nullptr, nullptr, nullptr,
+                                                    [](void* /* a_parent */, void* a_ptr, CRYPTO_EX_DATA* /* a_ad */, int /* a_idx */, long /* a_argl */, void* /* a_argp */) {
+                                                        delete static_cast<std::string*>(a_ptr);
+                                                    }
+    );
+    
+    // ... already calculated?
+    if ( -1 != index ) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::string* cached = static_cast<const std::string*>(X509_get_ex_data(a_x509, index));
+        if ( nullptr != cached ) {
+            o_der = *cached;
+            return;
+        }
+    }
+    
+    // ... ESSCertIDv2 ::= SEQUENCE { certHash OCTET STRING, issuerSerial IssuerSerial }
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int  hash_len = 0;
+    if ( 1 != X509_digest(a_x509, EVP_sha256(), hash, &hash_len) ) {
+        CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_set_si_field_, "signing-certificate");
+    }
+    
+    // ... IssuerSerial ::= SEQUENCE { issuer GeneralNames ( directoryName [4] EXPLICIT Name ), serialNumber INTEGER }
+    unsigned char* name   = nullptr;
+    unsigned char* serial = nullptr;
+    const int      name_len   = i2d_X509_NAME(X509_get_issuer_name(a_x509), &name);
+    const int      serial_len = i2d_ASN1_INTEGER(X509_get_serialNumber(a_x509), &serial);
+    if ( name_len <= 0 || serial_len <= 0 ) {
+        OPENSSL_free(name);
+        OPENSSL_free(serial);
+        CASPER_OPENSSL_P7_THROW_OPENSSL_ERROR(sk_p7_err_msg_unable_to_set_si_field_, "signing-certificate");
+    }
+    std::string general_name;
+    std::string issuer_serial;
+    DER(0xA4, std::string(reinterpret_cast<const char*>(name), static_cast<size_t>(name_len)), general_name);
+    DER(0x30, general_name, issuer_serial);
+    issuer_serial.append(reinterpret_cast<const char*>(serial), static_cast<size_t>(serial_len));
+    OPENSSL_free(name);
+    OPENSSL_free(serial);
+    
+    std::string cert_id;
+    DER(0x04, std::string(reinterpret_cast<const char*>(hash), static_cast<size_t>(hash_len)), cert_id);
+    DER(0x30, issuer_serial, cert_id);
+    
+    // ... SigningCertificateV2 ::= SEQUENCE { certs SEQUENCE OF ESSCertIDv2 } ...
+    std::string ess_cert_id;
+    std::string certs;
+    DER(0x30, cert_id, ess_cert_id);
+    DER(0x30, ess_cert_id, certs);
+    o_der.clear();
+    DER(0x30, certs, o_der);
+    
+    // ... keep it ...
+    if ( -1 != index ) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ( nullptr == X509_get_ex_data(a_x509, index) ) {
+            std::string* cached = new std::string(o_der);
+            if ( 1 != X509_set_ex_data(a_x509, index, cached) ) {
+                delete cached;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Obtain the tag a signing time must be encoded with ( RFC 5652, section 11.3 ).
+ *
+ * @param a_value YYMMDDHHMMSSZ for 1950 through 2049, YYYYMMDDHHMMSSZ for other years.
+ *
+ * @return V_ASN1_UTCTIME, V_ASN1_GENERALIZEDTIME or 0 if \link a_value \link is not valid.
+ */
+uint8_t casper::openssl::P7::SigningTimeTag (const std::string& a_value)
+{
+    if ( 1 == ASN1_UTCTIME_set_string(nullptr, a_value.c_str()) ) {
+        return V_ASN1_UTCTIME;
+    }
+    // ... DER GeneralizedTime: UTC, no fractional seconds, only for years UTCTime can't represent ...
+    if ( 15 != a_value.length() || 'Z' != a_value[14] || 1 != ASN1_GENERALIZEDTIME_set_string(nullptr, a_value.c_str()) ) {
+        return 0;
+    }
+    const int year = std::stoi(a_value.substr(0, 4));
+    if ( year >= 1950 && year <= 2049 ) {
+        return 0;
+    }
+    return V_ASN1_GENERALIZEDTIME;
+}
+
+/**
+ * @brief Append a DER encoded TLV.
+ *
+ * @param a_tag    Tag.
+ * @param a_value  Encoded value.
+ * @param o_buffer Buffer where TLV will be appended to.
+ */
+void casper::openssl::P7::DER (const uint8_t a_tag, const std::string& a_value, std::string& o_buffer)
+{
+    o_buffer += static_cast<char>(a_tag);
+    const size_t length = a_value.length();
+    if ( length < 0x80 ) {
+        o_buffer += static_cast<char>(length);
+    } else {
+        uint8_t bytes = 0;
+        for ( size_t l = length ; l > 0 ; l >>= 8 ) {
+            ++bytes;
+        }
+        o_buffer += static_cast<char>(0x80 | bytes);
+        for ( uint8_t b = bytes ; b > 0 ; --b ) {
+            o_buffer += static_cast<char>(( length >> ( 8 * ( b - 1 ) ) ) & 0xFF);
+        }
+    }
+    o_buffer += a_value;
+}
+
+/**
+ * @brief Append a DER encoded single valued attribute, SEQUENCE { type, SET { value } }.
+ *
+ * @param a_oid      DER encoded attribute type.
+ * @param a_oid_size DER encoded attribute type size, in bytes.
+ * @param a_value    DER encoded attribute value.
+ * @param o_buffer   Buffer where attribute will be appended to.
+ */
+void casper::openssl::P7::Attribute (const unsigned char* a_oid, const size_t a_oid_size, const std::string& a_value,
+                                     std::string& o_buffer)
+{
+    std::string content = std::string(reinterpret_cast<const char*>(a_oid), a_oid_size);
+    DER(V_ASN1_CONSTRUCTED | V_ASN1_SET, a_value, content);
+    DER(V_ASN1_CONSTRUCTED | V_ASN1_SEQUENCE, content, o_buffer);
+}
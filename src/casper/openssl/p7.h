@@ -27,12 +27,14 @@
 #include <string>
 #include <vector>
 #include <functional> // std::function
+#include <atomic>
 
 #include <openssl/pkcs7.h>
 #include <openssl/x509.h>
 
 #include "casper/openssl/certificate.h"
 #include "casper/openssl/private_key.h"
+#include "casper/openssl/p7_template_cache.h"
 
 namespace casper
 {
@@ -68,6 +70,15 @@ namespace casper
             static const char* const sk_p7_exp_msg_unable_to_load_;
             static const char* const sk_p7_err_msg_signature_validation_failed_;
             
+            static const unsigned char sk_der_content_type_attr_[];
+            static const unsigned char sk_der_signing_time_oid_[];
+            static const unsigned char sk_der_message_digest_oid_[];
+            static const unsigned char sk_der_signing_certificate_v2_oid_[];
+            
+        private: // Static Data
+            
+            static std::atomic<P7TemplateCache*> template_cache_; //!< Externally signed PKCS7 templates, not owned, nullptr if disabled.
+            
         public: // Static Method(s) / Function(s)
             
             static void GetSigningTime             (std::string& o_value);
@@ -87,14 +98,42 @@ namespace casper
             
             static void Export (const PKCS7* a_pkcs7, const std::string& a_uri);
             static void Export (const unsigned char* a_pkcs7, const size_t a_length, const std::string& a_uri);
+            static void Export (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer,
+                                const std::string& a_uri);
+            static void Export (const PKCS7* a_pkcs7, std::vector<unsigned char>& o_pem);
+            static void Export (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer,
+                                std::vector<unsigned char>& o_pem);
+            
+            static size_t DERLength (const unsigned char* a_bytes, const size_t a_size);
+            
+            static void   SetTemplateCache (P7TemplateCache* a_cache);
 
         private: // Static Method(s) / Function(s)
             
             static size_t DecodeBase64 (const std::string& a_value, unsigned char** o_buffer);
+            static PKCS7* Load         (const std::function<void(const std::function<void(const unsigned char*, const size_t&)>&)>& a_producer);
+            
+        private: // Static Method(s) / Function(s)
+            
+            static bool SignWithTemplate (P7TemplateCache& a_cache, const Certificate& a_certificate, const Certificate::Chain& a_chain,
+                                          const std::string& a_digest, const std::string& a_enc_digest, const std::string& a_signing_time,
+                                          const std::function<void(const unsigned char*, const size_t&)>& a_callback,
+                                          std::string& o_key);
+            static void KeepTemplate     (P7TemplateCache& a_cache, const std::string& a_key, const unsigned char* a_der, const size_t a_size,
+                                          const unsigned char* a_digest, const size_t a_digest_size, const std::string& a_signing_time,
+                                          const unsigned char* a_enc_digest, const size_t a_enc_digest_size);
+            static bool FindSlot         (const std::string& a_der, const int a_nid, const uint8_t a_tag, const std::string& a_value,
+                                          P7TemplateCache::Slot& o_slot);
             
         private: // Static Method(s) / Function(s)
             
-            static void AddSigningCertificate (PKCS7_SIGNER_INFO* a_info, X509* a_x509);
+            static void    AddSigningTime        (PKCS7_SIGNER_INFO* a_info, const std::string& a_value);
+            static void    AddSigningCertificate (PKCS7_SIGNER_INFO* a_info, X509* a_x509);
+            static void    SigningCertificateV2  (X509* a_x509, std::string& o_der);
+            static uint8_t SigningTimeTag        (const std::string& a_value);
+            static void    DER                   (const uint8_t a_tag, const std::string& a_value, std::string& o_buffer);
+            static void    Attribute             (const unsigned char* a_oid, const size_t a_oid_size, const std::string& a_value,
+                                                  std::string& o_buffer);
 
         }; // end of class 'P7'
         
@@ -0,0 +1,166 @@
+/**
+ * @file p7_template_cache.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/p7_template_cache.h"
+
+#include "casper/openssl/certificate_cache.h"
+
+#include "cc/exception.h"
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_capacity Maximum number of templates to keep.
+ */
+casper::openssl::P7TemplateCache::P7TemplateCache (const size_t a_capacity)
+ : entries_(a_capacity)
+{
+    if ( 0 == a_capacity ) {
+        throw ::cc::Exception("%s", "Invalid PKCS7 template cache capacity!");
+    }
+    stats_ = { 0, 0, 0 };
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::openssl::P7TemplateCache::~P7TemplateCache ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Lookup a template.
+ *
+ * @param a_key      See \link Key \link.
+ * @param o_template Copy of the template, to be patched by caller.
+ *
+ * @return True when found, false otherwise.
+ */
+bool casper::openssl::P7TemplateCache::Get (const std::string& a_key, Template& o_template)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    const auto it = entries_.Find([&a_key] (const Entry& a_entry) {
+        return a_key == a_entry.key_;
+    });
+    if ( entries_.end() == it ) {
+        stats_.misses_++;
+        return false;
+    }
+    
+    o_template = it->template_;
+    // ... most recently used goes last ...
+    entries_.Touch(it);
+    stats_.hits_++;
+    
+    return true;
+}
+
+/**
+ * @brief Keep a template.
+ *
+ * @param a_key      See \link Key \link.
+ * @param a_template Template to keep, slots must be within DER bounds.
+ */
+void casper::openssl::P7TemplateCache::Put (const std::string& a_key, const Template& a_template)
+{
+    const size_t length = a_template.der_.length();
+    for ( const auto slot : { a_template.digest_, a_template.signing_time_, a_template.enc_digest_ } ) {
+        if ( slot.offset_ > length || slot.size_ > length - slot.offset_ ) {
+            return;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // ... replace previous entry for the same key ...
+    const auto it = entries_.Find([&a_key] (const Entry& a_entry) {
+        return a_key == a_entry.key_;
+    });
+    if ( entries_.end() != it ) {
+        entries_.Erase(it);
+    }
+    // ... respect limits ...
+    stats_.evictions_ += entries_.Push({ a_key, a_template });
+}
+
+/**
+ * @brief Release all entries.
+ */
+void casper::openssl::P7TemplateCache::Clear ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.Clear();
+}
+
+/**
+ * @return A copy of current statistics.
+ */
+casper::openssl::P7TemplateCache::Stats casper::openssl::P7TemplateCache::stats ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @brief Calculate a template cache key.
+ *
+ * @param a_certificate       Signing certificate.
+ * @param a_chain             Other certificates in chain.
+ * @param a_digest_size       Message digest size, in bytes.
+ * @param a_signing_time_size Signing time size, in bytes, 0 if not present.
+ * @param a_enc_digest_size   Encrypted digest size, in bytes.
+ * @param o_key               Key.
+ *
+ * @return True on success, false otherwise ( not cacheable ).
+ */
+bool casper::openssl::P7TemplateCache::Key (const Certificate& a_certificate, const Certificate::Chain& a_chain,
+                                            const size_t a_digest_size, const size_t a_signing_time_size, const size_t a_enc_digest_size,
+                                            std::string& o_key)
+{
+    // ... value sizes change DER lengths, so they are part of the key ...
+    o_key = std::to_string(a_digest_size) + ':' + std::to_string(a_signing_time_size) + ':' + std::to_string(a_enc_digest_size);
+    
+    std::string key;
+    int64_t     mtime_ns;
+    size_t      size;
+    
+    const Certificate* certificate = &a_certificate;
+    for ( size_t idx = 0 ; idx <= a_chain.size() ; ++idx ) {
+        if ( idx > 0 ) {
+            certificate = &a_chain[idx - 1];
+        }
+        if ( false == CertificateCache::Key(*certificate, key, mtime_ns, size) ) {
+            return false;
+        }
+        o_key += '|' + std::to_string(static_cast<int>(certificate->origin())) + ':' + std::to_string(mtime_ns) + ':' + std::to_string(size)
+               + ':' + std::to_string(key.length()) + ':' + key;
+    }
+    
+    return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file p7_template_cache.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_OPENSSL_P7_TEMPLATE_CACHE_H_
+#define CASPER_OPENSSL_P7_TEMPLATE_CACHE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+#include <mutex>
+
+#include "casper/cache/lru.h"
+
+#include "casper/openssl/certificate.h"
+
+namespace casper
+{
+
+    namespace openssl
+    {
+    
+        /**
+         * @brief Externally signed PKCS7 DER templates cache.
+         *
+         *        For the same signing certificate and chain, the DER produced by \link P7::Sign \link only differs in the
+         *        message digest, signing time and encrypted digest values; a template keeps one encoded PKCS7 and the
+         *        offsets of those ( fixed length ) values, so that the next ones are produced by patching a copy of it.
+         *
+         *        Entries are keyed by certificates identity ( see \link CertificateCache::Key \link ) and values length.
+         */
+        class P7TemplateCache final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            typedef struct {
+                size_t offset_; //!< Value offset, in bytes, from DER start.
+                size_t size_;   //!< Value size, in bytes.
+            } Slot;
+            
+            typedef struct {
+                std::string der_;          //!< Encoded PKCS7.
+                Slot        digest_;       //!< Message digest value.
+                Slot        signing_time_; //!< Signing time value, size 0 if not present.
+                Slot        enc_digest_;   //!< Encrypted digest value.
+            } Template;
+            
+            typedef struct {
+                size_t hits_;      //!< Number of templates reused.
+                size_t misses_;    //!< Number of failed lookups.
+                size_t evictions_; //!< Number of entries evicted to respect limits.
+            } Stats;
+            
+        private: // Data Type(s)
+            
+            typedef struct {
+                std::string key_;      //!< See \link Key \link.
+                Template    template_;
+            } Entry;
+            
+        private: // Data
+            
+            std::mutex          mutex_;
+            cache::LRU<Entry>   entries_;
+            Stats               stats_;
+            
+        public: // Constructor(s) / Destructor
+            
+            P7TemplateCache () = delete;
+            P7TemplateCache (const size_t a_capacity);
+            
+            virtual ~P7TemplateCache ();
+            
+        public: // Method(s) / Function(s)
+            
+            bool  Get   (const std::string& a_key, Template& o_template);
+            void  Put   (const std::string& a_key, const Template& a_template);
+            void  Clear ();
+            Stats stats ();
+            
+        public: // Static Method(s) / Function(s)
+            
+            static bool Key (const Certificate& a_certificate, const Certificate::Chain& a_chain,
+                             const size_t a_digest_size, const size_t a_signing_time_size, const size_t a_enc_digest_size,
+                             std::string& o_key);
+            
+        }; // end of class 'P7TemplateCache'
+    
+    } // end of namespace 'openssl'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_OPENSSL_P7_TEMPLATE_CACHE_H_
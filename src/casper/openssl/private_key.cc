@@ -23,6 +23,8 @@
 
 #include <string.h> // strlen
 
+std::atomic<casper::openssl::PrivateKeyStore*> casper::openssl::PrivateKey::store_(nullptr);
+
 /**
  * @brief Defaiult 
  */
@@ -71,3 +73,21 @@ int casper::openssl::PrivateKey::PEMPasswordCallback (char* a_buffer, int a_size
     
     return static_cast<int>(cp_len);
 }
+
+/**
+ * @brief Enable or disable decrypted private keys store, process wide.
+ *
+ * @param a_store Store to use, not owned - must outlive all signing calls, nullptr to disable.
+ */
+void casper::openssl::PrivateKey::SetStore (PrivateKeyStore* a_store)
+{
+    store_.store(a_store);
+}
+
+/**
+ * @return Decrypted private keys store, nullptr if disabled.
+ */
+casper::openssl::PrivateKeyStore* casper::openssl::PrivateKey::store ()
+{
+    return store_.load();
+}
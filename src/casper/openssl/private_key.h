@@ -24,6 +24,7 @@
 #include "cc/non-movable.h"
 
 #include <string>
+#include <atomic>
 
 namespace casper
 {
@@ -31,6 +32,8 @@ namespace casper
     namespace openssl
     {
     
+        class PrivateKeyStore;
+    
         class PrivateKey final : public ::cc::NonMovable
         {
             
@@ -38,6 +41,10 @@ namespace casper
             
             const std::string uri_;
             const std::string password_;
+            
+        private: // Static Data
+            
+            static std::atomic<PrivateKeyStore*> store_; //!< Decrypted keys store, not owned, nullptr if disabled.
 
         public: // Constructor(s) / Destructor
             
@@ -52,7 +59,9 @@ namespace casper
             
         public: // Static Method(s) / Function(s)
             
-            static int PEMPasswordCallback (char* a_buffer, int a_size, int /* a_rw_flag */, void* a_user_data);
+            static int              PEMPasswordCallback (char* a_buffer, int a_size, int /* a_rw_flag */, void* a_user_data);
+            static void             SetStore            (PrivateKeyStore* a_store);
+            static PrivateKeyStore* store               ();
 
         }; // end of class 'PrivateKey'
     
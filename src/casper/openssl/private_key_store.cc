@@ -0,0 +1,264 @@
+/**
+ * @file private_key_store.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/private_key_store.h"
+
+#include "cc/exception.h"
+#include "cc/b64.h"
+
+#include <stdio.h>    // fopen
+#include <string.h>   // strerror
+#include <errno.h>
+
+#include <openssl/pem.h>
+#include <openssl/err.h>
+#include <openssl/crypto.h> // CRYPTO_secure_malloc_init
+
+#define CASPER_OPENSSL_PRIVATE_KEY_STORE_THROW_OPENSSL_ERROR(a_format, ...) \
+{ \
+    char __tmp_error__[130] = {0}; \
+    char __tmp_msg__  [257] = {0}; \
+    ERR_error_string(ERR_get_error(), __tmp_error__); \
+    snprintf(__tmp_msg__, 256, a_format, __VA_ARGS__); \
+    throw cc::Exception(std::string(__tmp_msg__) + " - " + std::string(__tmp_error__)); \
+}
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_capacity Maximum number of keys to keep.
+ */
+casper::openssl::PrivateKeyStore::PrivateKeyStore (const size_t a_capacity)
+ : entries_(a_capacity, [] (Entry& a_entry) {
+       EVP_PKEY_free(a_entry.pkey_);
+   })
+{
+    if ( 0 == a_capacity ) {
+        throw ::cc::Exception("%s", "Invalid private key store capacity!");
+    }
+    stats_ = { 0, 0, 0 };
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::openssl::PrivateKeyStore::~PrivateKeyStore ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Obtain a decrypted private key, reading and decrypting it only if it's not stored or if it's file changed.
+ *
+ * @param a_key Private key info.
+ *
+ * @return A new reference to the decrypted key, caller must release it with EVP_PKEY_free.
+ */
+EVP_PKEY* casper::openssl::PrivateKeyStore::Get (const PrivateKey& a_key)
+{
+    io::File::Identity file;
+    if ( false == io::File::Identify(a_key.uri_, file) ) {
+        throw ::cc::Exception("Unable to open '%s': %s !", a_key.uri_.c_str(), strerror(errno));
+    }
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int  length = 0;
+    if ( 1 != EVP_Digest(a_key.password_.c_str(), a_key.password_.length(), md, &length, EVP_sha256(), nullptr) ) {
+        CASPER_OPENSSL_PRIVATE_KEY_STORE_THROW_OPENSSL_ERROR("%s", "Unable to calculate private key password digest");
+    }
+    const std::string secret = std::string(reinterpret_cast<const char*>(md), static_cast<size_t>(length));
+    
+    // ... already decrypted?
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.Find([&a_key, &secret] (const Entry& a_entry) {
+            return a_key.uri_ == a_entry.uri_ && secret == a_entry.secret_;
+        });
+        if ( entries_.end() != it ) {
+            if ( file.mtime_ns_ == it->mtime_ns_ && file.size_ == it->size_ && 1 == EVP_PKEY_up_ref(it->pkey_) ) {
+                EVP_PKEY* pkey = it->pkey_;
+                // ... most recently used goes last ...
+                entries_.Touch(it);
+                stats_.hits_++;
+                return pkey;
+            }
+            // ... file changed ...
+            entries_.Erase(it);
+        }
+        stats_.misses_++;
+    }
+    
+    // ... read and decrypt it, without holding the lock ...
+    EVP_PKEY* pkey = Load(a_key);
+    
+    // ... keep it ...
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.EraseIf([&a_key, &secret] (const Entry& a_entry) {
+            return a_key.uri_ == a_entry.uri_ && secret == a_entry.secret_;
+        });
+        if ( 1 == EVP_PKEY_up_ref(pkey) ) {
+            stats_.evictions_ += entries_.Push({ a_key.uri_, secret, file.mtime_ns_, file.size_, pkey });
+        }
+    }
+    
+    return pkey;
+}
+
+/**
+ * @brief Discard a stored key and read and decrypt it again.
+ *
+ * @param a_key Private key info.
+ *
+ * @return A new reference to the decrypted key, caller must release it with EVP_PKEY_free.
+ */
+EVP_PKEY* casper::openssl::PrivateKeyStore::Reload (const PrivateKey& a_key)
+{
+    Evict(a_key);
+    return Get(a_key);
+}
+
+/**
+ * @brief Discard stored key(s) read from a file, references already handed out remain valid.
+ *
+ * @param a_key Private key info, only URI is used.
+ */
+void casper::openssl::PrivateKeyStore::Evict (const PrivateKey& a_key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.EraseIf([&a_key] (const Entry& a_entry) {
+        return a_key.uri_ == a_entry.uri_;
+    });
+}
+
+/**
+ * @brief Discard all stored keys, references already handed out remain valid.
+ */
+void casper::openssl::PrivateKeyStore::Clear ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.Clear();
+}
+
+/**
+ * @brief Sign data using SHA256 and a stored key.
+ *
+ * @param a_key  Private key info.
+ * @param a_data Data to sign.
+ * @param a_size Data size, in bytes.
+ *
+ * @return Base 64 encoded signature.
+ */
+std::string casper::openssl::PrivateKeyStore::SignSHA256 (const PrivateKey& a_key, const unsigned char* a_data, const size_t a_size)
+{
+    EVP_PKEY*   pkey    = Get(a_key);
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    size_t      length  = 0;
+    
+    std::vector<unsigned char> signature;
+    bool ok = (    nullptr != context
+                && 1 == EVP_DigestSignInit(context, nullptr, EVP_sha256(), nullptr, pkey)
+                && 1 == EVP_DigestSign(context, nullptr, &length, a_data, a_size) );
+    if ( true == ok ) {
+        signature.resize(length);
+        ok = ( 1 == EVP_DigestSign(context, signature.data(), &length, a_data, a_size) );
+    }
+    
+    if ( nullptr != context ) {
+        EVP_MD_CTX_free(context);
+    }
+    EVP_PKEY_free(pkey);
+    
+    if ( false == ok ) {
+        CASPER_OPENSSL_PRIVATE_KEY_STORE_THROW_OPENSSL_ERROR("Unable to sign data using '%s' private key", a_key.uri_.c_str());
+    }
+    
+    const std::string encoded = cc::base64_rfc4648::encode(signature.data(), length);
+    
+    return encoded;
+}
+
+/**
+ * @return A copy of current statistics.
+ */
+casper::openssl::PrivateKeyStore::Stats casper::openssl::PrivateKeyStore::stats ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @brief Enable OpenSSL secure heap, process wide, so that private key components are kept in locked memory.
+ *
+ * @param a_size     Heap size, in bytes, a power of 2.
+ * @param a_min_size Minimum allocation size, in bytes, a power of 2.
+ *
+ * @return True when enabled and protected, false otherwise.
+ */
+bool casper::openssl::PrivateKeyStore::EnableSecureHeap (const size_t a_size, const size_t a_min_size)
+{
+    if ( 1 == CRYPTO_secure_malloc_initialized() ) {
+        return true;
+    }
+    return ( 1 == CRYPTO_secure_malloc_init(a_size, static_cast<int>(a_min_size)) );
+}
+
+/**
+ * @brief Read and decrypt a private key, not stored.
+ *
+ * @param a_key Private key info.
+ *
+ * @return Decrypted RSA key, caller must release it with EVP_PKEY_free.
+ */
+EVP_PKEY* casper::openssl::PrivateKeyStore::Load (const PrivateKey& a_key)
+{
+    FILE* fp = fopen(a_key.uri_.c_str(), "r");
+    if ( nullptr == fp ) {
+        throw ::cc::Exception("Unable to open '%s': %s !", a_key.uri_.c_str(), strerror(errno));
+    }
+    EVP_PKEY* pkey = nullptr;
+    if ( 0 != a_key.password_.length() ) {
+        pkey = PEM_read_PrivateKey(fp, nullptr, &casper::openssl::PrivateKey::PEMPasswordCallback, (void*)a_key.password_.c_str());
+    } else {
+        pkey = PEM_read_PrivateKey(fp, nullptr, nullptr, nullptr);
+    }
+    if ( 0 != fclose(fp) ) {
+        if ( nullptr != pkey ) {
+            EVP_PKEY_free(pkey);
+        }
+        throw ::cc::Exception("Unable to close '%s': %s !", a_key.uri_.c_str(), strerror(errno));
+    }
+    if ( nullptr == pkey ) {
+        CASPER_OPENSSL_PRIVATE_KEY_STORE_THROW_OPENSSL_ERROR("Error while loading '%s' private key", a_key.uri_.c_str());
+    }
+    // ... signatures are RSA ( PKCS #1 v1.5 ) only ...
+    if ( EVP_PKEY_RSA != EVP_PKEY_base_id(pkey) ) {
+        const int type = EVP_PKEY_base_id(pkey);
+        EVP_PKEY_free(pkey);
+        throw ::cc::Exception("Unable to load '%s' private key - type %d is not RSA!", a_key.uri_.c_str(), type);
+    }
+    return pkey;
+}
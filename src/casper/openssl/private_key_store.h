@@ -0,0 +1,109 @@
+/**
+ * @file private_key_store.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_OPENSSL_PRIVATE_KEY_STORE_H_
+#define CASPER_OPENSSL_PRIVATE_KEY_STORE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include <openssl/evp.h>
+
+#include "casper/io/file.h"
+
+#include "casper/cache/lru.h"
+
+#include "casper/openssl/private_key.h"
+
+namespace casper
+{
+
+    namespace openssl
+    {
+    
+        /**
+         * @brief Decrypted private keys store.
+         *
+         *        Each key is read and decrypted once, reused \link EVP_PKEY \link objects keep their precomputed
+         *        CRT, Montgomery and blinding state; entries are keyed by file URI, modification time, size and password
+         *        SHA256 digest ( passwords are not kept ).
+         *
+         *        Private components are allocated from OpenSSL secure ( locked ) heap when it's enabled,
+         *        see \link EnableSecureHeap \link.
+         */
+        class PrivateKeyStore final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            typedef struct {
+                size_t hits_;      //!< Number of keys reused.
+                size_t misses_;    //!< Number of keys read and decrypted.
+                size_t evictions_; //!< Number of entries evicted to respect capacity.
+            } Stats;
+            
+        private: // Data Type(s)
+            
+            typedef struct {
+                std::string uri_;      //!< Key file URI.
+                std::string secret_;   //!< Password SHA256 digest.
+                int64_t     mtime_ns_; //!< File modification time, in nanoseconds.
+                size_t      size_;     //!< File size, in bytes.
+                EVP_PKEY*   pkey_;     //!< Decrypted key, one reference owned.
+            } Entry;
+            
+        private: // Data
+            
+            std::mutex          mutex_;
+            cache::LRU<Entry>   entries_;
+            Stats               stats_;
+            
+        public: // Constructor(s) / Destructor
+            
+            PrivateKeyStore () = delete;
+            PrivateKeyStore (const size_t a_capacity);
+            
+            virtual ~PrivateKeyStore ();
+            
+        public: // Method(s) / Function(s)
+            
+            EVP_PKEY*   Get        (const PrivateKey& a_key);
+            EVP_PKEY*   Reload     (const PrivateKey& a_key);
+            void        Evict      (const PrivateKey& a_key);
+            void        Clear      ();
+            std::string SignSHA256 (const PrivateKey& a_key, const unsigned char* a_data, const size_t a_size);
+            Stats       stats      ();
+            
+        public: // Static Method(s) / Function(s)
+            
+            static bool      EnableSecureHeap (const size_t a_size, const size_t a_min_size);
+            static EVP_PKEY* Load             (const PrivateKey& a_key);
+            
+        }; // end of class 'PrivateKeyStore'
+    
+    } // end of namespace 'openssl'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_OPENSSL_PRIVATE_KEY_STORE_H_
@@ -0,0 +1,359 @@
+/**
+ * @file digest_cache.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/digest_cache.h"
+
+#include "cc/exception.h"
+#include "cc/types.h" // SIZET_FMT
+
+#include <stdio.h>    // fopen, fprintf, fscanf, rename
+#include <string.h>   // memcmp, strerror
+#include <errno.h>
+#include <unistd.h>   // unlink
+#include <inttypes.h> // PRId64, SCNd64
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_capacity Maximum number of entries to keep.
+ */
+casper::pdf::DigestCache::DigestCache (const size_t a_capacity)
+ : entries_(a_capacity, [] (Entry& a_entry) {
+       EVP_MD_CTX_free(a_entry.context_);
+   }),
+   digests_(a_capacity)
+{
+    if ( 0 == a_capacity ) {
+        throw ::cc::Exception("%s", "Invalid digest cache capacity!");
+    }
+    stats_ = { 0, 0, 0, 0, 0 };
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::DigestCache::~DigestCache ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Save a SHA256 context.
+ *
+ * @param a_uri     Local file URI.
+ * @param a_size    Number of bytes, from the start of the file, already hashed by \link a_context \link.
+ * @param a_context SHA256 context, will be copied.
+ */
+void casper::pdf::DigestCache::Save (const std::string& a_uri, const size_t a_size, const EVP_MD_CTX* a_context)
+{
+    io::File::Identity file;
+    // ... file must exist and have, at least, the hashed bytes ...
+    if ( false == io::File::Identify(a_uri, file) || file.size_ < a_size ) {
+        return;
+    }
+    
+    // ... copy context ...
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if ( nullptr == context || 1 != EVP_MD_CTX_copy_ex(context, a_context) ) {
+        if ( nullptr != context ) {
+            EVP_MD_CTX_free(context);
+        }
+        throw ::cc::Exception("%s", "Unable to copy SHA256 context!");
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // ... replace previous entry for the same bytes ...
+    const auto it = entries_.Find([&file, a_size] (const Entry& a_entry) {
+        return file.device_ == a_entry.key_.device_ && file.inode_ == a_entry.key_.inode_ && a_size == a_entry.key_.size_;
+    });
+    if ( entries_.end() != it ) {
+        entries_.Erase(it);
+    }
+    // ... respect capacity ...
+    stats_.evictions_ += entries_.Push({
+        /* key_      */ { file.device_, file.inode_, a_size },
+        /* mtime_ns_ */ file.mtime_ns_,
+        /* context_  */ context
+    });
+}
+
+/**
+ * @brief Restore the SHA256 context that covers most bytes of a file.
+ *
+ * @param a_uri      Local file URI.
+ * @param a_max_size Maximum number of bytes that may have been hashed.
+ * @param o_context  SHA256 context, will be overwritten with saved one.
+ * @param o_size     Number of bytes, from the start of the file, already hashed by \link o_context \link.
+ *
+ * @return True when a context was restored, false otherwise.
+ */
+bool casper::pdf::DigestCache::Restore (const std::string& a_uri, const size_t a_max_size, EVP_MD_CTX* o_context, size_t& o_size)
+{
+    io::File::Identity file;
+    
+    const bool exists = io::File::Identify(a_uri, file);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto best = entries_.end();
+    if ( true == exists ) {
+        for ( auto it = entries_.begin() ; entries_.end() != it ; ++it ) {
+            if (    file.device_ == it->key_.device_ && file.inode_ == it->key_.inode_ && file.mtime_ns_ == it->mtime_ns_
+                 && it->key_.size_ <= a_max_size && it->key_.size_ <= file.size_
+                 && ( entries_.end() == best || it->key_.size_ > best->key_.size_ ) ) {
+                best = it;
+            }
+        }
+    }
+    if ( entries_.end() == best || 1 != EVP_MD_CTX_copy_ex(o_context, best->context_) ) {
+        stats_.misses_++;
+        return false;
+    }
+    o_size = best->key_.size_;
+    // ... most recently used goes last ...
+    entries_.Touch(best);
+    stats_.hits_++;
+    return true;
+}
+
+/**
+ * @brief Acknowledge a write to a file, keeping entries that don't cover written bytes.
+ *
+ * @param a_uri  Local file URI.
+ * @param a_from Position of the first byte written.
+ * @param a_to   Position after the last byte written, omit when writing to the end of the file.
+ */
+void casper::pdf::DigestCache::Touch (const std::string& a_uri, const size_t a_from, const size_t a_to)
+{
+    io::File::Identity file;
+    
+    if ( false == io::File::Identify(a_uri, file) ) {
+        Forget(a_uri);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    for ( auto it = entries_.begin() ; entries_.end() != it ; ) {
+        if ( file.device_ == it->key_.device_ && file.inode_ == it->key_.inode_ ) {
+            if ( it->key_.size_ <= a_from && it->key_.size_ <= file.size_ ) {
+                it->mtime_ns_ = file.mtime_ns_;
+            } else {
+                it = entries_.Erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+    
+    // ... /ByteRange digests remain valid if only /Contents was written ...
+    for ( auto it = digests_.begin() ; digests_.end() != it ; ) {
+        if ( file.device_ == it->device_ && file.inode_ == it->inode_ ) {
+            if (    file.size_ == it->size_
+                 && a_from >= it->range_.before_start_ + it->range_.before_size_ && a_to <= it->range_.after_start_ ) {
+                it->mtime_ns_ = file.mtime_ns_;
+            } else {
+                it = digests_.Erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+}
+
+/**
+ * @brief Forget all entries for a file.
+ *
+ * @param a_uri Local file URI.
+ */
+void casper::pdf::DigestCache::Forget (const std::string& a_uri)
+{
+    io::File::Identity file;
+    
+    if ( false == io::File::Identify(a_uri, file) ) {
+        // ... stale entries will never match a live file's modification time ...
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    entries_.EraseIf([&file] (const Entry& a_entry) {
+        return file.device_ == a_entry.key_.device_ && file.inode_ == a_entry.key_.inode_;
+    });
+    digests_.EraseIf([&file] (const Digest& a_digest) {
+        return file.device_ == a_digest.device_ && file.inode_ == a_digest.inode_;
+    });
+}
+
+/**
+ * @brief Forget all entries.
+ */
+void casper::pdf::DigestCache::Clear ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.Clear();
+    digests_.Clear();
+}
+
+/**
+ * @return A copy of current statistics.
+ */
+casper::pdf::DigestCache::Stats casper::pdf::DigestCache::stats ()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// MARK: - [PUBLIC] - /ByteRange Digest - Method(s) / Function(s)
+
+/**
+ * @brief Remember a /ByteRange digest.
+ *
+ * @param a_uri    Local file URI.
+ * @param a_range  See \link ByteRange \link.
+ * @param a_digest SHA256 Base 64 encoded /ByteRange digest.
+ */
+void casper::pdf::DigestCache::Remember (const std::string& a_uri, const pdf::ByteRange& a_range, const std::string& a_digest)
+{
+    io::File::Identity file;
+    if ( false == io::File::Identify(a_uri, file) ) {
+        return;
+    }
+    Digest digest;
+    digest.device_   = file.device_;
+    digest.inode_    = file.inode_;
+    digest.size_     = file.size_;
+    digest.mtime_ns_ = file.mtime_ns_;
+    digest.range_    = a_range;
+    digest.digest_   = a_digest;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // ... a file has only one version, forget all others ...
+    digests_.EraseIf([&digest] (const Digest& a_digest) {
+        return    digest.device_ == a_digest.device_ && digest.inode_ == a_digest.inode_
+               && ( digest.mtime_ns_ != a_digest.mtime_ns_ || digest.size_ != a_digest.size_
+                    || 0 == memcmp(&digest.range_, &a_digest.range_, sizeof(digest.range_)) );
+    });
+    // ... respect capacity ...
+    stats_.evictions_ += digests_.Push(std::move(digest));
+}
+
+/**
+ * @brief Lookup a /ByteRange digest of an unchanged file.
+ *
+ * @param a_uri    Local file URI.
+ * @param a_range  See \link ByteRange \link.
+ * @param o_digest SHA256 Base 64 encoded /ByteRange digest.
+ *
+ * @return True when found, false otherwise.
+ */
+bool casper::pdf::DigestCache::Lookup (const std::string& a_uri, const pdf::ByteRange& a_range, std::string& o_digest)
+{
+    io::File::Identity file;
+    
+    const bool exists = io::File::Identify(a_uri, file);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if ( true == exists ) {
+        const auto it = digests_.Find([&file, &a_range] (const Digest& a_digest) {
+            return    file.device_ == a_digest.device_ && file.inode_ == a_digest.inode_ && file.mtime_ns_ == a_digest.mtime_ns_
+                   && file.size_ == a_digest.size_ && 0 == memcmp(&a_range, &a_digest.range_, sizeof(a_range));
+        });
+        if ( digests_.end() != it ) {
+            o_digest = it->digest_;
+            // ... most recently used goes last ...
+            digests_.Touch(it);
+            stats_.digest_hits_++;
+            return true;
+        }
+    }
+    stats_.digest_misses_++;
+    return false;
+}
+
+/**
+ * @brief Persist /ByteRange digests.
+ *
+ * @param a_uri Local file URI, replaced atomically.
+ */
+void casper::pdf::DigestCache::Dump (const std::string& a_uri)
+{
+    const std::string tmp = a_uri + ".tmp";
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    FILE* file = fopen(tmp.c_str(), "w");
+    if ( nullptr == file ) {
+        throw ::cc::Exception("Unable to open file '%s': %s!", tmp.c_str(), strerror(errno));
+    }
+    bool ok = true;
+    for ( auto& digest : digests_ ) {
+        ok = ok && 0 < fprintf(file, "%ju %ju %" PRId64 " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " %s\n",
+                               static_cast<uintmax_t>(digest.device_), static_cast<uintmax_t>(digest.inode_), digest.mtime_ns_, digest.size_,
+                               digest.range_.before_start_, digest.range_.before_size_, digest.range_.after_start_, digest.range_.after_size_,
+                               digest.digest_.c_str());
+    }
+    ok = ( 0 == fclose(file) ) && ok;
+    if ( false == ok || 0 != rename(tmp.c_str(), a_uri.c_str()) ) {
+        (void)unlink(tmp.c_str());
+        throw ::cc::Exception("Unable to write file '%s'!", a_uri.c_str());
+    }
+}
+
+/**
+ * @brief Load persisted /ByteRange digests, stale ones are ignored when looked up.
+ *
+ * @param a_uri Local file URI, missing file is not an error.
+ */
+void casper::pdf::DigestCache::Load (const std::string& a_uri)
+{
+    FILE* file = fopen(a_uri.c_str(), "r");
+    if ( nullptr == file ) {
+        if ( ENOENT == errno ) {
+            return;
+        }
+        throw ::cc::Exception("Unable to open file '%s': %s!", a_uri.c_str(), strerror(errno));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    uintmax_t device;
+    uintmax_t inode;
+    Digest    digest;
+    char      b64[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+    while ( 9 == fscanf(file, "%ju %ju %" SCNd64 " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " " SIZET_FMT " %88s",
+                        &device, &inode, &digest.mtime_ns_, &digest.size_,
+                        &digest.range_.before_start_, &digest.range_.before_size_, &digest.range_.after_start_, &digest.range_.after_size_,
+                        b64) ) {
+        digest.device_ = static_cast<dev_t>(device);
+        digest.inode_  = static_cast<ino_t>(inode);
+        digest.digest_ = b64;
+        stats_.evictions_ += digests_.Push(Digest(digest));
+    }
+    fclose(file);
+}
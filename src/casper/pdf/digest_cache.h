@@ -0,0 +1,134 @@
+/**
+ * @file digest_cache.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_DIGEST_CACHE_H_
+#define CASPER_PDF_DIGEST_CACHE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+#include <mutex>
+#include <limits> // std::numeric_limits
+
+#include <sys/types.h> // dev_t, ino_t
+
+#include <openssl/evp.h>
+
+#include "casper/io/file.h"
+
+#include "casper/cache/lru.h"
+
+#include "casper/pdf/types.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+    
+        /**
+         * @brief SHA256 intermediate state ( midstate ) cache.
+         *
+         *        Incremental updates never touch bytes already written, so a SHA256 context saved after hashing
+         *        the first N bytes of a file can be restored later to hash only what was appended after them.
+         *
+         *        Entries are keyed by file device, inode and number of bytes hashed; file contents are never
+         *        re-hashed to validate an entry, identity is stat-based: an entry is only restored while the file
+         *        modification time is the one recorded when it was saved, or refreshed by \link Touch \link after
+         *        a write that didn't change those bytes.
+         *
+         *        It also keeps final /ByteRange digests keyed by file device, inode, modification time, size and
+         *        /ByteRange, so that retried signing attributes calculation don't read the document again; those
+         *        can be persisted with \link Dump \link and \link Load \link ( SHA256 contexts can't ).
+         */
+        class DigestCache final : public ::cc::NonCopyable, public ::cc::NonMovable
+        {
+            
+        public: // Data Type(s)
+            
+            typedef struct {
+                dev_t  device_; //!< File device.
+                ino_t  inode_;  //!< File inode.
+                size_t size_;   //!< Number of bytes hashed.
+            } Key;
+            
+            typedef struct {
+                size_t hits_;          //!< Number of successful restores.
+                size_t misses_;        //!< Number of failed restores.
+                size_t evictions_;     //!< Number of entries evicted to respect capacity.
+                size_t digest_hits_;   //!< Number of successful /ByteRange digest lookups.
+                size_t digest_misses_; //!< Number of failed /ByteRange digest lookups.
+            } Stats;
+            
+        private: // Data Type(s)
+            
+            typedef struct {
+                Key         key_;
+                int64_t     mtime_ns_; //!< File modification time, in nanoseconds, when saved or last touched.
+                EVP_MD_CTX* context_;  //!< SHA256 context after hashing key_.size_ bytes, owned.
+            } Entry;
+            
+            typedef struct {
+                dev_t          device_;
+                ino_t          inode_;
+                int64_t        mtime_ns_; //!< File modification time, in nanoseconds, when calculated or last touched.
+                size_t         size_;     //!< File size, in bytes.
+                pdf::ByteRange range_;
+                std::string    digest_;   //!< SHA256 Base 64 encoded /ByteRange digest.
+            } Digest;
+            
+        private: // Data
+            
+            std::mutex          mutex_;
+            cache::LRU<Entry>   entries_;
+            cache::LRU<Digest>  digests_;
+            Stats               stats_;
+            
+        public: // Constructor(s) / Destructor
+            
+            DigestCache () = delete;
+            DigestCache (const size_t a_capacity);
+            
+            virtual ~DigestCache ();
+            
+        public: // Method(s) / Function(s)
+            
+            void   Save    (const std::string& a_uri, const size_t a_size, const EVP_MD_CTX* a_context);
+            bool   Restore (const std::string& a_uri, const size_t a_max_size, EVP_MD_CTX* o_context, size_t& o_size);
+            void   Touch   (const std::string& a_uri, const size_t a_from, const size_t a_to = std::numeric_limits<size_t>::max());
+            void   Forget  (const std::string& a_uri);
+            void   Clear   ();
+            Stats  stats   ();
+            
+        public: // /ByteRange Digest - Method(s) / Function(s)
+            
+            void   Remember (const std::string& a_uri, const pdf::ByteRange& a_range, const std::string& a_digest);
+            bool   Lookup   (const std::string& a_uri, const pdf::ByteRange& a_range, std::string& o_digest);
+            void   Dump     (const std::string& a_uri);
+            void   Load     (const std::string& a_uri);
+            
+        }; // end of class 'DigestCache'
+    
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_DIGEST_CACHE_H_
@@ -0,0 +1,375 @@
+/**
+ * @file lexer.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/lexer.h"
+
+#include "cc/exception.h"
+#include "cc/types.h" // SIZET_FMT
+
+#include <stdlib.h> // strtoll
+
+const size_t casper::pdf::native::Lexer::sk_max_depth_ = 64;
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_data     Window bytes.
+ * @param a_length   Window length, in bytes.
+ * @param a_base     Document offset of the first window byte.
+ * @param a_complete True when window ends where the document ends.
+ */
+casper::pdf::native::Lexer::Lexer (const char* a_data, const size_t a_length, const size_t a_base, const bool a_complete)
+ : data_(a_data), length_(a_length), base_(a_base), complete_(a_complete)
+{
+    position_ = 0;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::native::Lexer::~Lexer ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Skip whitespace and comments.
+ *
+ * @return False when window ended and more bytes are required, true otherwise.
+ */
+bool casper::pdf::native::Lexer::SkipWhitespace ()
+{
+    while ( position_ < length_ ) {
+        const char c = data_[position_];
+        if ( '%' == c ) {
+            while ( position_ < length_ && '\r' != data_[position_] && '\n' != data_[position_] ) {
+                position_++;
+            }
+        } else if ( true == IsWhitespace(c) ) {
+            position_++;
+        } else {
+            return true;
+        }
+    }
+    return complete_;
+}
+
+/**
+ * @brief Skip a number of bytes.
+ *
+ * @param a_count Number of bytes to skip.
+ */
+void casper::pdf::native::Lexer::Skip (const size_t a_count)
+{
+    position_ += a_count;
+}
+
+/**
+ * @brief Read next token.
+ *
+ * @param o_token One of \link Token \link.
+ * @param o_text  Token text: names without '/', strings with delimiters.
+ *
+ * @return False when window ended and more bytes are required, true otherwise.
+ */
+bool casper::pdf::native::Lexer::Next (Token& o_token, std::string& o_text)
+{
+    if ( false == SkipWhitespace() ) {
+        return false;
+    }
+    o_text.clear();
+    if ( position_ >= length_ ) {
+        o_token = Token::End;
+        return true;
+    }
+    const size_t start = position_;
+    const char   c     = data_[position_];
+    switch (c) {
+        case '[':
+            o_token = Token::ArrayStart;
+            position_++;
+            return true;
+        case ']':
+            o_token = Token::ArrayEnd;
+            position_++;
+            return true;
+        case '<':
+            if ( position_ + 1 >= length_ ) {
+                if ( false == complete_ ) {
+                    return false;
+                }
+                throw ::cc::Exception("Unexpected end of document at offset " SIZET_FMT "!", offset());
+            }
+            if ( '<' == data_[position_ + 1] ) {
+                o_token    = Token::DictionaryStart;
+                position_ += 2;
+                return true;
+            }
+            while ( position_ < length_ && '>' != data_[position_] ) {
+                position_++;
+            }
+            if ( position_ >= length_ ) {
+                if ( false == complete_ ) {
+                    position_ = start;
+                    return false;
+                }
+                throw ::cc::Exception("Unterminated hex string at offset " SIZET_FMT "!", base_ + start);
+            }
+            position_++;
+            o_token = Token::String;
+            o_text  = std::string(data_ + start, position_ - start);
+            return true;
+        case '>':
+            if ( position_ + 1 >= length_ ) {
+                if ( false == complete_ ) {
+                    return false;
+                }
+                throw ::cc::Exception("Unexpected end of document at offset " SIZET_FMT "!", offset());
+            }
+            if ( '>' != data_[position_ + 1] ) {
+                throw ::cc::Exception("Unexpected '>' at offset " SIZET_FMT "!", offset());
+            }
+            o_token    = Token::DictionaryEnd;
+            position_ += 2;
+            return true;
+        case '(':
+        {
+            size_t depth = 0;
+            while ( position_ < length_ ) {
+                const char s = data_[position_];
+                if ( '\\' == s ) {
+                    position_ += 2;
+                    continue;
+                } else if ( '(' == s ) {
+                    depth++;
+                } else if ( ')' == s ) {
+                    if ( 0 == --depth ) {
+                        break;
+                    }
+                }
+                position_++;
+            }
+            if ( position_ >= length_ ) {
+                if ( false == complete_ ) {
+                    position_ = start;
+                    return false;
+                }
+                throw ::cc::Exception("Unterminated string at offset " SIZET_FMT "!", base_ + start);
+            }
+            position_++;
+            o_token = Token::String;
+            o_text  = std::string(data_ + start, position_ - start);
+            return true;
+        }
+        case ')':
+        case '{':
+        case '}':
+            throw ::cc::Exception("Unexpected '%c' at offset " SIZET_FMT "!", c, offset());
+        default:
+            break;
+    }
+    // ... name or regular token ...
+    if ( '/' == c ) {
+        position_++;
+    }
+    while ( position_ < length_ && false == IsWhitespace(data_[position_]) && false == IsDelimiter(data_[position_]) ) {
+        position_++;
+    }
+    if ( position_ >= length_ && false == complete_ ) {
+        position_ = start;
+        return false;
+    }
+    if ( '/' == c ) {
+        o_token = Token::Name;
+        o_text  = std::string(data_ + start + 1, position_ - start - 1);
+        return true;
+    }
+    o_text = std::string(data_ + start, position_ - start);
+    // ... number?
+    bool   numeric = true;
+    size_t dots    = 0;
+    for ( size_t idx = 0 ; idx < o_text.length() ; ++idx ) {
+        const char d = o_text[idx];
+        if ( '.' == d ) {
+            dots++;
+        } else if ( ( '+' == d || '-' == d ) && 0 == idx ) {
+            continue;
+        } else if ( d < '0' || d > '9' ) {
+            numeric = false;
+            break;
+        }
+    }
+    if ( true == numeric && dots <= 1 && o_text.find_first_of("0123456789") != std::string::npos ) {
+        o_token = ( 0 == dots ? Token::Integer : Token::Real );
+    } else {
+        o_token = Token::Keyword;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a direct object.
+ *
+ * @param o_value Parsed value.
+ *
+ * @return False when window ended and more bytes are required, true otherwise.
+ */
+bool casper::pdf::native::Lexer::Parse (Value& o_value)
+{
+    return Parse(o_value, 0);
+}
+
+/**
+ * @brief Consume a keyword, if it's the next token.
+ *
+ * @param a_keyword Keyword to match.
+ * @param o_matched True when matched ( and consumed ), false otherwise.
+ *
+ * @return False when window ended and more bytes are required, true otherwise.
+ */
+bool casper::pdf::native::Lexer::Expect (const char* const a_keyword, bool& o_matched)
+{
+    const size_t saved = position_;
+    Token        token;
+    std::string  text;
+    if ( false == Next(token, text) ) {
+        return false;
+    }
+    o_matched = ( Token::Keyword == token && text == a_keyword );
+    if ( false == o_matched ) {
+        position_ = saved;
+    }
+    return true;
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Parse a direct object.
+ *
+ * @param o_value Parsed value.
+ * @param a_depth Current nesting depth.
+ *
+ * @return False when window ended and more bytes are required, true otherwise.
+ */
+bool casper::pdf::native::Lexer::Parse (Value& o_value, const size_t a_depth)
+{
+    if ( a_depth > sk_max_depth_ ) {
+        throw ::cc::Exception("Object nesting too deep at offset " SIZET_FMT "!", offset());
+    }
+    Token       token;
+    std::string text;
+    if ( false == Next(token, text) ) {
+        return false;
+    }
+    switch (token) {
+        case Token::Integer:
+        {
+            // ... indirect reference?
+            const size_t saved = position_;
+            Token        token2, token3;
+            std::string  text2, text3;
+            if ( false == Next(token2, text2) ) {
+                return false;
+            }
+            if ( Token::Integer == token2 ) {
+                if ( false == Next(token3, text3) ) {
+                    return false;
+                }
+                if ( Token::Keyword == token3 && "R" == text3 ) {
+                    o_value = Value::Reference(strtoll(text.c_str(), nullptr, 10), static_cast<uint32_t>(strtoul(text2.c_str(), nullptr, 10)));
+                    return true;
+                }
+            }
+            position_ = saved;
+            o_value   = Value::Integer(strtoll(text.c_str(), nullptr, 10));
+            return true;
+        }
+        case Token::Real:
+            o_value = Value::Real(text);
+            return true;
+        case Token::Name:
+            o_value = Value::Name(text);
+            return true;
+        case Token::String:
+            o_value = Value::String(text);
+            return true;
+        case Token::Keyword:
+            if ( "true" == text || "false" == text ) {
+                o_value = Value::Boolean("true" == text);
+            } else if ( "null" == text ) {
+                o_value = Value();
+            } else {
+                throw ::cc::Exception("Unexpected keyword '%s' at offset " SIZET_FMT "!", text.c_str(), offset());
+            }
+            return true;
+        case Token::ArrayStart:
+        {
+            o_value = Value::Array();
+            while ( true ) {
+                const size_t saved = position_;
+                if ( false == Next(token, text) ) {
+                    return false;
+                }
+                if ( Token::ArrayEnd == token ) {
+                    break;
+                } else if ( Token::End == token ) {
+                    throw ::cc::Exception("Unterminated array at offset " SIZET_FMT "!", offset());
+                }
+                position_ = saved;
+                Value item;
+                if ( false == Parse(item, a_depth + 1) ) {
+                    return false;
+                }
+                o_value.Add(item);
+            }
+            return true;
+        }
+        case Token::DictionaryStart:
+        {
+            o_value = Value::Dictionary();
+            while ( true ) {
+                if ( false == Next(token, text) ) {
+                    return false;
+                }
+                if ( Token::DictionaryEnd == token ) {
+                    break;
+                } else if ( Token::Name != token ) {
+                    throw ::cc::Exception("Expecting a dictionary key at offset " SIZET_FMT "!", offset());
+                }
+                Value item;
+                if ( false == Parse(item, a_depth + 1) ) {
+                    return false;
+                }
+                o_value.Set(text, item);
+            }
+            return true;
+        }
+        case Token::End:
+            throw ::cc::Exception("Unexpected end of document at offset " SIZET_FMT "!", offset());
+        default:
+            throw ::cc::Exception("Unexpected token at offset " SIZET_FMT "!", offset());
+    }
+}
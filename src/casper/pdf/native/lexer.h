@@ -0,0 +1,158 @@
+/**
+ * @file lexer.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_NATIVE_LEXER_H_
+#define CASPER_PDF_NATIVE_LEXER_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+
+#include "casper/pdf/native/value.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace native
+        {
+        
+            /**
+             * @brief PDF tokenizer and direct object parser over a window of a document.
+             *
+             *        When the window is not the whole document, running out of bytes is not an error: parse
+             *        functions return false and caller should retry with a larger window.
+             */
+            class Lexer final : public ::cc::NonCopyable, public ::cc::NonMovable
+            {
+                
+            public: // Data Type(s)
+                
+                enum class Token : uint8_t {
+                    End = 0,
+                    Integer,
+                    Real,
+                    Name,
+                    String,
+                    ArrayStart,
+                    ArrayEnd,
+                    DictionaryStart,
+                    DictionaryEnd,
+                    Keyword
+                };
+                
+            private: // Static Const Data
+                
+                static const size_t sk_max_depth_;
+                
+            private: // Const Data
+                
+                const char*  data_;
+                const size_t length_;
+                const size_t base_;     //!< Document offset of data_[0].
+                const bool   complete_; //!< True when window ends where the document ends.
+                
+            private: // Data
+                
+                size_t       position_;
+                
+            public: // Constructor(s) / Destructor
+                
+                Lexer () = delete;
+                Lexer (const char* a_data, const size_t a_length, const size_t a_base, const bool a_complete);
+                
+                virtual ~Lexer ();
+                
+            public: // Method(s) / Function(s)
+                
+                bool Next           (Token& o_token, std::string& o_text);
+                bool Parse          (Value& o_value);
+                bool Expect         (const char* const a_keyword, bool& o_matched);
+                bool SkipWhitespace ();
+                void Skip           (const size_t a_count);
+                
+            public: // Inline Method(s) / Function(s)
+                
+                size_t position () const;
+                size_t offset   () const;
+                void   Seek     (const size_t a_position);
+                
+            private: // Method(s) / Function(s)
+                
+                bool Parse (Value& o_value, const size_t a_depth);
+                
+            public: // Static Method(s) / Function(s)
+                
+                static bool IsWhitespace (const char a_char);
+                static bool IsDelimiter  (const char a_char);
+                
+            }; // end of class 'Lexer'
+        
+            /**
+             * @return Current position, relative to window start.
+             */
+            inline size_t Lexer::position () const
+            {
+                return position_;
+            }
+        
+            /**
+             * @return Current position, relative to document start.
+             */
+            inline size_t Lexer::offset () const
+            {
+                return base_ + position_;
+            }
+        
+            /**
+             * @brief Move to a position, relative to window start.
+             */
+            inline void Lexer::Seek (const size_t a_position)
+            {
+                position_ = a_position;
+            }
+        
+            /**
+             * @return True if character is a PDF whitespace.
+             */
+            inline bool Lexer::IsWhitespace (const char a_char)
+            {
+                return ( '\0' == a_char || '\t' == a_char || '\n' == a_char || '\f' == a_char || '\r' == a_char || ' ' == a_char );
+            }
+        
+            /**
+             * @return True if character is a PDF delimiter.
+             */
+            inline bool Lexer::IsDelimiter (const char a_char)
+            {
+                return ( '(' == a_char || ')' == a_char || '<' == a_char || '>' == a_char || '[' == a_char || ']' == a_char
+                         || '{' == a_char || '}' == a_char || '/' == a_char || '%' == a_char );
+            }
+        
+        } // end of namespace 'native'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_NATIVE_LEXER_H_
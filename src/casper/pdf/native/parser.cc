@@ -0,0 +1,765 @@
+/**
+ * @file parser.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/parser.h"
+
+#include "casper/pdf/native/lexer.h"
+
+#include "cc/exception.h"
+#include "cc/types.h" // SIZET_FMT
+
+#include <string.h> // memcmp
+#include <stdlib.h> // strtoull
+
+#include <zlib.h>
+
+const size_t casper::pdf::native::Parser::sk_window_            = 4096;
+const size_t casper::pdf::native::Parser::sk_max_window_        = 64 * 1024 * 1024;
+const size_t casper::pdf::native::Parser::sk_max_sections_      = 4096;
+const size_t casper::pdf::native::Parser::sk_max_decoded_       = 64 * 1024 * 1024;
+const size_t casper::pdf::native::Parser::sk_max_inflate_ratio_ = 1032; // ... deflate's own limit ...
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_settings I/O settings to use when reading the document.
+ */
+casper::pdf::native::Parser::Parser (const io::File::Settings& a_settings)
+ : settings_(a_settings)
+{
+    file_          = nullptr;
+    size_          = 0;
+    startxref_     = 0;
+    xref_stream_   = false;
+    object_stream_ = -1;
+    next_xref_     = 0;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::native::Parser::~Parser ()
+{
+    if ( nullptr != file_ ) {
+        delete file_;
+    }
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Open a document, reading only it's trailer and newest cross-reference section.
+ *
+ * @param a_uri Local file URI.
+ */
+void casper::pdf::native::Parser::Open (const std::string& a_uri)
+{
+    if ( nullptr != file_ ) {
+        throw ::cc::Exception("%s", "Document is already open!");
+    }
+    try {
+        file_ = io::File::New(settings_);
+        file_->Open(a_uri, io::File::Mode::Read);
+        size_ = file_->Size();
+        
+        // ... find last 'startxref' ...
+        const size_t tail_length = std::min(size_, static_cast<size_t>(1024));
+        const size_t tail_offset = size_ - tail_length;
+        std::string  tail;
+        Window(tail_offset, tail_length, tail);
+        const size_t position = tail.rfind("startxref");
+        if ( std::string::npos == position ) {
+            throw ::cc::Exception("Unable to find 'startxref' in '%s'!", a_uri.c_str());
+        }
+        Lexer              lexer(tail.c_str() + position + 9, tail.length() - position - 9, tail_offset + position + 9, /* a_complete */ true);
+        Lexer::Token       token;
+        std::string        text;
+        if ( false == lexer.Next(token, text) || Lexer::Token::Integer != token ) {
+            throw ::cc::Exception("Invalid 'startxref' in '%s'!", a_uri.c_str());
+        }
+        startxref_ = static_cast<size_t>(strtoull(text.c_str(), nullptr, 10));
+        if ( startxref_ >= size_ ) {
+            throw ::cc::Exception("Invalid 'startxref' " SIZET_FMT " in '%s'!", startxref_, a_uri.c_str());
+        }
+        
+        // ... newest cross-reference section, older ones are read on demand ...
+        next_xref_ = startxref_;
+        (void)ReadXRef();
+        
+        if ( nullptr == trailer_.Get("Root") ) {
+            throw ::cc::Exception("Unable to find '/Root' in '%s' trailer!", a_uri.c_str());
+        }
+    } catch (...) {
+        Close();
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+/**
+ * @brief Close currently open document.
+ */
+void casper::pdf::native::Parser::Close ()
+{
+    if ( nullptr != file_ ) {
+        delete file_;
+        file_ = nullptr;
+    }
+    size_          = 0;
+    startxref_     = 0;
+    xref_stream_   = false;
+    trailer_       = Value();
+    object_stream_ = -1;
+    next_xref_     = 0;
+    sections_.clear();
+    visited_.clear();
+    loading_.clear();
+    object_stream_data_.clear();
+    object_stream_offsets_.clear();
+}
+
+/**
+ * @brief Load an indirect object.
+ *
+ * @param a_number Object number.
+ * @param o_value  Object value, null if object doesn't exist.
+ */
+void casper::pdf::native::Parser::Load (const int64_t a_number, Value& o_value)
+{
+    Entry entry;
+    if ( false == Find(a_number, entry) ) {
+        o_value = Value();
+    } else if ( 1 == entry.type_ ) {
+        ReadObject(static_cast<size_t>(entry.field2_), a_number, o_value);
+    } else {
+        ReadCompressed(static_cast<int64_t>(entry.field2_), static_cast<size_t>(entry.field3_), a_number, o_value);
+    }
+}
+
+/**
+ * @brief Resolve a value, loading it if it's an indirect reference.
+ *
+ * @param a_value Value to resolve.
+ * @param o_value Resolved value.
+ */
+void casper::pdf::native::Parser::Resolve (const Value& a_value, Value& o_value)
+{
+    if ( Value::Type::Reference == a_value.type() ) {
+        Load(a_value.integer(), o_value);
+    } else {
+        o_value = a_value;
+    }
+}
+
+/**
+ * @brief Read and decode stream data, only /FlateDecode ( with PNG predictors ) is supported.
+ *
+ * @param a_stream Stream value.
+ * @param o_data   Decoded data.
+ */
+void casper::pdf::native::Parser::Decode (const Value& a_stream, std::string& o_data)
+{
+    if ( Value::Type::Stream != a_stream.type() || nullptr == a_stream.Get("Length") ) {
+        throw ::cc::Exception("%s", "Invalid stream!");
+    }
+    Value length;
+    Resolve(*a_stream.Get("Length"), length);
+    if ( Value::Type::Integer != length.type() || length.integer() < 0 || a_stream.offset() + static_cast<size_t>(length.integer()) > size_ ) {
+        throw ::cc::Exception("Invalid stream length at offset " SIZET_FMT "!", a_stream.offset());
+    }
+    
+    // ... filter ...
+    bool         flate  = false;
+    const Value* filter = a_stream.Get("Filter");
+    const Value* parms  = a_stream.Get("DecodeParms");
+    if ( nullptr != filter && Value::Type::Array == filter->type() ) {
+        if ( filter->items().size() > 1 ) {
+            throw ::cc::Exception("%s", "Unsupported stream filter chain!");
+        }
+        filter = ( 1 == filter->items().size() ? &filter->items()[0] : nullptr );
+        if ( nullptr != parms && Value::Type::Array == parms->type() ) {
+            parms = ( 1 == parms->items().size() ? &parms->items()[0] : nullptr );
+        }
+    }
+    if ( nullptr != filter && Value::Type::Null != filter->type() ) {
+        if ( Value::Type::Name != filter->type() || ( "FlateDecode" != filter->token() && "Fl" != filter->token() ) ) {
+            throw ::cc::Exception("Unsupported stream filter '%s'!", filter->token().c_str());
+        }
+        flate = true;
+    }
+    
+    o_data.clear();
+    if ( false == flate ) {
+        Window(a_stream.offset(), static_cast<size_t>(length.integer()), o_data);
+        return;
+    }
+    
+    // ... inflate, streamed, no larger than what a valid deflate stream of this length can produce ( nor a sane limit ) ...
+    const size_t limit = std::min(sk_max_decoded_, static_cast<size_t>(length.integer()) * sk_max_inflate_ratio_);
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if ( Z_OK != inflateInit(&zs) ) {
+        throw ::cc::Exception("%s", "Unable to initialize inflate!");
+    }
+    try {
+        unsigned char out[16384];
+        bool          done = false;
+        file_->Read(a_stream.offset(), static_cast<size_t>(length.integer()), [&zs, &out, &done, &o_data, limit] (const unsigned char* a_bytes, const size_t& a_size) {
+            if ( true == done ) {
+                return;
+            }
+            zs.next_in  = const_cast<unsigned char*>(a_bytes);
+            zs.avail_in = static_cast<uInt>(a_size);
+            while ( zs.avail_in > 0 ) {
+                zs.next_out  = out;
+                zs.avail_out = sizeof(out);
+                const int rv = inflate(&zs, Z_NO_FLUSH);
+                if ( sizeof(out) - zs.avail_out > limit - o_data.length() ) {
+                    throw ::cc::Exception("Inflated stream exceeds " SIZET_FMT " bytes!", limit);
+                }
+                o_data.append(reinterpret_cast<const char*>(out), sizeof(out) - zs.avail_out);
+                if ( Z_STREAM_END == rv ) {
+                    done = true;
+                    break;
+                } else if ( Z_OK != rv && Z_BUF_ERROR != rv ) {
+                    throw ::cc::Exception("Unable to inflate stream: %d!", rv);
+                } else if ( Z_BUF_ERROR == rv && 0 != zs.avail_out ) {
+                    break;
+                }
+            }
+        });
+        inflateEnd(&zs);
+    } catch (...) {
+        inflateEnd(&zs);
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+    
+    // ... predictor ...
+    int64_t predictor = 1, columns = 1, colors = 1, bpc = 8;
+    if ( nullptr != parms && Value::Type::Dictionary == parms->type() ) {
+        const Value* value;
+        if ( nullptr != ( value = parms->Get("Predictor") ) && Value::Type::Integer == value->type() ) {
+            predictor = value->integer();
+        }
+        if ( nullptr != ( value = parms->Get("Columns") ) && Value::Type::Integer == value->type() ) {
+            columns = value->integer();
+        }
+        if ( nullptr != ( value = parms->Get("Colors") ) && Value::Type::Integer == value->type() ) {
+            colors = value->integer();
+        }
+        if ( nullptr != ( value = parms->Get("BitsPerComponent") ) && Value::Type::Integer == value->type() ) {
+            bpc = value->integer();
+        }
+    }
+    if ( predictor <= 1 ) {
+        return;
+    } else if ( predictor < 10 || columns <= 0 || colors <= 0 || bpc <= 0 ) {
+        throw ::cc::Exception("Unsupported stream predictor " INT64_FMT "!", predictor);
+    }
+    const size_t bpp    = std::max(static_cast<size_t>(1), static_cast<size_t>(( colors * bpc ) / 8));
+    const size_t row    = static_cast<size_t>(( columns * colors * bpc + 7 ) / 8);
+    const size_t rows   = o_data.length() / ( row + 1 );
+    std::string  plain(rows * row, '\0');
+    std::string  prior(row, '\0');
+    for ( size_t r = 0 ; r < rows ; ++r ) {
+        const unsigned char  type = static_cast<unsigned char>(o_data[r * ( row + 1 )]);
+        const unsigned char* in   = reinterpret_cast<const unsigned char*>(o_data.data()) + r * ( row + 1 ) + 1;
+        unsigned char*       cur  = reinterpret_cast<unsigned char*>(&plain[r * row]);
+        const unsigned char* up   = reinterpret_cast<const unsigned char*>(prior.data());
+        for ( size_t idx = 0 ; idx < row ; ++idx ) {
+            const int left = ( idx >= bpp ? cur[idx - bpp] : 0 );
+            const int ul   = ( idx >= bpp ? up[idx - bpp]  : 0 );
+            int       v;
+            switch (type) {
+                case 0: v = in[idx];                                 break;
+                case 1: v = in[idx] + left;                          break;
+                case 2: v = in[idx] + up[idx];                       break;
+                case 3: v = in[idx] + ( ( left + up[idx] ) >> 1 );   break;
+                case 4:
+                {
+                    const int p  = left + up[idx] - ul;
+                    const int pa = abs(p - left), pb = abs(p - up[idx]), pc = abs(p - ul);
+                    v = in[idx] + ( ( pa <= pb && pa <= pc ) ? left : ( pb <= pc ? up[idx] : ul ) );
+                    break;
+                }
+                default:
+                    throw ::cc::Exception("Invalid PNG predictor %u!", static_cast<unsigned>(type));
+            }
+            cur[idx] = static_cast<unsigned char>(v & 0xFF);
+        }
+        prior.assign(reinterpret_cast<const char*>(cur), row);
+    }
+    o_data.swap(plain);
+}
+
+/**
+ * @brief Collect the numbers of the objects in use listed by a cross-reference section.
+ *
+ * @param a_section Section index, 0 is the newest - read if needed.
+ * @param a_limit   Maximum number of entries, larger sections are not listed.
+ * @param o_numbers Object numbers.
+ *
+ * @return True when section exists and it has no more than \link a_limit \link entries, false otherwise.
+ */
+bool casper::pdf::native::Parser::Objects (const size_t a_section, const size_t a_limit, std::vector<int64_t>& o_numbers)
+{
+    o_numbers.clear();
+    while ( a_section >= sections_.size() ) {
+        if ( false == ReadXRef() ) {
+            return false;
+        }
+    }
+    const Section& section = sections_[a_section];
+    size_t         count   = 0;
+    for ( auto& subsection : section.subsections_ ) {
+        count += static_cast<size_t>(subsection.count_);
+    }
+    if ( count > a_limit ) {
+        return false;
+    }
+    for ( auto& subsection : section.subsections_ ) {
+        if ( false == section.stream_ ) {
+            // ... one read per subsection ...
+            std::string entries;
+            Window(subsection.offset_, 20 * static_cast<size_t>(subsection.count_), entries);
+            for ( size_t idx = 0 ; idx + 20 <= entries.length() ; idx += 20 ) {
+                if ( 'n' == entries[idx + 17] ) {
+                    o_numbers.push_back(subsection.first_ + static_cast<int64_t>(idx / 20));
+                }
+            }
+        } else {
+            Entry entry;
+            for ( size_t idx = 0 ; idx < static_cast<size_t>(subsection.count_) ; ++idx ) {
+                ReadEntry(section, subsection, idx, entry);
+                if ( 1 == entry.type_ || 2 == entry.type_ ) {
+                    o_numbers.push_back(subsection.first_ + static_cast<int64_t>(idx));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Read the next ( older ) cross-reference section, sections are read newest first and only when needed.
+ *
+ * @return True when a section was read, false when there are no more sections.
+ */
+bool casper::pdf::native::Parser::ReadXRef ()
+{
+    if ( 0 == next_xref_ ) {
+        return false;
+    }
+    if ( visited_.size() >= sk_max_sections_ ) {
+        throw ::cc::Exception("Too many cross-reference sections - limit is " SIZET_FMT "!", sk_max_sections_);
+    }
+    const size_t offset = next_xref_;
+    next_xref_ = 0;
+    visited_.insert(offset);
+    
+    // ... table or stream?
+    std::string head;
+    Window(offset, 32, head);
+    Lexer        lexer(head.c_str(), head.length(), offset, /* a_complete */ true);
+    Lexer::Token token;
+    std::string  text;
+    (void)lexer.Next(token, text);
+    
+    Value trailer;
+    if ( Lexer::Token::Keyword == token && "xref" == text ) {
+        const size_t count = sections_.size();
+        ReadXRefTable(offset, trailer);
+        if ( count == sections_.size() ) {
+            throw ::cc::Exception("%s", "Invalid cross-reference table!");
+        }
+        if ( 1 == visited_.size() ) {
+            trailer_     = trailer;
+            xref_stream_ = false;
+        }
+        // ... hybrid-reference file?
+        const Value* stm = trailer.Get("XRefStm");
+        if ( nullptr != stm && Value::Type::Integer == stm->type() && 0 == visited_.count(static_cast<size_t>(stm->integer())) ) {
+            Value ignored;
+            ReadXRefStream(static_cast<size_t>(stm->integer()), ignored);
+        }
+    } else if ( Lexer::Token::Integer == token ) {
+        ReadXRefStream(offset, trailer);
+        if ( 1 == visited_.size() ) {
+            trailer_     = trailer;
+            xref_stream_ = true;
+        }
+    } else {
+        throw ::cc::Exception("Unable to find cross-reference section at offset " SIZET_FMT "!", offset);
+    }
+    
+    // ... previous section?
+    const Value* prev = trailer.Get("Prev");
+    if ( nullptr != prev && Value::Type::Integer == prev->type() && prev->integer() > 0
+         && static_cast<size_t>(prev->integer()) < size_ && 0 == visited_.count(static_cast<size_t>(prev->integer())) ) {
+        next_xref_ = static_cast<size_t>(prev->integer());
+    }
+    return true;
+}
+
+/**
+ * @brief Read a cross-reference table section subsections, entries are read on demand.
+ *
+ * @param a_offset  Offset of 'xref' keyword.
+ * @param o_trailer Section trailer dictionary.
+ */
+void casper::pdf::native::Parser::ReadXRefTable (const size_t a_offset, Value& o_trailer)
+{
+    Section section;
+    section.stream_ = false;
+    
+    std::string data;
+    size_t      position = a_offset + 4; // 'xref'
+    while ( true ) {
+        Window(position, 128, data);
+        Lexer        lexer(data.c_str(), data.length(), position, /* a_complete */ position + data.length() >= size_);
+        Lexer::Token token;
+        std::string  text;
+        if ( false == lexer.Next(token, text) ) {
+            throw ::cc::Exception("Invalid cross-reference table at offset " SIZET_FMT "!", position);
+        }
+        if ( Lexer::Token::Keyword == token && "trailer" == text ) {
+            ReadValue(lexer.offset(), o_trailer);
+            if ( Value::Type::Dictionary != o_trailer.type() ) {
+                throw ::cc::Exception("Invalid trailer at offset " SIZET_FMT "!", lexer.offset());
+            }
+            break;
+        }
+        std::string count;
+        if ( Lexer::Token::Integer != token || false == lexer.Next(token, count) || Lexer::Token::Integer != token || false == lexer.SkipWhitespace() ) {
+            throw ::cc::Exception("Invalid cross-reference subsection at offset " SIZET_FMT "!", position);
+        }
+        const Subsection subsection = { strtoll(text.c_str(), nullptr, 10), strtoll(count.c_str(), nullptr, 10), lexer.offset() };
+        if ( subsection.first_ < 0 || subsection.count_ < 0 ) {
+            throw ::cc::Exception("Invalid cross-reference subsection at offset " SIZET_FMT "!", position);
+        }
+        // ... entries must be exactly 20 bytes long ...
+        if ( subsection.count_ > 0 ) {
+            std::string entry;
+            Window(subsection.offset_, 20, entry);
+            if ( 20 != entry.length() || ' ' != entry[10] || ' ' != entry[16] || ( 'n' != entry[17] && 'f' != entry[17] ) ) {
+                throw ::cc::Exception("Invalid cross-reference entry at offset " SIZET_FMT "!", subsection.offset_);
+            }
+        }
+        section.subsections_.push_back(subsection);
+        position = subsection.offset_ + 20 * static_cast<size_t>(subsection.count_);
+    }
+    sections_.push_back(section);
+}
+
+/**
+ * @brief Read and decode a cross-reference stream.
+ *
+ * @param a_offset  Offset of the stream object.
+ * @param o_trailer Stream dictionary.
+ */
+void casper::pdf::native::Parser::ReadXRefStream (const size_t a_offset, Value& o_trailer)
+{
+    ReadObject(a_offset, /* a_number */ -1, o_trailer);
+    const Value* type = o_trailer.Get("Type");
+    const Value* w    = o_trailer.Get("W");
+    if (    Value::Type::Stream != o_trailer.type() || nullptr == type || "XRef" != type->token()
+         || nullptr == w || Value::Type::Array != w->type() || 3 != w->items().size() ) {
+        throw ::cc::Exception("Invalid cross-reference stream at offset " SIZET_FMT "!", a_offset);
+    }
+    Section section;
+    section.stream_ = true;
+    size_t row = 0;
+    for ( size_t idx = 0 ; idx < 3 ; ++idx ) {
+        const Value& item = w->items()[idx];
+        if ( Value::Type::Integer != item.type() || item.integer() < 0 || item.integer() > 8 ) {
+            throw ::cc::Exception("Invalid cross-reference stream /W at offset " SIZET_FMT "!", a_offset);
+        }
+        section.widths_[idx] = static_cast<size_t>(item.integer());
+        row                 += section.widths_[idx];
+    }
+    if ( 0 == row ) {
+        throw ::cc::Exception("Invalid cross-reference stream /W at offset " SIZET_FMT "!", a_offset);
+    }
+    // ... subsections ...
+    const Value* index = o_trailer.Get("Index");
+    const Value* size  = o_trailer.Get("Size");
+    if ( nullptr == size || Value::Type::Integer != size->type() || size->integer() < 0 ) {
+        throw ::cc::Exception("Invalid cross-reference stream /Size at offset " SIZET_FMT "!", a_offset);
+    }
+    size_t entries = 0;
+    if ( nullptr != index ) {
+        if ( Value::Type::Array != index->type() || 0 != ( index->items().size() % 2 ) ) {
+            throw ::cc::Exception("Invalid cross-reference stream /Index at offset " SIZET_FMT "!", a_offset);
+        }
+        for ( size_t idx = 0 ; idx < index->items().size() ; idx += 2 ) {
+            const Value& first = index->items()[idx];
+            const Value& count = index->items()[idx + 1];
+            // ... first + count <= /Size, written so that it can't overflow ...
+            if (    Value::Type::Integer != first.type() || Value::Type::Integer != count.type()
+                 || first.integer() < 0 || count.integer() < 0
+                 || first.integer() > size->integer() || count.integer() > size->integer() - first.integer() ) {
+                throw ::cc::Exception("Invalid cross-reference stream /Index at offset " SIZET_FMT "!", a_offset);
+            }
+            section.subsections_.push_back({ first.integer(), count.integer(), entries });
+            entries += static_cast<size_t>(count.integer());
+        }
+    } else {
+        section.subsections_.push_back({ 0, size->integer(), 0 });
+        entries = static_cast<size_t>(size->integer());
+    }
+    Decode(o_trailer, section.data_);
+    if ( section.data_.length() / row < entries ) {
+        throw ::cc::Exception("Invalid cross-reference stream data at offset " SIZET_FMT "!", a_offset);
+    }
+    sections_.push_back(section);
+}
+
+/**
+ * @brief Find an object cross-reference entry, newest section first, reading older sections only when needed.
+ *
+ * @param a_number Object number.
+ * @param o_entry  Entry.
+ *
+ * @return True when found, false otherwise.
+ */
+bool casper::pdf::native::Parser::Find (const int64_t a_number, Entry& o_entry)
+{
+    for ( size_t s = 0 ; s < sections_.size() || true == ReadXRef() ; ++s ) {
+        const Section& section = sections_[s];
+        for ( auto& subsection : section.subsections_ ) {
+            if ( a_number < subsection.first_ || a_number >= subsection.first_ + subsection.count_ ) {
+                continue;
+            }
+            ReadEntry(section, subsection, static_cast<size_t>(a_number - subsection.first_), o_entry);
+            if ( 1 == o_entry.type_ || 2 == o_entry.type_ ) {
+                return true;
+            }
+            // ... free or unknown, try older sections ...
+            break;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read a cross-reference entry.
+ *
+ * @param a_section    Section.
+ * @param a_subsection Subsection.
+ * @param a_index      Entry index in subsection.
+ * @param o_entry      Entry.
+ */
+void casper::pdf::native::Parser::ReadEntry (const Section& a_section, const Subsection& a_subsection, const size_t a_index, Entry& o_entry)
+{
+    if ( false == a_section.stream_ ) {
+        std::string entry;
+        Window(a_subsection.offset_ + 20 * a_index, 20, entry);
+        if ( 20 != entry.length() ) {
+            throw ::cc::Exception("Invalid cross-reference entry for object " INT64_FMT "!", a_subsection.first_ + static_cast<int64_t>(a_index));
+        }
+        o_entry.type_   = ( 'n' == entry[17] ? 1 : 0 );
+        o_entry.field2_ = strtoull(entry.substr(0, 10).c_str(), nullptr, 10);
+        o_entry.field3_ = strtoull(entry.substr(11, 5).c_str(), nullptr, 10);
+    } else {
+        const size_t row = a_section.widths_[0] + a_section.widths_[1] + a_section.widths_[2];
+        // ... never read past decoded data, whatever subsections say ...
+        if (    static_cast<uint64_t>(a_index) >= static_cast<uint64_t>(a_subsection.count_)
+             || a_subsection.offset_ + a_index >= a_section.data_.length() / row ) {
+            throw ::cc::Exception("Invalid cross-reference entry for object " INT64_FMT "!", a_subsection.first_ + static_cast<int64_t>(a_index));
+        }
+        const unsigned char* bytes     = reinterpret_cast<const unsigned char*>(a_section.data_.data()) + ( a_subsection.offset_ + a_index ) * row;
+        uint64_t             fields[3] = { 1, 0, 0 };
+        for ( size_t f = 0 ; f < 3 ; ++f ) {
+            if ( 0 == a_section.widths_[f] ) {
+                continue;
+            }
+            fields[f] = 0;
+            for ( size_t b = 0 ; b < a_section.widths_[f] ; ++b ) {
+                fields[f] = ( fields[f] << 8 ) | *bytes++;
+            }
+        }
+        o_entry.type_   = static_cast<uint8_t>(fields[0]);
+        o_entry.field2_ = fields[1];
+        o_entry.field3_ = fields[2];
+    }
+}
+
+/**
+ * @brief Parse a direct object, growing the window until it fits.
+ *
+ * @param a_offset Object offset.
+ * @param o_value  Object value.
+ */
+void casper::pdf::native::Parser::ReadValue (const size_t a_offset, Value& o_value)
+{
+    std::string data;
+    for ( size_t window = sk_window_ ; ; window *= 4 ) {
+        Window(a_offset, window, data);
+        const bool complete = ( a_offset + data.length() >= size_ );
+        Lexer      lexer(data.c_str(), data.length(), a_offset, complete);
+        if ( true == lexer.Parse(o_value) ) {
+            return;
+        }
+        if ( true == complete || window >= sk_max_window_ ) {
+            throw ::cc::Exception("Unable to parse object at offset " SIZET_FMT "!", a_offset);
+        }
+    }
+}
+
+/**
+ * @brief Parse an indirect object, growing the window until it fits - stream data is not read.
+ *
+ * @param a_offset Object offset.
+ * @param a_number Expected object number, -1 to accept any.
+ * @param o_value  Object value.
+ */
+void casper::pdf::native::Parser::ReadObject (const size_t a_offset, const int64_t a_number, Value& o_value)
+{
+    std::string data;
+    for ( size_t window = sk_window_ ; ; window *= 4 ) {
+        Window(a_offset, window, data);
+        const bool   complete = ( a_offset + data.length() >= size_ );
+        Lexer        lexer(data.c_str(), data.length(), a_offset, complete);
+        Lexer::Token token;
+        std::string  number, generation, keyword;
+        bool         ok = (    true == lexer.Next(token, number)     && Lexer::Token::Integer == token
+                            && true == lexer.Next(token, generation) && Lexer::Token::Integer == token
+                            && true == lexer.Next(token, keyword) );
+        if ( true == ok && ( Lexer::Token::Keyword != token || "obj" != keyword || ( -1 != a_number && strtoll(number.c_str(), nullptr, 10) != a_number ) ) ) {
+            throw ::cc::Exception("Object " INT64_FMT " not found at offset " SIZET_FMT "!", a_number, a_offset);
+        }
+        bool stream = false;
+        ok = ok && lexer.Parse(o_value) && lexer.Expect("stream", stream);
+        if ( true == ok && true == stream ) {
+            // ... data starts after EOL ...
+            size_t position = lexer.position();
+            if ( position < data.length() && '\r' == data[position] ) {
+                position++;
+            }
+            if ( position < data.length() && '\n' == data[position] ) {
+                position++;
+            }
+            if ( position >= data.length() && false == complete ) {
+                ok = false;
+            } else {
+                o_value.MakeStream(a_offset + position);
+            }
+        }
+        if ( true == ok ) {
+            return;
+        }
+        if ( true == complete || window >= sk_max_window_ ) {
+            throw ::cc::Exception("Unable to parse object " INT64_FMT " at offset " SIZET_FMT "!", a_number, a_offset);
+        }
+    }
+}
+
+/**
+ * @brief Load an object from an object stream.
+ *
+ * @param a_stream Object stream number.
+ * @param a_index  Object index in object stream.
+ * @param a_number Object number.
+ * @param o_value  Object value.
+ */
+void casper::pdf::native::Parser::ReadCompressed (const int64_t a_stream, const size_t a_index, const int64_t a_number, Value& o_value)
+{
+    if ( a_stream != object_stream_ ) {
+        // ... object streams can't be stored in object streams, nor depend on themselves ( e.g. /Length ) to be loaded ...
+        Entry entry;
+        if ( false == Find(a_stream, entry) || 1 != entry.type_ ) {
+            throw ::cc::Exception("Invalid object stream " INT64_FMT " xref entry!", a_stream);
+        }
+        if ( 0 != loading_.count(a_stream) ) {
+            throw ::cc::Exception("Object stream " INT64_FMT " references itself!", a_stream);
+        }
+        loading_.insert(a_stream);
+        try {
+            Value stream;
+            ReadObject(static_cast<size_t>(entry.field2_), a_stream, stream);
+            const Value* type  = stream.Get("Type");
+            const Value* n     = stream.Get("N");
+            const Value* first = stream.Get("First");
+            if (    Value::Type::Stream != stream.type() || nullptr == type || "ObjStm" != type->token()
+                 || nullptr == n || Value::Type::Integer != n->type() || nullptr == first || Value::Type::Integer != first->type() ) {
+                throw ::cc::Exception("Invalid object stream " INT64_FMT "!", a_stream);
+            }
+            // ... decoding may load other objects, cache is only replaced when done ...
+            std::string                             data;
+            std::vector<std::pair<int64_t, size_t>> offsets;
+            Decode(stream, data);
+            Lexer        lexer(data.c_str(), data.length(), 0, /* a_complete */ true);
+            Lexer::Token token;
+            std::string  number, offset;
+            for ( int64_t idx = 0 ; idx < n->integer() ; ++idx ) {
+                if (    false == lexer.Next(token, number) || Lexer::Token::Integer != token
+                     || false == lexer.Next(token, offset) || Lexer::Token::Integer != token ) {
+                    throw ::cc::Exception("Invalid object stream " INT64_FMT " header!", a_stream);
+                }
+                offsets.push_back({ strtoll(number.c_str(), nullptr, 10),
+                                    static_cast<size_t>(first->integer()) + static_cast<size_t>(strtoull(offset.c_str(), nullptr, 10)) });
+            }
+            object_stream_data_.swap(data);
+            object_stream_offsets_.swap(offsets);
+            object_stream_ = a_stream;
+        } catch (...) {
+            loading_.erase(a_stream);
+            throw;
+        }
+        loading_.erase(a_stream);
+    }
+    // ... index is a hint ...
+    size_t offset = std::string::npos;
+    if ( a_index < object_stream_offsets_.size() && a_number == object_stream_offsets_[a_index].first ) {
+        offset = object_stream_offsets_[a_index].second;
+    } else {
+        for ( auto& it : object_stream_offsets_ ) {
+            if ( a_number == it.first ) {
+                offset = it.second;
+                break;
+            }
+        }
+    }
+    if ( std::string::npos == offset || offset >= object_stream_data_.length() ) {
+        throw ::cc::Exception("Object " INT64_FMT " not found in object stream " INT64_FMT "!", a_number, a_stream);
+    }
+    Lexer lexer(object_stream_data_.c_str() + offset, object_stream_data_.length() - offset, 0, /* a_complete */ true);
+    (void)lexer.Parse(o_value);
+}
+
+/**
+ * @brief Read a window of the document.
+ *
+ * @param a_offset Window offset.
+ * @param a_length Window length, clamped to document size.
+ * @param o_data   Window bytes.
+ */
+void casper::pdf::native::Parser::Window (const size_t a_offset, const size_t a_length, std::string& o_data)
+{
+    const size_t length = ( a_offset >= size_ ? 0 : std::min(a_length, size_ - a_offset) );
+    o_data.resize(length);
+    if ( length > 0 ) {
+        file_->Read(a_offset, reinterpret_cast<unsigned char*>(&o_data[0]), length);
+    }
+}
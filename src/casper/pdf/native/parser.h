@@ -0,0 +1,178 @@
+/**
+ * @file parser.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_NATIVE_PARSER_H_
+#define CASPER_PDF_NATIVE_PARSER_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "casper/io/file.h"
+
+#include "casper/pdf/native/value.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace native
+        {
+        
+            /**
+             * @brief A PDF parser that only reads what it's asked for.
+             *
+             *        Opening a document reads the trailer and the newest cross-reference section ( table or stream ),
+             *        older sections are read only when an object is not found in newer ones and table entries are
+             *        read on demand; objects are loaded by number, on demand, from the document
+             *        or from object streams. Memory usage doesn't depend on the document size.
+             */
+            class Parser final : public ::cc::NonCopyable, public ::cc::NonMovable
+            {
+                
+            private: // Data Type(s)
+                
+                typedef struct {
+                    int64_t first_;  //!< First object number.
+                    int64_t count_;  //!< Number of entries.
+                    size_t  offset_; //!< Table: document offset of the first entry; Stream: index of the first entry.
+                } Subsection;
+                
+                typedef struct {
+                    bool                    stream_;      //!< True for cross-reference streams.
+                    std::vector<Subsection> subsections_;
+                    std::string             data_;        //!< Cross-reference stream decoded data.
+                    size_t                  widths_[3];   //!< Cross-reference stream field widths.
+                } Section;
+                
+                typedef struct {
+                    uint8_t  type_;   //!< 0 - free, 1 - in use, 2 - compressed.
+                    uint64_t field2_; //!< Offset or object stream number.
+                    uint64_t field3_; //!< Generation or index in object stream.
+                } Entry;
+                
+            private: // Static Const Data
+                
+                static const size_t sk_window_;
+                static const size_t sk_max_window_;
+                static const size_t sk_max_sections_;
+                static const size_t sk_max_decoded_;
+                static const size_t sk_max_inflate_ratio_;
+                
+            private: // Const Data
+                
+                const io::File::Settings settings_;
+                
+            private: // Data
+                
+                io::File*                                file_;
+                size_t                                   size_;
+                size_t                                   startxref_;
+                bool                                     xref_stream_;
+                Value                                    trailer_;
+                std::vector<Section>                     sections_;              //!< Newest first.
+                size_t                                   next_xref_;             //!< Offset of the next section to read, 0 if none.
+                std::set<size_t>                         visited_;               //!< Offsets of the sections already read.
+                std::set<int64_t>                        loading_;               //!< Numbers of the object streams being loaded.
+                int64_t                                  object_stream_;         //!< Number of the cached object stream, -1 if none.
+                std::string                              object_stream_data_;    //!< Cached object stream decoded data.
+                std::vector<std::pair<int64_t, size_t>>  object_stream_offsets_; //!< Cached object stream objects numbers and offsets.
+                
+            public: // Constructor(s) / Destructor
+                
+                Parser () = delete;
+                Parser (const io::File::Settings& a_settings);
+                
+                virtual ~Parser ();
+                
+            public: // Method(s) / Function(s)
+                
+                void Open    (const std::string& a_uri);
+                void Close   ();
+                void Load    (const int64_t a_number, Value& o_value);
+                void Resolve (const Value& a_value, Value& o_value);
+                void Decode  (const Value& a_stream, std::string& o_data);
+                bool Objects (const size_t a_section, const size_t a_limit, std::vector<int64_t>& o_numbers);
+                
+            public: // Inline Method(s) / Function(s)
+                
+                size_t       size        () const;
+                size_t       startxref   () const;
+                bool         xref_stream () const;
+                const Value& trailer     () const;
+                
+            private: // Method(s) / Function(s)
+                
+                bool ReadXRef       ();
+                void ReadXRefTable  (const size_t a_offset, Value& o_trailer);
+                void ReadXRefStream (const size_t a_offset, Value& o_trailer);
+                bool Find           (const int64_t a_number, Entry& o_entry);
+                void ReadEntry      (const Section& a_section, const Subsection& a_subsection, const size_t a_index, Entry& o_entry);
+                void ReadValue      (const size_t a_offset, Value& o_value);
+                void ReadObject     (const size_t a_offset, const int64_t a_number, Value& o_value);
+                void ReadCompressed (const int64_t a_stream, const size_t a_index, const int64_t a_number, Value& o_value);
+                void Window         (const size_t a_offset, const size_t a_length, std::string& o_data);
+                
+            }; // end of class 'Parser'
+        
+            /**
+             * @return Document size, in bytes.
+             */
+            inline size_t Parser::size () const
+            {
+                return size_;
+            }
+        
+            /**
+             * @return Offset of the last cross-reference section.
+             */
+            inline size_t Parser::startxref () const
+            {
+                return startxref_;
+            }
+        
+            /**
+             * @return True when the last cross-reference section is a stream.
+             */
+            inline bool Parser::xref_stream () const
+            {
+                return xref_stream_;
+            }
+        
+            /**
+             * @return R/O access to the last trailer ( or cross-reference stream ) dictionary.
+             */
+            inline const Value& Parser::trailer () const
+            {
+                return trailer_;
+            }
+        
+        } // end of namespace 'native'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_NATIVE_PARSER_H_
@@ -0,0 +1,351 @@
+/**
+ * @file reader.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/reader.h"
+
+#include "cc/exception.h"
+#include "cc/types.h"
+
+#include <set>
+#include <vector>
+
+const char* const casper::pdf::native::Reader::sk_byte_range_err_msg_prefix_ = "Unable to obtain /Sig/ByteRange";
+const size_t      casper::pdf::native::Reader::sk_max_objects_              = 1024;
+const size_t      casper::pdf::native::Reader::sk_max_tree_depth_           = 64;
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_settings I/O settings to use when reading the document.
+ */
+casper::pdf::native::Reader::Reader (const io::File::Settings& a_settings)
+ : parser_(a_settings)
+{
+    open_    = false;
+    invalid_ = false;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::native::Reader::~Reader ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from pdf::Reader
+
+/**
+ * @brief Open a PDF document in read only mode, reading only it's trailer and newest cross-reference section.
+ *
+ * @param a_uri Local file URI.
+ */
+void casper::pdf::native::Reader::Open (const std::string& a_uri)
+{
+    if ( true == open_ ) {
+        throw ::cc::Exception("Can't load '%s', already in use ( close it first! )", a_uri.c_str());
+    }
+    parser_.Open(a_uri);
+    open_ = true;
+}
+
+/**
+ * @brief Not supported, documents already in memory are handled by qpdf::Reader.
+ */
+void casper::pdf::native::Reader::Open (const unsigned char* /* a_bytes */, const size_t /* a_size */)
+{
+    throw ::cc::Exception("%s", "Can't load document from memory - not supported!");
+}
+
+/**
+ * @brief Search for the signature field, in the newest cross-reference sections only, and read it's /ByteRange.
+ *
+ * @param a_page       Page number, if set the signature widget must be in that page, 0 or -1 for any page.
+ * @param a_annotation Annotation to look for and where byte range will be set.
+ *
+ * @return True if found, false when not found in the newest sections ( it might still exist ) or when it's page can't be confirmed.
+ *
+ * @throw When found but it's /ByteRange is not valid, \link invalid \link will then return true - this is conclusive.
+ */
+bool casper::pdf::native::Reader::GetByteRange (const ssize_t a_page, pdf::SignatureAnnotation& a_annotation)
+{
+    if ( false == open_ ) {
+        throw ::cc::Exception("%s", "Can't read byte range - document is not open!");
+    }
+    
+    std::set<int64_t>    seen;
+    std::vector<int64_t> numbers;
+    size_t               budget = sk_max_objects_;
+    
+    invalid_ = false;
+    
+    // ... newest section first, until budget is exhausted ...
+    for ( size_t section = 0 ; budget > 0 && true == parser_.Objects(section, budget, numbers) ; ++section ) {
+        budget -= numbers.size();
+        for ( auto number : numbers ) {
+            // ... already listed by a newer section?
+            if ( false == seen.insert(number).second ) {
+                continue;
+            }
+            Value object;
+            parser_.Load(number, object);
+            if ( Value::Type::Dictionary != object.type() || nullptr == object.Get("T") ) {
+                continue;
+            }
+            // ... check if it's the field we're looking for ...
+            std::string name;
+            std::string type;
+            if ( false == FieldName(object, name, type) || "Sig" != type || a_annotation.name_ != name ) {
+                continue;
+            }
+            // ... in the requested page?
+            if ( a_page > 0 ) {
+                size_t page = 0;
+                if ( false == PageNumber(number, object, page) || static_cast<size_t>(a_page) != page ) {
+                    return false;
+                }
+            }
+            // ... load range ...
+            Value        signature;
+            const Value* value = object.Get("V");
+            if ( nullptr != value ) {
+                parser_.Resolve(*value, signature);
+            }
+            const Value* byte_range = ( Value::Type::Dictionary == signature.type() ? signature.Get("ByteRange") : nullptr );
+            if ( nullptr == byte_range || Value::Type::Array != byte_range->type() || 4 != byte_range->items().size() ) {
+                invalid_ = true;
+                throw ::cc::Exception("%s - found but it's not a valid array!", sk_byte_range_err_msg_prefix_);
+            }
+            pdf::SignatureAnnotation::ByteRange range;
+            size_t                              idx = 0;
+            for ( auto v : { &range.before_start_, &range.before_size_, &range.after_start_, &range.after_size_ } ) {
+                Value item;
+                parser_.Resolve(byte_range->items()[idx++], item);
+                if ( Value::Type::Integer != item.type() || item.integer() < 0 ) {
+                    invalid_ = true;
+                    throw ::cc::Exception("%s - found but it's not a valid array!", sk_byte_range_err_msg_prefix_);
+                }
+                (*v) = static_cast<size_t>(item.integer());
+            }
+            // ... set range ...
+            a_annotation.Set(range);
+            // ... found ...
+            return true;
+        }
+    }
+    
+    // ... not conclusive ...
+    return false;
+}
+
+/**
+ * @brief Read page count.
+ *
+ * @return Number of page of the currently loaded PDF document.
+ */
+size_t casper::pdf::native::Reader::PageCount ()
+{
+    if ( false == open_ ) {
+        throw ::cc::Exception("%s", "Can't read page count - document is not open!");
+    }
+    
+    Value catalog;
+    Value pages;
+    Value count;
+    parser_.Resolve(*parser_.trailer().Get("Root"), catalog);
+    if ( Value::Type::Dictionary == catalog.type() && nullptr != catalog.Get("Pages") ) {
+        parser_.Resolve(*catalog.Get("Pages"), pages);
+    }
+    if ( Value::Type::Dictionary == pages.type() && nullptr != pages.Get("Count") ) {
+        parser_.Resolve(*pages.Get("Count"), count);
+    }
+    if ( Value::Type::Integer != count.type() || count.integer() < 0 ) {
+        throw ::cc::Exception("%s", "Can't find /Pages/Count object!");
+    }
+    
+    return static_cast<size_t>(count.integer());
+}
+
+/**
+ * @brief Close the currenly open file.
+ */
+void casper::pdf::native::Reader::Close ()
+{
+    parser_.Close();
+    open_ = false;
+}
+
+// MARK: - [PRIVATE] - Method(s) / Function(s)
+
+/**
+ * @brief Calculate a field fully qualified name and ( inheritable ) type.
+ *
+ * @param a_field Field dictionary.
+ * @param o_name  Fully qualified name.
+ * @param o_type  Field type, without '/', empty if not set.
+ *
+ * @return True on success, false if field hierarchy is too deep.
+ */
+bool casper::pdf::native::Reader::FieldName (const Value& a_field, std::string& o_name, std::string& o_type)
+{
+    o_name.clear();
+    o_type.clear();
+    
+    Value node = a_field;
+    for ( size_t depth = 0 ; depth < sk_max_tree_depth_ ; ++depth ) {
+        const Value* t = node.Get("T");
+        if ( nullptr != t && Value::Type::String == t->type() ) {
+            o_name = ( true == o_name.empty() ? t->Text() : t->Text() + "." + o_name );
+        }
+        const Value* ft = node.Get("FT");
+        if ( true == o_type.empty() && nullptr != ft && Value::Type::Name == ft->type() ) {
+            o_type = ft->token();
+        }
+        // ... parent?
+        const Value* parent = node.Get("Parent");
+        if ( nullptr == parent || Value::Type::Reference != parent->type() ) {
+            return true;
+        }
+        Value next;
+        parser_.Load(parent->integer(), next);
+        if ( Value::Type::Dictionary != next.type() ) {
+            return false;
+        }
+        node = next;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Calculate the number of the page where a field widget is.
+ *
+ * @param a_number Field object number.
+ * @param a_field  Field dictionary, merged with it's widget or with widgets as /Kids.
+ * @param o_page   Page number, 1..n.
+ *
+ * @return True on success, false if it's inconclusive: widget /P is missing, that page doesn't list the widget
+ *         in it's /Annots or page number can't be calculated without reading too many objects.
+ */
+bool casper::pdf::native::Reader::PageNumber (const int64_t a_number, const Value& a_field, size_t& o_page)
+{
+    // ... widget, merged with field or it's first kid ...
+    Value   widget        = a_field;
+    int64_t widget_number = a_number;
+    if ( nullptr == widget.Get("P") ) {
+        const Value* kids = a_field.Get("Kids");
+        if ( nullptr == kids || Value::Type::Array != kids->type() || true == kids->items().empty() || Value::Type::Reference != kids->items()[0].type() ) {
+            return false;
+        }
+        widget_number = kids->items()[0].integer();
+        parser_.Load(widget_number, widget);
+    }
+    const Value* p = widget.Get("P");
+    if ( nullptr == p || Value::Type::Reference != p->type() ) {
+        return false;
+    }
+    
+    // ... /P is optional and not always right, trust it only if that page lists the widget in it's /Annots ...
+    int64_t node   = p->integer();
+    size_t  index  = 0;
+    size_t  budget = sk_max_objects_;
+    Value   current;
+    parser_.Load(node, current);
+    {
+        Value        annots;
+        const Value* value = ( Value::Type::Dictionary == current.type() ? current.Get("Annots") : nullptr );
+        if ( nullptr == value ) {
+            return false;
+        }
+        parser_.Resolve(*value, annots);
+        if ( Value::Type::Array != annots.type() ) {
+            return false;
+        }
+        bool listed = false;
+        for ( auto& annot : annots.items() ) {
+            if ( Value::Type::Reference == annot.type() && widget_number == annot.integer() ) {
+                listed = true;
+                break;
+            }
+        }
+        if ( false == listed ) {
+            return false;
+        }
+    }
+    
+    // ... walk up the page tree, counting pages before each node ...
+    for ( size_t depth = 0 ; depth < sk_max_tree_depth_ ; ++depth ) {
+        if ( Value::Type::Dictionary != current.type() ) {
+            return false;
+        }
+        const Value* parent = current.Get("Parent");
+        if ( nullptr == parent ) {
+            o_page = index + 1;
+            return true;
+        }
+        if ( Value::Type::Reference != parent->type() ) {
+            return false;
+        }
+        Value pages;
+        parser_.Load(parent->integer(), pages);
+        const Value* kids = pages.Get("Kids");
+        if ( Value::Type::Dictionary != pages.type() || nullptr == kids || Value::Type::Array != kids->type() ) {
+            return false;
+        }
+        bool found = false;
+        for ( auto& kid : kids->items() ) {
+            if ( Value::Type::Reference != kid.type() ) {
+                return false;
+            }
+            if ( node == kid.integer() ) {
+                found = true;
+                break;
+            }
+            if ( 0 == budget ) {
+                return false;
+            }
+            --budget;
+            Value sibling;
+            parser_.Load(kid.integer(), sibling);
+            const Value* type  = sibling.Get("Type");
+            const Value* count = sibling.Get("Count");
+            if ( Value::Type::Dictionary != sibling.type() ) {
+                return false;
+            } else if ( nullptr != type && "Pages" == type->token() ) {
+                if ( nullptr == count || Value::Type::Integer != count->type() || count->integer() < 0 ) {
+                    return false;
+                }
+                index += static_cast<size_t>(count->integer());
+            } else {
+                index += 1;
+            }
+        }
+        if ( false == found ) {
+            return false;
+        }
+        node    = parent->integer();
+        current = pages;
+    }
+    
+    return false;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file reader.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_NATIVE_READER_H_
+#define CASPER_PDF_NATIVE_READER_H_
+
+#include "casper/pdf/reader.h"
+
+#include "casper/pdf/annotation.h"
+
+#include <inttypes.h>
+#include <string>
+
+#include "casper/io/file.h"
+
+#include "casper/pdf/native/parser.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace native
+        {
+        
+            /**
+             * @brief A signature /ByteRange locator that reads the document backwards from it's end.
+             *
+             *        Only the objects listed by the newest cross-reference sections are searched, so the cost depends on
+             *        the size of the last incremental updates and not on the document size; a signature that is not found
+             *        there is reported as not found - callers should fall back to qpdf::Reader, that searches all pages.
+             */
+            class Reader final : public ::casper::pdf::Reader
+            {
+                
+            private: // Static Const Data
+                
+                static const char* const sk_byte_range_err_msg_prefix_;
+                static const size_t      sk_max_objects_;
+                static const size_t      sk_max_tree_depth_;
+                
+            private: // Data
+                
+                Parser parser_;
+                bool   open_;
+                bool   invalid_; //!< True when the last \link GetByteRange \link call found the field but not a valid /ByteRange.
+                
+            public: // Constructor(s) / Destructor
+                
+                Reader () = delete;
+                Reader (const io::File::Settings& a_settings);
+                
+                virtual ~Reader ();
+                
+            public: // Inherited Method(s) / Function(s) from pdf::Reader
+                
+                virtual void   Open         (const std::string& a_uri);
+                virtual void   Open         (const unsigned char* a_bytes, const size_t a_size);
+                virtual bool   GetByteRange (const ssize_t a_page, pdf::SignatureAnnotation& a_annotation);
+                virtual size_t PageCount    ();
+                virtual void   Close        ();
+                
+            public: // Inline Method(s) / Function(s)
+                
+                bool invalid () const;
+                
+            private: // Method(s) / Function(s)
+                
+                bool FieldName  (const Value& a_field, std::string& o_name, std::string& o_type);
+                bool PageNumber (const int64_t a_number, const Value& a_field, size_t& o_page);
+                
+            }; // end of class 'Reader'
+        
+            /**
+             * @return True when the last \link GetByteRange \link call found the field but it's /ByteRange is not valid.
+             */
+            inline bool Reader::invalid () const
+            {
+                return invalid_;
+            }
+        
+        } // end of namespace 'native'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_NATIVE_READER_H_
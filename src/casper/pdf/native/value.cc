@@ -0,0 +1,466 @@
+/**
+ * @file value.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/value.h"
+
+#include "cc/exception.h"
+#include "cc/types.h" // SIZET_FMT
+
+#include <stdlib.h> // strtod
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor, a null value.
+ */
+casper::pdf::native::Value::Value ()
+{
+    type_       = Type::Null;
+    integer_    = 0;
+    generation_ = 0;
+    offset_     = 0;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::native::Value::~Value ()
+{
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Static Method(s) / Function(s)
+
+/**
+ * @return A boolean value.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Boolean (const bool a_value)
+{
+    Value value;
+    value.type_  = Type::Boolean;
+    value.token_ = ( true == a_value ? "true" : "false" );
+    return value;
+}
+
+/**
+ * @return An integer value.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Integer (const int64_t a_value)
+{
+    Value value;
+    value.type_    = Type::Integer;
+    value.integer_ = a_value;
+    value.token_   = std::to_string(a_value);
+    return value;
+}
+
+/**
+ * @return A real value, from it's token.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Real (const std::string& a_token)
+{
+    Value value;
+    value.type_  = Type::Real;
+    value.token_ = a_token;
+    return value;
+}
+
+/**
+ * @return A string value, from it's token ( including delimiters ).
+ */
+casper::pdf::native::Value casper::pdf::native::Value::String (const std::string& a_token)
+{
+    Value value;
+    value.type_  = Type::String;
+    value.token_ = a_token;
+    return value;
+}
+
+/**
+ * @brief Encode an UTF-8 text as PDF text string: literal when ASCII, UTF-16BE otherwise.
+ *
+ * @param a_text UTF-8 text.
+ *
+ * @return A string value.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Literal (const std::string& a_text)
+{
+    bool ascii = true;
+    for ( const auto c : a_text ) {
+        if ( 0 != ( static_cast<unsigned char>(c) & 0x80 ) ) {
+            ascii = false;
+            break;
+        }
+    }
+    std::string token;
+    if ( true == ascii ) {
+        token = "(";
+        for ( const auto c : a_text ) {
+            if ( '(' == c || ')' == c || '\\' == c ) {
+                token += '\\';
+            } else if ( '\r' == c ) {
+                token += "\\r";
+                continue;
+            }
+            token += c;
+        }
+        token += ")";
+    } else {
+        static const char* const sk_hex = "0123456789ABCDEF";
+        const auto unit = [&token] (const uint32_t a_unit) {
+            token += sk_hex[( a_unit >> 12 ) & 0xF];
+            token += sk_hex[( a_unit >>  8 ) & 0xF];
+            token += sk_hex[( a_unit >>  4 ) & 0xF];
+            token += sk_hex[( a_unit       ) & 0xF];
+        };
+        token = "<FEFF";
+        for ( size_t idx = 0 ; idx < a_text.length() ; ) {
+            const unsigned char c  = static_cast<unsigned char>(a_text[idx]);
+            uint32_t            cp = 0;
+            size_t              n  = 0;
+            if ( c < 0x80 ) {
+                cp = c; n = 1;
+            } else if ( 0xC0 == ( c & 0xE0 ) ) {
+                cp = c & 0x1F; n = 2;
+            } else if ( 0xE0 == ( c & 0xF0 ) ) {
+                cp = c & 0x0F; n = 3;
+            } else if ( 0xF0 == ( c & 0xF8 ) ) {
+                cp = c & 0x07; n = 4;
+            } else {
+                throw ::cc::Exception("Invalid UTF-8 sequence at position " SIZET_FMT "!", idx);
+            }
+            if ( idx + n > a_text.length() ) {
+                throw ::cc::Exception("Invalid UTF-8 sequence at position " SIZET_FMT "!", idx);
+            }
+            for ( size_t k = 1 ; k < n ; ++k ) {
+                cp = ( cp << 6 ) | ( static_cast<unsigned char>(a_text[idx + k]) & 0x3F );
+            }
+            if ( cp >= 0x10000 ) {
+                cp -= 0x10000;
+                unit(0xD800 + ( cp >> 10 ));
+                unit(0xDC00 + ( cp & 0x3FF ));
+            } else {
+                unit(cp);
+            }
+            idx += n;
+        }
+        token += ">";
+    }
+    return String(token);
+}
+
+/**
+ * @return A name value, without '/'.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Name (const std::string& a_name)
+{
+    Value value;
+    value.type_  = Type::Name;
+    value.token_ = a_name;
+    return value;
+}
+
+/**
+ * @return An empty array.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Array ()
+{
+    Value value;
+    value.type_ = Type::Array;
+    return value;
+}
+
+/**
+ * @return An empty dictionary.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Dictionary ()
+{
+    Value value;
+    value.type_ = Type::Dictionary;
+    return value;
+}
+
+/**
+ * @return An indirect object reference.
+ */
+casper::pdf::native::Value casper::pdf::native::Value::Reference (const int64_t a_number, const uint32_t a_generation)
+{
+    Value value;
+    value.type_       = Type::Reference;
+    value.integer_    = a_number;
+    value.generation_ = a_generation;
+    return value;
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Get a dictionary ( or stream dictionary ) entry.
+ *
+ * @param a_key Name, without '/'.
+ *
+ * @return Entry value, nullptr if not found.
+ */
+const casper::pdf::native::Value* casper::pdf::native::Value::Get (const std::string& a_key) const
+{
+    for ( size_t idx = 0 ; idx < keys_.size() ; ++idx ) {
+        if ( keys_[idx] == a_key ) {
+            return &items_[idx];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Set a dictionary entry, replacing existing one in place.
+ *
+ * @param a_key   Name, without '/'.
+ * @param a_value Entry value.
+ */
+void casper::pdf::native::Value::Set (const std::string& a_key, const Value& a_value)
+{
+    if ( Type::Dictionary != type_ && Type::Stream != type_ ) {
+        throw ::cc::Exception("Unable to set '%s' - value is not a dictionary!", a_key.c_str());
+    }
+    for ( size_t idx = 0 ; idx < keys_.size() ; ++idx ) {
+        if ( keys_[idx] == a_key ) {
+            items_[idx] = a_value;
+            return;
+        }
+    }
+    keys_.push_back(a_key);
+    items_.push_back(a_value);
+}
+
+/**
+ * @brief Remove a dictionary entry.
+ *
+ * @param a_key Name, without '/'.
+ */
+void casper::pdf::native::Value::Remove (const std::string& a_key)
+{
+    for ( size_t idx = 0 ; idx < keys_.size() ; ++idx ) {
+        if ( keys_[idx] == a_key ) {
+            keys_.erase(keys_.begin() + static_cast<long>(idx));
+            items_.erase(items_.begin() + static_cast<long>(idx));
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Append an array item.
+ *
+ * @param a_value Item value.
+ */
+void casper::pdf::native::Value::Add (const Value& a_value)
+{
+    if ( Type::Array != type_ ) {
+        throw ::cc::Exception("%s", "Unable to add item - value is not an array!");
+    }
+    items_.push_back(a_value);
+}
+
+/**
+ * @brief Turn a dictionary into a stream dictionary.
+ *
+ * @param a_offset Stream data offset.
+ */
+void casper::pdf::native::Value::MakeStream (const size_t a_offset)
+{
+    if ( Type::Dictionary != type_ ) {
+        throw ::cc::Exception("%s", "Unable to make stream - value is not a dictionary!");
+    }
+    type_   = Type::Stream;
+    offset_ = a_offset;
+}
+
+/**
+ * @return True if value is an integer or a real.
+ */
+bool casper::pdf::native::Value::IsNumber () const
+{
+    return ( Type::Integer == type_ || Type::Real == type_ );
+}
+
+/**
+ * @return Numeric value.
+ */
+double casper::pdf::native::Value::Number () const
+{
+    if ( Type::Integer == type_ ) {
+        return static_cast<double>(integer_);
+    } else if ( Type::Real == type_ ) {
+        return strtod(token_.c_str(), nullptr);
+    }
+    throw ::cc::Exception("%s", "Value is not a number!");
+}
+
+/**
+ * @return String value bytes, escapes and hex decoded, UTF-16BE text converted to UTF-8.
+ */
+std::string casper::pdf::native::Value::Text () const
+{
+    if ( Type::String != type_ || token_.length() < 2 ) {
+        throw ::cc::Exception("%s", "Value is not a string!");
+    }
+    std::string bytes;
+    if ( '<' == token_[0] ) {
+        int hi = -1;
+        for ( size_t idx = 1 ; idx < token_.length() - 1 ; ++idx ) {
+            const char c = token_[idx];
+            int        v;
+            if ( c >= '0' && c <= '9' ) {
+                v = c - '0';
+            } else if ( c >= 'a' && c <= 'f' ) {
+                v = c - 'a' + 10;
+            } else if ( c >= 'A' && c <= 'F' ) {
+                v = c - 'A' + 10;
+            } else {
+                continue;
+            }
+            if ( -1 == hi ) {
+                hi = v;
+            } else {
+                bytes += static_cast<char>(( hi << 4 ) | v);
+                hi = -1;
+            }
+        }
+        if ( -1 != hi ) {
+            bytes += static_cast<char>(hi << 4);
+        }
+    } else {
+        for ( size_t idx = 1 ; idx < token_.length() - 1 ; ++idx ) {
+            char c = token_[idx];
+            if ( '\\' != c ) {
+                bytes += c;
+                continue;
+            }
+            c = token_[++idx];
+            switch (c) {
+                case 'n': bytes += '\n'; break;
+                case 'r': bytes += '\r'; break;
+                case 't': bytes += '\t'; break;
+                case 'b': bytes += '\b'; break;
+                case 'f': bytes += '\f'; break;
+                case '\r':
+                    if ( idx + 1 < token_.length() - 1 && '\n' == token_[idx + 1] ) {
+                        ++idx;
+                    }
+                    break;
+                case '\n':
+                    break;
+                default:
+                    if ( c >= '0' && c <= '7' ) {
+                        int v = c - '0';
+                        for ( int k = 0 ; k < 2 && idx + 1 < token_.length() - 1 && token_[idx + 1] >= '0' && token_[idx + 1] <= '7' ; ++k ) {
+                            v = ( v << 3 ) | ( token_[++idx] - '0' );
+                        }
+                        bytes += static_cast<char>(v & 0xFF);
+                    } else {
+                        bytes += c;
+                    }
+                    break;
+            }
+        }
+    }
+    // ... UTF-16BE?
+    if ( bytes.length() >= 2 && '\xFE' == bytes[0] && '\xFF' == bytes[1] ) {
+        std::string text;
+        for ( size_t idx = 2 ; idx + 1 < bytes.length() ; idx += 2 ) {
+            uint32_t cp = ( static_cast<uint32_t>(static_cast<unsigned char>(bytes[idx])) << 8 ) | static_cast<unsigned char>(bytes[idx + 1]);
+            if ( cp >= 0xD800 && cp <= 0xDBFF && idx + 3 < bytes.length() ) {
+                const uint32_t low = ( static_cast<uint32_t>(static_cast<unsigned char>(bytes[idx + 2])) << 8 ) | static_cast<unsigned char>(bytes[idx + 3]);
+                cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                idx += 2;
+            }
+            if ( cp < 0x80 ) {
+                text += static_cast<char>(cp);
+            } else if ( cp < 0x800 ) {
+                text += static_cast<char>(0xC0 | ( cp >> 6 ));
+                text += static_cast<char>(0x80 | ( cp & 0x3F ));
+            } else if ( cp < 0x10000 ) {
+                text += static_cast<char>(0xE0 | ( cp >> 12 ));
+                text += static_cast<char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+                text += static_cast<char>(0x80 | ( cp & 0x3F ));
+            } else {
+                text += static_cast<char>(0xF0 | ( cp >> 18 ));
+                text += static_cast<char>(0x80 | ( ( cp >> 12 ) & 0x3F ));
+                text += static_cast<char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+                text += static_cast<char>(0x80 | ( cp & 0x3F ));
+            }
+        }
+        return text;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Serialize value.
+ *
+ * @param o_buffer Where to append serialized value to.
+ */
+void casper::pdf::native::Value::Serialize (std::string& o_buffer) const
+{
+    switch (type_) {
+        case Type::Null:
+            o_buffer += "null";
+            break;
+        case Type::Boolean:
+        case Type::Integer:
+        case Type::Real:
+        case Type::String:
+            o_buffer += token_;
+            break;
+        case Type::Name:
+            o_buffer += '/';
+            o_buffer += token_;
+            break;
+        case Type::Array:
+            o_buffer += '[';
+            for ( size_t idx = 0 ; idx < items_.size() ; ++idx ) {
+                if ( 0 != idx ) {
+                    o_buffer += ' ';
+                }
+                items_[idx].Serialize(o_buffer);
+            }
+            o_buffer += ']';
+            break;
+        case Type::Dictionary:
+            o_buffer += "<<";
+            for ( size_t idx = 0 ; idx < keys_.size() ; ++idx ) {
+                o_buffer += '/';
+                o_buffer += keys_[idx];
+                o_buffer += ' ';
+                items_[idx].Serialize(o_buffer);
+            }
+            o_buffer += ">>";
+            break;
+        case Type::Reference:
+            o_buffer += std::to_string(integer_);
+            o_buffer += ' ';
+            o_buffer += std::to_string(generation_);
+            o_buffer += " R";
+            break;
+        default:
+            throw ::cc::Exception("%s", "Unable to serialize a stream value!");
+    }
+}
@@ -0,0 +1,181 @@
+/**
+ * @file value.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_NATIVE_VALUE_H_
+#define CASPER_PDF_NATIVE_VALUE_H_
+
+#include <inttypes.h> // int64_t, uint8_t
+#include <string>
+#include <vector>
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace native
+        {
+        
+            /**
+             * @brief A PDF object value, as read from a document.
+             *
+             *        Tokens that are not changed by an incremental update ( numbers, names and strings ) are kept as
+             *        they were read so that objects can be written back byte-for-byte equivalent.
+             */
+            class Value final
+            {
+                
+            public: // Data Type(s)
+                
+                enum class Type : uint8_t {
+                    Null = 0,
+                    Boolean,
+                    Integer,
+                    Real,
+                    String,
+                    Name,
+                    Array,
+                    Dictionary,
+                    Reference,
+                    Stream
+                };
+                
+            private: // Data
+                
+                Type                     type_;
+                std::string              token_;      //!< Raw token: boolean, number, string ( with delimiters ) or name ( without '/' ).
+                int64_t                  integer_;    //!< Integer value or object number.
+                uint32_t                 generation_; //!< Object generation.
+                std::vector<std::string> keys_;       //!< Dictionary keys, names without '/'.
+                std::vector<Value>       items_;      //!< Array items or dictionary values.
+                size_t                   offset_;     //!< Stream data offset.
+                
+            public: // Constructor(s) / Destructor
+                
+                Value ();
+                Value (const Value& a_value) = default;
+                
+                ~Value ();
+                
+            public: // Overloaded Operator(s)
+                
+                Value& operator = (const Value& a_value) = default;
+                
+            public: // Static Method(s) / Function(s)
+                
+                static Value Boolean    (const bool a_value);
+                static Value Integer    (const int64_t a_value);
+                static Value Real       (const std::string& a_token);
+                static Value String     (const std::string& a_token);
+                static Value Literal    (const std::string& a_text);
+                static Value Name       (const std::string& a_name);
+                static Value Array      ();
+                static Value Dictionary ();
+                static Value Reference  (const int64_t a_number, const uint32_t a_generation);
+                
+            public: // Method(s) / Function(s)
+                
+                const Value* Get        (const std::string& a_key) const;
+                void         Set        (const std::string& a_key, const Value& a_value);
+                void         Remove     (const std::string& a_key);
+                void         Add        (const Value& a_value);
+                void         MakeStream (const size_t a_offset);
+                
+                bool         IsNumber   () const;
+                double       Number     () const;
+                std::string  Text       () const;
+                void         Serialize  (std::string& o_buffer) const;
+                
+            public: // Inline Method(s) / Function(s)
+                
+                const Type&                     type       () const;
+                const std::string&              token      () const;
+                const int64_t&                  integer    () const;
+                const uint32_t&                 generation () const;
+                const std::vector<std::string>& keys       () const;
+                const std::vector<Value>&       items      () const;
+                const size_t&                   offset     () const;
+                
+            }; // end of class 'Value'
+        
+            /**
+             * @return R/O access to value type.
+             */
+            inline const Value::Type& Value::type () const
+            {
+                return type_;
+            }
+        
+            /**
+             * @return R/O access to raw token.
+             */
+            inline const std::string& Value::token () const
+            {
+                return token_;
+            }
+        
+            /**
+             * @return R/O access to integer value or object number.
+             */
+            inline const int64_t& Value::integer () const
+            {
+                return integer_;
+            }
+        
+            /**
+             * @return R/O access to object generation.
+             */
+            inline const uint32_t& Value::generation () const
+            {
+                return generation_;
+            }
+        
+            /**
+             * @return R/O access to dictionary keys.
+             */
+            inline const std::vector<std::string>& Value::keys () const
+            {
+                return keys_;
+            }
+        
+            /**
+             * @return R/O access to array items or dictionary values.
+             */
+            inline const std::vector<Value>& Value::items () const
+            {
+                return items_;
+            }
+        
+            /**
+             * @return R/O access to stream data offset.
+             */
+            inline const size_t& Value::offset () const
+            {
+                return offset_;
+            }
+        
+        } // end of namespace 'native'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_NATIVE_VALUE_H_
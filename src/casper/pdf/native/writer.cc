@@ -0,0 +1,708 @@
+/**
+ * @file writer.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/writer.h"
+
+#include "cc/exception.h"
+#include "cc/types.h" // SIZET_FMT
+#include "cc/fs/file.h"
+
+#include <algorithm> // std::sort
+#include <stdio.h>   // snprintf
+#include <string.h>  // strchr
+
+#include <openssl/evp.h>
+
+const size_t casper::pdf::native::Writer::sk_byte_range_width_ = 64;
+const size_t casper::pdf::native::Writer::sk_max_tree_depth_   = 64;
+
+// MARK: - Constructor(s) / Destructor
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_name Writer name.
+ */
+casper::pdf::native::Writer::Writer (const std::string& a_name)
+ : casper::pdf::Writer(a_name)
+{
+    parser_           = nullptr;
+    original_size_    = 0;
+    calculate_digest_ = false;
+    digest_cache_     = nullptr;
+    io_settings_      = { io::File::Backend::MMap, 65536, 4 };
+    copy_strategy_    = io::File::CopyStrategy::None;
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::native::Writer::~Writer ()
+{
+    if ( nullptr != parser_ ) {
+        delete parser_;
+    }
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from pdf::Writer
+
+/**
+ * @brief Open a PDF document and write any change to output.
+ *
+ * @param a_io Local file URI to read and to write to.
+ */
+void casper::pdf::native::Writer::Open (const std::string& a_io)
+{
+    Open(a_io, a_io);
+}
+
+/**
+ * @brief Open a PDF document and write any change to output.
+ *
+ * @param a_in        Local file URI to read from.
+ * @param a_out       Local file URI to write to.
+ * @param a_overwrite When true, an existing destination file is truncated, otherwise only an empty one is accepted.
+ */
+void casper::pdf::native::Writer::Open (const std::string& a_in, const std::string& a_out, const bool a_overwrite)
+{
+    // ... already open?
+    if ( nullptr != parser_ ) {
+        throw ::cc::Exception("%s", "Document is already open!");
+    }
+    digest_        = "";
+    copy_strategy_ = io::File::CopyStrategy::None;
+    try {
+        // ... only trailer and cross-reference sections are read ...
+        parser_ = new Parser(io_settings_);
+        parser_->Open(a_in);
+        if ( nullptr != parser_->trailer().Get("Encrypt") ) {
+            throw ::cc::Exception("%s", "Encrypted documents are not supported!");
+        }
+        // ... an existing copy is required, let the filesystem do it ( no data movement when reflinks are supported ) ...
+        if ( a_out != a_in ) {
+            const bool exists = cc::fs::File::Exists(a_out);
+            if ( true == exists && false == a_overwrite && 0 != cc::fs::File::Size(a_out) ) {
+                throw ::cc::Exception("Unable to copy '%s' to '%s' - destination file already exists!", a_in.c_str(), a_out.c_str());
+            }
+            copy_strategy_ = io::File::Copy(a_in, a_out, /* a_overwrite */ exists);
+        }
+        in_uri_        = a_in;
+        out_uri_       = a_out;
+        original_size_ = parser_->size();
+    } catch (...) {
+        Close();
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+/**
+ * @brief Append a signature placeholder.
+ *
+ * @param a_annotation Annotation properties.
+ * @param o_range      /ByteRange, as written.
+ */
+void casper::pdf::native::Writer::Append (const pdf::SignatureAnnotation& a_annotation, pdf::ByteRange& o_range)
+{
+    // ... document must be open ..
+    if ( nullptr == parser_ ) {
+        throw ::cc::Exception("%s", "Document is not open!");
+    }
+    if ( true == a_annotation.visible() ) {
+        throw ::cc::Exception("%s", "Visible signatures are not supported by this writer!");
+    }
+    if ( 0 == a_annotation.info().size_in_bytes_ ) {
+        throw ::cc::Exception("Invalid signature size of " SIZET_FMT " !", a_annotation.info().size_in_bytes_);
+    }
+    
+    // ... catalog ...
+    const Value& trailer = parser_->trailer();
+    const Value* root    = trailer.Get("Root");
+    const Value* size    = trailer.Get("Size");
+    if ( nullptr == root || Value::Type::Reference != root->type() || nullptr == size || Value::Type::Integer != size->type() ) {
+        throw ::cc::Exception("%s", "Invalid trailer!");
+    }
+    Value catalog;
+    parser_->Load(root->integer(), catalog);
+    if ( Value::Type::Dictionary != catalog.type() ) {
+        throw ::cc::Exception("%s", "Invalid catalog!");
+    }
+    
+    // ... search for specific page ...
+    if ( 0 == a_annotation.page() ) {
+        throw ::cc::Exception("Page number " SIZET_FMT " not found!", a_annotation.page());
+    }
+    Value page_reference, page, media_box;
+    FindPage(catalog, a_annotation.page() - 1, page_reference, page, media_box);
+    
+    std::vector<Object> objects;
+    int64_t             next         = size->integer();
+    const int64_t       sig_number   = next++;
+    const int64_t       field_number = next++;
+    
+    // ... grab 'form' ...
+    Value        form, form_reference, fields, fields_reference;
+    const Value* value = catalog.Get("AcroForm");
+    if ( nullptr != value && Value::Type::Reference == value->type() ) {
+        form_reference = *value;
+        parser_->Load(form_reference.integer(), form);
+    } else if ( nullptr != value ) {
+        form = *value;
+    }
+    if ( Value::Type::Dictionary != form.type() ) {
+        form = Value::Dictionary();
+    }
+    if ( nullptr != ( value = form.Get("Fields") ) && Value::Type::Reference == value->type() ) {
+        fields_reference = *value;
+        parser_->Load(fields_reference.integer(), fields);
+    } else if ( nullptr != value ) {
+        fields = *value;
+    }
+    if ( Value::Type::Array != fields.type() ) {
+        fields = Value::Array();
+    }
+    
+    // ... a signature with the same name present? ...
+    if ( true == SignatureExists(fields, a_annotation.name_) ) {
+        throw ::cc::Exception("A signature with the same name '%s' is already present - not replacing it!", a_annotation.name_.c_str());
+    }
+    
+    // ... register new field ...
+    fields.Add(Value::Reference(field_number, 0));
+    if ( Value::Type::Reference == fields_reference.type() ) {
+        objects.push_back({ fields_reference.integer(), fields_reference.generation(), "" });
+        fields.Serialize(objects.back().body_);
+    } else {
+        form.Set("Fields", fields);
+    }
+    
+    // ... update SigFlags and NeedAppearances ...
+    form.Set("SigFlags", Value::Integer(3));
+    if ( nullptr != ( value = form.Get("NeedAppearances") ) && Value::Type::Boolean == value->type() && "true" == value->token() ) {
+        form.Set("NeedAppearances", Value::Boolean(false));
+    }
+    if ( Value::Type::Reference == form_reference.type() ) {
+        objects.push_back({ form_reference.integer(), form_reference.generation(), "" });
+        form.Serialize(objects.back().body_);
+    } else {
+        // ... inline or missing form becomes an indirect object, catalog must be rewritten ...
+        const int64_t form_number = next++;
+        objects.push_back({ form_number, 0, "" });
+        form.Serialize(objects.back().body_);
+        catalog.Set("AcroForm", Value::Reference(form_number, 0));
+        objects.push_back({ root->integer(), root->generation(), "" });
+        catalog.Serialize(objects.back().body_);
+    }
+    
+    // ... add an annotation to page ...
+    Value annots, annots_reference;
+    if ( nullptr != ( value = page.Get("Annots") ) && Value::Type::Reference == value->type() ) {
+        annots_reference = *value;
+        parser_->Load(annots_reference.integer(), annots);
+    } else if ( nullptr != value ) {
+        annots = *value;
+    }
+    if ( Value::Type::Array != annots.type() ) {
+        annots = Value::Array();
+    }
+    annots.Add(Value::Reference(field_number, 0));
+    if ( Value::Type::Reference == annots_reference.type() ) {
+        objects.push_back({ annots_reference.integer(), annots_reference.generation(), "" });
+        annots.Serialize(objects.back().body_);
+    } else {
+        page.Set("Annots", annots);
+        objects.push_back({ page_reference.integer(), page_reference.generation(), "" });
+        page.Serialize(objects.back().body_);
+    }
+    
+    // ... signature field and widget, merged ...
+    {
+        const double height = media_box.items()[3].Number() - media_box.items()[1].Number();
+        const auto&  rect   = a_annotation.rect();
+        const double bottom = height - static_cast<double>(rect.y_) - static_cast<double>(rect.h_);
+        std::string body = "<</Type /Annot/Subtype /Widget/FT /Sig/T ";
+        Value::Literal(a_annotation.name_).Serialize(body);
+        body += "/V " + std::to_string(sig_number) + " 0 R";
+        body += "/P " + std::to_string(page_reference.integer()) + ' ' + std::to_string(page_reference.generation()) + " R";
+        body += "/Rect [" + Number(static_cast<double>(rect.x_)) + ' ' + Number(bottom) + ' '
+                          + Number(static_cast<double>(rect.x_ + rect.w_)) + ' ' + Number(bottom + static_cast<double>(rect.h_)) + ']';
+        // ... Invisible | Hidden | Locked, ReadOnly ...
+        body += "/F 131/Ff 1>>";
+        objects.push_back({ field_number, 0, body });
+    }
+    
+    // ... signature dictionary, /Contents last so /ByteRange and beacon positions are easy to track ...
+    {
+        std::string body = "<</Type /Sig/Filter /Adobe.PPKLite/SubFilter /adbe.pkcs7.detached/M ";
+        body += Date(a_annotation.info().utc_date_time_);
+        body += "/Reason ";
+        Value::Literal(a_annotation.info().reason_).Serialize(body);
+        body += "/Prop_Build <</App <</Name /" + EscapeName(name_) + ">>>>";
+        body += "/ByteRange [" + std::string(sk_byte_range_width_, ' ') + "]";
+        body += "/Contents <" + std::string(2 * a_annotation.info().size_in_bytes_, '0') + ">>>";
+        objects.push_back({ sig_number, 0, body });
+    }
+    
+    // ... write objects, keeping track of offsets ...
+    std::sort(objects.begin(), objects.end(), [] (const Object& a_lhs, const Object& a_rhs) {
+        return a_lhs.number_ < a_rhs.number_;
+    });
+    std::string         increment = "\n";
+    std::vector<size_t> offsets;
+    size_t              byte_range_position = std::string::npos;
+    size_t              contents_position   = std::string::npos;
+    for ( const auto& object : objects ) {
+        offsets.push_back(original_size_ + increment.length());
+        increment += std::to_string(object.number_) + ' ' + std::to_string(object.generation_) + " obj\n";
+        if ( sig_number == object.number_ ) {
+            byte_range_position = increment.length() + object.body_.find("/ByteRange [") + 12;
+            contents_position   = increment.length() + object.body_.find("/Contents <") + 10;
+        }
+        increment += object.body_;
+        increment += "\nendobj\n";
+        if ( object.number_ >= next ) {
+            next = object.number_ + 1;
+        }
+    }
+    
+    // ... trailer entries ...
+    Value update = Value::Dictionary();
+    update.Set("Root", *root);
+    if ( nullptr != ( value = trailer.Get("Info") ) ) {
+        update.Set("Info", *value);
+    }
+    if ( nullptr != ( value = trailer.Get("ID") ) ) {
+        update.Set("ID", *value);
+    }
+    update.Set("Prev", Value::Integer(static_cast<int64_t>(parser_->startxref())));
+    
+    // ... cross-reference section, same kind as the original one ...
+    const size_t xref = original_size_ + increment.length();
+    if ( true == parser_->xref_stream() ) {
+        // ... the stream is an object and must be part of it's own section ...
+        const int64_t xref_number = next++;
+        objects.push_back({ xref_number, 0, "" });
+        offsets.push_back(xref);
+        update.Set("Size", Value::Integer(next));
+        AppendXRefStream(objects, offsets, update, increment);
+    } else {
+        update.Set("Size", Value::Integer(next));
+        AppendXRefTable(objects, offsets, update, increment);
+    }
+    increment += "startxref\n" + std::to_string(xref) + "\n%%EOF\n";
+    
+    // ... /ByteRange is known by now, patch it ...
+    pdf::ByteRange range;
+    range.before_start_ = 0;
+    range.before_size_  = original_size_ + contents_position;
+    range.after_start_  = range.before_size_ + 2 * a_annotation.info().size_in_bytes_ + 2;
+    range.after_size_   = original_size_ + increment.length() - range.after_start_;
+    {
+        char buffer[128];
+        const int length = snprintf(buffer, sizeof(buffer), "0 " SIZET_FMT " " SIZET_FMT " " SIZET_FMT, range.before_size_, range.after_start_, range.after_size_);
+        if ( length < 0 || static_cast<size_t>(length) > sk_byte_range_width_ ) {
+            throw ::cc::Exception("%s", "Unable to write /ByteRange - not enough space!");
+        }
+        increment.replace(byte_range_position, static_cast<size_t>(length), buffer, static_cast<size_t>(length));
+    }
+    
+    // ... original document and incremental update hash ...
+    if ( true == calculate_digest_ ) {
+        Digest(increment, range);
+    }
+    
+    // ... append incremental update ...
+    io::File* file = io::File::New(io_settings_);
+    try {
+        file->Open(out_uri_, io::File::Mode::ReadWrite);
+        file->Write(original_size_, reinterpret_cast<const unsigned char*>(increment.c_str()), increment.length());
+        file->Close();
+        delete file;
+    } catch (...) {
+        delete file;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+    
+    o_range = range;
+}
+
+/**
+ * @brief Close the currenly open file.
+ */
+void casper::pdf::native::Writer::Close ()
+{
+    if ( nullptr != parser_ ) {
+        delete parser_;
+        parser_ = nullptr;
+    }
+    // ... incremental update was appended after original document bytes, saved SHA256 state is still valid ...
+    if ( nullptr != digest_cache_ && 0 != out_uri_.length() ) {
+        digest_cache_->Touch(out_uri_, original_size_);
+    }
+    in_uri_        = "";
+    out_uri_       = "";
+    original_size_ = 0;
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Calculate /ByteRange digest while writing the incremental update.
+ *
+ * @param a_settings I/O settings to use when reading the original document.
+ * @param a_cache    Optional SHA256 state cache, not owned, used to skip already hashed original document bytes.
+ */
+void casper::pdf::native::Writer::EnableDigest (const io::File::Settings& a_settings, pdf::DigestCache* a_cache)
+{
+    // ... must be set before open ...
+    if ( nullptr != parser_ ) {
+        throw ::cc::Exception("%s", "Document is already open!");
+    }
+    calculate_digest_ = true;
+    digest_cache_     = a_cache;
+    io_settings_      = a_settings;
+}
+
+// MARK: - [PRIVATE] - Helper(s)
+
+/**
+ * @brief Walk page tree, loading only the nodes on the path to the requested page.
+ *
+ * @param a_catalog   Document catalog.
+ * @param a_index     Page index, 0..n-1.
+ * @param o_reference Page indirect reference.
+ * @param o_page      Page dictionary.
+ * @param o_media_box Page /MediaBox, own or inherited.
+ */
+void casper::pdf::native::Writer::FindPage (const Value& a_catalog, const size_t a_index, Value& o_reference, Value& o_page, Value& o_media_box)
+{
+    const Value* pages = a_catalog.Get("Pages");
+    if ( nullptr == pages || Value::Type::Reference != pages->type() ) {
+        throw ::cc::Exception("%s", "Document has no pages!");
+    }
+    Value node;
+    parser_->Load(pages->integer(), node);
+    
+    Value        media_box;
+    const Value* value = node.Get("MediaBox");
+    if ( nullptr != value ) {
+        parser_->Resolve(*value, media_box);
+    }
+    
+    size_t remaining = a_index;
+    for ( size_t depth = 0 ; depth < sk_max_tree_depth_ ; ++depth ) {
+        Value kids;
+        if ( nullptr == ( value = node.Get("Kids") ) ) {
+            break;
+        }
+        parser_->Resolve(*value, kids);
+        if ( Value::Type::Array != kids.type() ) {
+            break;
+        }
+        bool descended = false;
+        for ( const auto& reference : kids.items() ) {
+            if ( Value::Type::Reference != reference.type() ) {
+                continue;
+            }
+            Value kid;
+            parser_->Load(reference.integer(), kid);
+            if ( Value::Type::Dictionary != kid.type() ) {
+                continue;
+            }
+            const Value* count = kid.Get("Count");
+            if ( nullptr != kid.Get("Kids") ) {
+                // ... intermediate node ...
+                Value number;
+                if ( nullptr != count ) {
+                    parser_->Resolve(*count, number);
+                }
+                const size_t n = ( Value::Type::Integer == number.type() && number.integer() > 0 ? static_cast<size_t>(number.integer()) : 0 );
+                if ( remaining >= n ) {
+                    remaining -= n;
+                    continue;
+                }
+                node = kid;
+                if ( nullptr != ( value = node.Get("MediaBox") ) ) {
+                    parser_->Resolve(*value, media_box);
+                }
+                descended = true;
+                break;
+            } else if ( 0 != remaining ) {
+                remaining--;
+                continue;
+            }
+            // ... found it ...
+            o_reference = reference;
+            o_page      = kid;
+            if ( nullptr != ( value = o_page.Get("MediaBox") ) ) {
+                parser_->Resolve(*value, media_box);
+            }
+            if ( Value::Type::Array != media_box.type() || 4 != media_box.items().size()
+                 || false == media_box.items()[1].IsNumber() || false == media_box.items()[3].IsNumber() ) {
+                throw ::cc::Exception("Page number " SIZET_FMT " has no valid /MediaBox!", a_index + 1);
+            }
+            o_media_box = media_box;
+            return;
+        }
+        if ( false == descended ) {
+            break;
+        }
+    }
+    throw ::cc::Exception("Page number " SIZET_FMT " not found!", a_index + 1);
+}
+
+/**
+ * @brief Search for a signature field.
+ *
+ * @param a_fields /AcroForm /Fields array.
+ * @param a_name   Signature name.
+ *
+ * @return True if exists, false otherwise.
+ */
+bool casper::pdf::native::Writer::SignatureExists (const Value& a_fields, const std::string& a_name)
+{
+    for ( const auto& item : a_fields.items() ) {
+        Value field;
+        parser_->Resolve(item, field);
+        const Value* t = field.Get("T");
+        if ( Value::Type::Dictionary != field.type() || nullptr == t || a_name != t->Text() ) {
+            continue;
+        }
+        // ... a field with the searching name was found, search for 'FT' item ...
+        Value        parent;
+        const Value* ft = field.Get("FT");
+        if ( nullptr == ft && nullptr != field.Get("Parent") ) {
+            parser_->Resolve(*field.Get("Parent"), parent);
+            ft = parent.Get("FT");
+        }
+        if ( nullptr == ft ) {
+            throw ::cc::Exception("%s", "FT item not found!");
+        }
+        if ( Value::Type::Name == ft->type() && "Sig" == ft->token() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Calculate /ByteRange digest: original document ( resuming from a cached SHA256 state, if any ) and incremental update.
+ *
+ * @param a_increment Incremental update bytes.
+ * @param a_range     /ByteRange.
+ */
+void casper::pdf::native::Writer::Digest (const std::string& a_increment, const pdf::ByteRange& a_range)
+{
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    io::File*   file    = nullptr;
+    try {
+        if ( nullptr == context || 1 != EVP_DigestInit_ex(context, EVP_sha256(), nullptr) ) {
+            throw ::cc::Exception("%s", "Unable to initialize SHA256 context!");
+        }
+        // ... resume from a previously saved SHA256 state, if any, it's bytes can't have changed ...
+        size_t hashed = 0;
+        if ( nullptr != digest_cache_ && false == digest_cache_->Restore(in_uri_, original_size_, context, hashed) ) {
+            hashed = 0;
+        }
+        file = io::File::New(io_settings_);
+        file->Open(in_uri_, io::File::Mode::Read);
+        file->Read(hashed, original_size_ - hashed, [context] (const unsigned char* a_bytes, const size_t& a_size) {
+            if ( 1 != EVP_DigestUpdate(context, a_bytes, a_size) ) {
+                throw ::cc::Exception("%s", "Unable to update SHA256 context!");
+            }
+        });
+        file->Close();
+        delete file;
+        file = nullptr;
+        // ... save SHA256 state for next digest of this document, or of it's copy ...
+        if ( nullptr != digest_cache_ ) {
+            digest_cache_->Save(in_uri_, original_size_, context);
+            if ( out_uri_ != in_uri_ ) {
+                digest_cache_->Save(out_uri_, original_size_, context);
+            }
+        }
+        // ... incremental update, skipping /Contents ...
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(a_increment.c_str());
+        unsigned char        md[EVP_MAX_MD_SIZE];
+        unsigned int         length = 0;
+        if (    1 != EVP_DigestUpdate(context, bytes, a_range.before_size_ - original_size_)
+             || 1 != EVP_DigestUpdate(context, bytes + ( a_range.after_start_ - original_size_ ), a_range.after_size_)
+             || 1 != EVP_DigestFinal_ex(context, md, &length) ) {
+            throw ::cc::Exception("%s", "Unable to calculate SHA256 digest!");
+        }
+        unsigned char encoded[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+        const int     encoded_length = EVP_EncodeBlock(encoded, md, static_cast<int>(length));
+        digest_ = std::string(reinterpret_cast<const char*>(encoded), static_cast<size_t>(encoded_length));
+        EVP_MD_CTX_free(context);
+    } catch (...) {
+        delete file;
+        EVP_MD_CTX_free(context);
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+// MARK: - [PRIVATE] - Static Method(s) / Function(s)
+
+/**
+ * @brief Append a cross-reference table and trailer, one subsection per run of consecutive object numbers.
+ *
+ * @param a_objects   Objects, sorted by number.
+ * @param a_offsets   Objects offsets.
+ * @param a_trailer   Trailer dictionary.
+ * @param o_increment Incremental update to append to.
+ */
+void casper::pdf::native::Writer::AppendXRefTable (const std::vector<Object>& a_objects, const std::vector<size_t>& a_offsets, const Value& a_trailer,
+                                                   std::string& o_increment)
+{
+    o_increment += "xref\n";
+    char entry[32];
+    for ( size_t idx = 0 ; idx < a_objects.size() ; ) {
+        size_t count = 1;
+        while ( idx + count < a_objects.size() && a_objects[idx + count].number_ == a_objects[idx].number_ + static_cast<int64_t>(count) ) {
+            count++;
+        }
+        o_increment += std::to_string(a_objects[idx].number_) + ' ' + std::to_string(count) + '\n';
+        for ( size_t e = idx ; e < idx + count ; ++e ) {
+            snprintf(entry, sizeof(entry), "%010zu %05u n\r\n", a_offsets[e], static_cast<unsigned>(a_objects[e].generation_));
+            o_increment += entry;
+        }
+        idx += count;
+    }
+    o_increment += "trailer\n";
+    a_trailer.Serialize(o_increment);
+    o_increment += "\n";
+}
+
+/**
+ * @brief Append a cross-reference stream, uncompressed, one /Index pair per run of consecutive object numbers.
+ *
+ * @param a_objects   Objects, sorted by number, the last one is the stream itself.
+ * @param a_offsets   Objects offsets.
+ * @param a_trailer   Trailer entries.
+ * @param o_increment Incremental update to append to.
+ */
+void casper::pdf::native::Writer::AppendXRefStream (const std::vector<Object>& a_objects, const std::vector<size_t>& a_offsets, const Value& a_trailer,
+                                                    std::string& o_increment)
+{
+    // ... offset field width, in bytes ...
+    size_t width = 1;
+    for ( const auto offset : a_offsets ) {
+        while ( width < 8 && 0 != ( static_cast<uint64_t>(offset) >> ( 8 * width ) ) ) {
+            width++;
+        }
+    }
+    Value       index = Value::Array();
+    std::string data;
+    for ( size_t idx = 0 ; idx < a_objects.size() ; ) {
+        size_t count = 1;
+        while ( idx + count < a_objects.size() && a_objects[idx + count].number_ == a_objects[idx].number_ + static_cast<int64_t>(count) ) {
+            count++;
+        }
+        index.Add(Value::Integer(a_objects[idx].number_));
+        index.Add(Value::Integer(static_cast<int64_t>(count)));
+        for ( size_t e = idx ; e < idx + count ; ++e ) {
+            data += '\x01';
+            for ( size_t b = width ; b > 0 ; --b ) {
+                data += static_cast<char>(( static_cast<uint64_t>(a_offsets[e]) >> ( 8 * ( b - 1 ) ) ) & 0xFF);
+            }
+            data += static_cast<char>(( a_objects[e].generation_ >> 8 ) & 0xFF);
+            data += static_cast<char>(a_objects[e].generation_ & 0xFF);
+        }
+        idx += count;
+    }
+    Value w = Value::Array();
+    w.Add(Value::Integer(1));
+    w.Add(Value::Integer(static_cast<int64_t>(width)));
+    w.Add(Value::Integer(2));
+    
+    Value dictionary = a_trailer;
+    dictionary.Set("Type", Value::Name("XRef"));
+    dictionary.Set("W", w);
+    dictionary.Set("Index", index);
+    dictionary.Set("Length", Value::Integer(static_cast<int64_t>(data.length())));
+    
+    o_increment += std::to_string(a_objects.back().number_) + " 0 obj\n";
+    dictionary.Serialize(o_increment);
+    o_increment += "\nstream\n";
+    o_increment += data;
+    o_increment += "\nendstream\nendobj\n";
+}
+
+/**
+ * @brief Escape a name, characters outside the regular set are written as #xx.
+ *
+ * @param a_name Name, without '/'.
+ *
+ * @return Escaped name.
+ */
+std::string casper::pdf::native::Writer::EscapeName (const std::string& a_name)
+{
+    static const char* const sk_hex = "0123456789ABCDEF";
+    std::string escaped;
+    for ( const auto c : a_name ) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if ( u < 0x21 || u > 0x7E || nullptr != strchr("()<>[]{}/%#", c) ) {
+            escaped += '#';
+            escaped += sk_hex[u >> 4];
+            escaped += sk_hex[u & 0xF];
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief Format a number, without trailing zeros.
+ *
+ * @param a_value Value to format.
+ *
+ * @return Formatted value.
+ */
+std::string casper::pdf::native::Writer::Number (const double a_value)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.4f", a_value);
+    std::string number = buffer;
+    while ( '0' == number.back() ) {
+        number.pop_back();
+    }
+    if ( '.' == number.back() ) {
+        number.pop_back();
+    }
+    return ( "-0" == number ? "0" : number );
+}
+
+/**
+ * @brief Translate a X509 UTC time to a PDF date string.
+ *
+ * @param a_utc_date_time YYMMDDHHMMSSZ.
+ *
+ * @return (D:YYYYMMDDHHmmSS+00'00').
+ */
+std::string casper::pdf::native::Writer::Date (const std::string& a_utc_date_time)
+{
+    if ( 13 != a_utc_date_time.length() || 'Z' != a_utc_date_time[12] || 12 != a_utc_date_time.find_first_not_of("0123456789") ) {
+        throw ::cc::Exception("Invalid signing date '%s'!", a_utc_date_time.c_str());
+    }
+    // ... X.509 UTCTime, YY >= 50 is 19YY ...
+    const std::string century = ( a_utc_date_time.compare(0, 2, "50") >= 0 ? "19" : "20" );
+    return "(D:" + century + a_utc_date_time.substr(0, 12) + "+00'00')";
+}
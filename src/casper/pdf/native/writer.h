@@ -0,0 +1,145 @@
+/**
+ * @file writer.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_NATIVE_WRITER_H_
+#define CASPER_PDF_NATIVE_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "casper/io/file.h"
+
+#include "casper/pdf/writer.h"
+#include "casper/pdf/digest_cache.h"
+
+#include "casper/pdf/native/parser.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace native
+        {
+        
+            /**
+             * @brief A signature placeholder writer that doesn't load the document.
+             *
+             *        Only the trailer, cross-reference sections, catalog, /AcroForm and target page are read;
+             *        the incremental update is built in memory ( it's size doesn't depend on the document size )
+             *        and appended to the output file, so peak memory usage is flat for any document size.
+             *
+             *        The cross-reference section is written as a table or as an ( uncompressed ) stream, following the original document.
+             *
+             *        Invisible signatures only, visible ones require fonts and images to be embedded - see podofo::Writer.
+             */
+            class Writer final : public pdf::Writer
+            {
+                
+            private: // Data Type(s)
+                
+                typedef struct {
+                    int64_t     number_;
+                    uint32_t    generation_;
+                    std::string body_;       //!< Serialized object value.
+                } Object;
+                
+            private: // Static Const Data
+                
+                static const size_t sk_byte_range_width_;
+                static const size_t sk_max_tree_depth_;
+                
+            private: // Data
+                
+                Parser*                parser_;
+                std::string            in_uri_;
+                std::string            out_uri_;
+                size_t                 original_size_;
+                bool                   calculate_digest_;
+                pdf::DigestCache*      digest_cache_;
+                io::File::Settings     io_settings_;
+                std::string            digest_;
+                io::File::CopyStrategy copy_strategy_;
+                
+            public: // Constructor(s) / Destructor
+                
+                Writer () = delete;
+                Writer (const std::string& a_name);
+                
+                virtual ~Writer ();
+                
+            public: // Inherited Method(s) / Function(s) from pdf::Writer
+                
+                virtual void Open   (const std::string& a_in, const std::string& a_out, const bool a_overwrite = false);
+                virtual void Open   (const std::string& a_io);
+                virtual void Append (const SignatureAnnotation& a_annotation, ByteRange& o_range);
+                virtual void Close  ();
+                
+            public: // Method(s) / Function(s)
+                
+                void EnableDigest (const io::File::Settings& a_settings, pdf::DigestCache* a_cache = nullptr);
+                
+            public: // Inline Method(s) / Function(s)
+                
+                const std::string&            digest        () const;
+                const io::File::CopyStrategy& copy_strategy () const;
+                
+            private: // Helper(s)
+                
+                void FindPage        (const Value& a_catalog, const size_t a_index, Value& o_reference, Value& o_page, Value& o_media_box);
+                bool SignatureExists (const Value& a_fields, const std::string& a_name);
+                void Digest          (const std::string& a_increment, const pdf::ByteRange& a_range);
+                
+            private: // Static Method(s) / Function(s)
+                
+                static void        AppendXRefTable  (const std::vector<Object>& a_objects, const std::vector<size_t>& a_offsets, const Value& a_trailer,
+                                                     std::string& o_increment);
+                static void        AppendXRefStream (const std::vector<Object>& a_objects, const std::vector<size_t>& a_offsets, const Value& a_trailer,
+                                                     std::string& o_increment);
+                static std::string EscapeName       (const std::string& a_name);
+                static std::string Number           (const double a_value);
+                static std::string Date             (const std::string& a_utc_date_time);
+                
+            }; // end of class 'Writer'
+        
+            /**
+             * @return R/O access to /ByteRange SHA256 Base 64 encoded digest, calculated by \link Append \link when enabled.
+             */
+            inline const std::string& Writer::digest () const
+            {
+                return digest_;
+            }
+        
+            /**
+             * @return R/O access to the strategy used to create output file by the last \link Open \link call.
+             */
+            inline const io::File::CopyStrategy& Writer::copy_strategy () const
+            {
+                return copy_strategy_;
+            }
+        
+        } // end of namespace 'native'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_NATIVE_WRITER_H_
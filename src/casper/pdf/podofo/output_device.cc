@@ -0,0 +1,353 @@
+/**
+ * @file output_device.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/podofo/output_device.h"
+
+#include "cc/exception.h"
+
+#include "cc/types.h" // SIZET_FMT
+
+#include <string.h> // memcpy, memcmp, memset
+#include <stdio.h>  // vsnprintf
+#include <stdarg.h> // va_start, va_end
+
+/**
+ * @brief Default constructor.
+ *
+ * @param a_device Real output device, must outlive this object.
+ * @param a_digest When true SHA256 of /ByteRange will be calculated.
+ * @param a_offset Logical position of real device first byte, non zero when only the incremental update is to be written.
+ */
+casper::pdf::podofo::OutputDevice::OutputDevice (::PoDoFo::PdfOutputDevice* a_device, const bool a_digest, const size_t a_offset)
+ : ::PoDoFo::PdfOutputDevice(),
+   device_(a_device), digest_(a_digest), offset_(a_offset)
+{
+    base_            = offset_ + device_->GetLength();
+    hashed_          = 0;
+    prefix_modified_ = false;
+    beacon_position_ = 0;
+    beacon_found_    = false;
+    sha256_          = nullptr;
+    if ( true == digest_ ) {
+        sha256_ = EVP_MD_CTX_new();
+        if ( nullptr == sha256_ || 1 != EVP_DigestInit_ex(sha256_, EVP_sha256(), nullptr) ) {
+            if ( nullptr != sha256_ ) {
+                EVP_MD_CTX_free(sha256_);
+            }
+            throw ::cc::Exception("%s", "Unable to initialize SHA256 context!");
+        }
+    }
+}
+
+/**
+ * @brief Destructor.
+ */
+casper::pdf::podofo::OutputDevice::~OutputDevice ()
+{
+    if ( nullptr != sha256_ ) {
+        EVP_MD_CTX_free(sha256_);
+    }
+}
+
+// MARK: - [PUBLIC] - Inherited Method(s) / Function(s) from ::PoDoFo::PdfOutputDevice
+
+/**
+ * @return Logical length.
+ */
+size_t casper::pdf::podofo::OutputDevice::GetLength () const
+{
+    return offset_ + device_->GetLength();
+}
+
+/**
+ * @brief Write formatted data.
+ *
+ * @param a_format Format string.
+ */
+void casper::pdf::podofo::OutputDevice::Print (const char* a_format, ...)
+{
+    va_list args;
+    
+    va_start(args, a_format);
+    const long length = device_->PrintVLen(a_format, args);
+    va_end(args);
+    
+    va_start(args, a_format);
+    PrintV(a_format, length, args);
+    va_end(args);
+}
+
+/**
+ * @brief Write formatted data.
+ *
+ * @param a_format Format string.
+ * @param a_length Number of bytes that will be written.
+ * @param a_args   Arguments.
+ */
+void casper::pdf::podofo::OutputDevice::PrintV (const char* a_format, long a_length, va_list a_args)
+{
+    // ... format it here so all bytes go through Write ...
+    std::string buffer(static_cast<size_t>(a_length) + 1, '\0');
+    const int rv = vsnprintf(&buffer[0], buffer.size(), a_format, a_args);
+    if ( rv < 0 || rv > a_length ) {
+        throw ::cc::Exception("Unable to format output - vsnprintf returned %d, expected %ld!", rv, a_length);
+    }
+    Write(buffer.c_str(), static_cast<size_t>(rv));
+}
+
+/**
+ * @brief Write data to real device, keeping a copy of incremental update bytes and
+ *        replacing signature beacon by '0' characters.
+ *
+ * @param a_buffer Data to write.
+ * @param a_length Number of bytes to write.
+ */
+void casper::pdf::podofo::OutputDevice::Write (const char* a_buffer, size_t a_length)
+{
+    const size_t position = Tell();
+    const char*  data     = a_buffer;
+    std::string  patched;
+    
+    // ... search for beacon, like PdfSignOutputDevice does, it must be written at once ...
+    if ( false == beacon_found_ && 0 != beacon_.length() && a_length >= beacon_.length() ) {
+        const char* const last = a_buffer + ( a_length - beacon_.length() );
+        for ( const char* ptr = a_buffer ; ptr <= last ; ++ptr ) {
+            if ( 0 == memcmp(ptr, beacon_.c_str(), beacon_.length()) ) {
+                beacon_position_ = position + static_cast<size_t>(ptr - a_buffer) - 1;
+                beacon_found_    = true;
+                // ... /Contents is written in it's final placeholder form: hex zeros ...
+                patched.assign(a_buffer, a_length);
+                memset(&patched[static_cast<size_t>(ptr - a_buffer)], '0', beacon_.length());
+                data = patched.c_str();
+                break;
+            }
+        }
+    }
+    
+    // ... keep track of incremental update bytes ...
+    if ( position < base_ ) {
+        prefix_modified_ = true;
+    } else {
+        const size_t offset = position - base_;
+        if ( increment_.length() < offset + a_length ) {
+            increment_.resize(offset + a_length, '\0');
+        }
+        memcpy(&increment_[offset], data, a_length);
+    }
+    
+    device_->Write(data, a_length);
+}
+
+/**
+ * @brief Read data from real device.
+ *
+ * @param o_buffer Where to write read data to.
+ * @param a_length Maximum number of bytes to read.
+ *
+ * @return Number of bytes read.
+ */
+size_t casper::pdf::podofo::OutputDevice::Read (char* o_buffer, size_t a_length)
+{
+    return device_->Read(o_buffer, a_length);
+}
+
+/**
+ * @brief Seek real device.
+ *
+ * @param a_offset Absolute logical position.
+ */
+void casper::pdf::podofo::OutputDevice::Seek (size_t a_offset)
+{
+    if ( a_offset < offset_ ) {
+        throw ::cc::Exception("Unable to seek to position " SIZET_FMT " - only bytes after " SIZET_FMT " are available!", a_offset, offset_);
+    }
+    device_->Seek(a_offset - offset_);
+}
+
+/**
+ * @return Logical position.
+ */
+size_t casper::pdf::podofo::OutputDevice::Tell () const
+{
+    return offset_ + device_->Tell();
+}
+
+/**
+ * @brief Flush real device.
+ */
+void casper::pdf::podofo::OutputDevice::Flush ()
+{
+    device_->Flush();
+}
+
+// MARK: - [PUBLIC] - Method(s) / Function(s)
+
+/**
+ * @brief Hash original document bytes, already present at real device.
+ *
+ * @param a_bytes Original document bytes.
+ * @param a_size  Number of bytes.
+ */
+void casper::pdf::podofo::OutputDevice::Hash (const unsigned char* a_bytes, const size_t a_size)
+{
+    if ( true == digest_ && 1 != EVP_DigestUpdate(sha256_, a_bytes, a_size) ) {
+        throw ::cc::Exception("%s", "Unable to update SHA256 context!");
+    }
+    hashed_ += a_size;
+}
+
+/**
+ * @brief Copy SHA256 context, with original document bytes hashed so far.
+ *
+ * @param o_context Context to overwrite.
+ */
+void casper::pdf::podofo::OutputDevice::Save (EVP_MD_CTX* o_context) const
+{
+    if ( false == digest_ ) {
+        throw ::cc::Exception("%s", "Digest calculation is not enabled!");
+    }
+    if ( 1 != EVP_MD_CTX_copy_ex(o_context, sha256_) ) {
+        throw ::cc::Exception("%s", "Unable to copy SHA256 context!");
+    }
+}
+
+/**
+ * @brief Restore a SHA256 context that already hashed the first bytes of the original document.
+ *
+ * @param a_context Previously saved context, see \link Save \link.
+ * @param a_hashed  Number of original document bytes hashed by \link a_context \link.
+ */
+void casper::pdf::podofo::OutputDevice::Restore (const EVP_MD_CTX* a_context, const size_t a_hashed)
+{
+    if ( false == digest_ ) {
+        throw ::cc::Exception("%s", "Digest calculation is not enabled!");
+    }
+    if ( 0 != hashed_ || a_hashed > base_ ) {
+        throw ::cc::Exception("Unable to restore SHA256 context - " SIZET_FMT " byte(s) already hashed, " SIZET_FMT " available!", hashed_, base_);
+    }
+    if ( 1 != EVP_MD_CTX_copy_ex(sha256_, a_context) ) {
+        throw ::cc::Exception("%s", "Unable to restore SHA256 context!");
+    }
+    hashed_ = a_hashed;
+}
+
+/**
+ * @brief Set signature beacon to search for.
+ *
+ * @param a_beacon See PdfSignOutputDevice::GetSignatureBeacon.
+ */
+void casper::pdf::podofo::OutputDevice::SetBeacon (const ::PoDoFo::PdfData& a_beacon)
+{
+    beacon_          = a_beacon.data();
+    beacon_found_    = false;
+    beacon_position_ = 0;
+}
+
+/**
+ * @brief Calculate /ByteRange, must match the one written by PdfSignOutputDevice::AdjustByteRange.
+ *
+ * @param o_range See \link ByteRange \link.
+ */
+void casper::pdf::podofo::OutputDevice::GetByteRange (pdf::ByteRange& o_range) const
+{
+    if ( false == beacon_found_ ) {
+        throw ::cc::Exception("%s", "Cannot find signature position in the document!");
+    }
+    const size_t end = base_ + increment_.length();
+    o_range.before_start_ = 0;
+    o_range.before_size_  = beacon_position_;
+    o_range.after_start_  = beacon_position_ + beacon_.length() + 2;
+    o_range.after_size_   = end - o_range.after_start_;
+}
+
+/**
+ * @brief Calculate digest of the original document bytes hashed so far, without finalizing the context.
+ *
+ * @param o_digest SHA256 Base 64 encoded calculated digest value.
+ */
+void casper::pdf::podofo::OutputDevice::Snapshot (std::string& o_digest) const
+{
+    if ( false == digest_ ) {
+        throw ::cc::Exception("%s", "Digest calculation is not enabled!");
+    }
+    EVP_MD_CTX*   copy   = EVP_MD_CTX_new();
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int  length = 0;
+    const bool    ok     = ( nullptr != copy && 1 == EVP_MD_CTX_copy_ex(copy, sha256_) && 1 == EVP_DigestFinal_ex(copy, md, &length) );
+    if ( nullptr != copy ) {
+        EVP_MD_CTX_free(copy);
+    }
+    if ( false == ok ) {
+        throw ::cc::Exception("%s", "Unable to calculate SHA256 digest!");
+    }
+    Encode(md, length, o_digest);
+}
+
+/**
+ * @brief Finalize /ByteRange digest calculation.
+ *
+ * @param o_digest SHA256 Base 64 encoded calculated digest value.
+ */
+void casper::pdf::podofo::OutputDevice::Digest (std::string& o_digest)
+{
+    if ( false == digest_ ) {
+        throw ::cc::Exception("%s", "Digest calculation is not enabled!");
+    }
+    if ( true == prefix_modified_ || hashed_ != base_ ) {
+        throw ::cc::Exception("Unable to calculate digest - original document bytes " SIZET_FMT " hashed vs " SIZET_FMT " expected%s!",
+                              hashed_, base_, ( true == prefix_modified_ ? " and modified" : "" ));
+    }
+    
+    pdf::ByteRange range;
+    GetByteRange(range);
+    
+    if ( range.before_size_ < base_ || range.after_start_ > base_ + increment_.length() ) {
+        throw ::cc::Exception("%s", "Unable to calculate digest - signature beacon is not part of the incremental update!");
+    }
+    
+    // ... original document bytes are already hashed, add incremental update skipping /Contents ...
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(increment_.c_str());
+    unsigned char        md[EVP_MAX_MD_SIZE];
+    unsigned int         length = 0;
+    if (    1 != EVP_DigestUpdate(sha256_, bytes, range.before_size_ - base_)
+         || 1 != EVP_DigestUpdate(sha256_, bytes + ( range.after_start_ - base_ ), range.after_size_)
+         || 1 != EVP_DigestFinal_ex(sha256_, md, &length) ) {
+        throw ::cc::Exception("%s", "Unable to calculate SHA256 digest!");
+    }
+    
+    Encode(md, length, o_digest);
+}
+
+// MARK: - [PRIVATE] - Static Method(s) / Function(s)
+
+/**
+ * @brief Base 64 ( RFC 4648 ) encode a message digest.
+ *
+ * @param a_md     Message digest.
+ * @param a_length Message digest length, in bytes.
+ * @param o_digest Base 64 encoded message digest.
+ */
+void casper::pdf::podofo::OutputDevice::Encode (const unsigned char* a_md, const unsigned int a_length, std::string& o_digest)
+{
+    unsigned char encoded[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+    const int     length = EVP_EncodeBlock(encoded, a_md, static_cast<int>(a_length));
+    o_digest = std::string(reinterpret_cast<const char*>(encoded), static_cast<size_t>(length));
+}
@@ -0,0 +1,130 @@
+/**
+ * @file output_device.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_PDF_PODOFO_OUTPUT_DEVICE_H_
+#define CASPER_PDF_PODOFO_OUTPUT_DEVICE_H_
+
+#include "cc/non-copyable.h"
+#include "cc/non-movable.h"
+
+#include <string>
+
+#include <openssl/evp.h>
+
+#include "casper/pdf/types.h"
+#include "casper/pdf/podofo/includes.h"
+
+namespace casper
+{
+
+    namespace pdf
+    {
+
+        namespace podofo
+        {
+        
+            /**
+             * @brief An output device that sits between \link PdfSignOutputDevice \link and the real device,
+             *        keeping track of the incremental update bytes and of the signature beacon position so
+             *        that /ByteRange and it's digest can be known without reading the document again; the
+             *        beacon itself is written as '0' characters so /Contents is in it's final placeholder form.
+             *
+             *        When an offset is provided, the real device only receives the incremental update: PoDoFo
+             *        sees positions as if the original document bytes were there.
+             */
+            class OutputDevice final : public ::PoDoFo::PdfOutputDevice, public ::cc::NonCopyable, public ::cc::NonMovable
+            {
+                
+            private: // Data
+                
+                ::PoDoFo::PdfOutputDevice* device_;          //!< Real device, not owned.
+                const bool                 digest_;          //!< When true, SHA256 is calculated.
+                const size_t               offset_;          //!< Logical position of real device first byte.
+                size_t                     base_;            //!< Position where incremental update starts.
+                size_t                     hashed_;          //!< Number of bytes, before base_, already hashed.
+                bool                       prefix_modified_; //!< True if something was written before base_.
+                std::string                increment_;       //!< Copy of all bytes written at or after base_.
+                std::string                beacon_;          //!< Signature beacon.
+                size_t                     beacon_position_; //!< Position of '<' that precedes beacon.
+                bool                       beacon_found_;    //!< True when beacon was written.
+                EVP_MD_CTX*                sha256_;          //!< SHA256 context.
+                
+            public: // Constructor(s) / Destructor
+                
+                OutputDevice () = delete;
+                OutputDevice (::PoDoFo::PdfOutputDevice* a_device, const bool a_digest, const size_t a_offset = 0);
+                
+                virtual ~OutputDevice ();
+                
+            public: // Inherited Method(s) / Function(s) from ::PoDoFo::PdfOutputDevice
+                
+                virtual size_t GetLength () const;
+                virtual void   Print     (const char* a_format, ...);
+                virtual void   PrintV    (const char* a_format, long a_length, va_list a_args);
+                virtual void   Write     (const char* a_buffer, size_t a_length);
+                virtual size_t Read      (char* a_buffer, size_t a_length);
+                virtual void   Seek      (size_t a_offset);
+                virtual size_t Tell      () const;
+                virtual void   Flush     ();
+                
+            public: // Method(s) / Function(s)
+                
+                void Hash         (const unsigned char* a_bytes, const size_t a_size);
+                void Save         (EVP_MD_CTX* o_context) const;
+                void Restore      (const EVP_MD_CTX* a_context, const size_t a_hashed);
+                void SetBeacon    (const ::PoDoFo::PdfData& a_beacon);
+                void GetByteRange (pdf::ByteRange& o_range) const;
+                void Snapshot     (std::string& o_digest) const;
+                void Digest       (std::string& o_digest);
+                
+            private: // Static Method(s) / Function(s)
+                
+                static void Encode (const unsigned char* a_md, const unsigned int a_length, std::string& o_digest);
+                
+            public: // Inline Method(s) / Function(s)
+                
+                size_t base   () const;
+                size_t hashed () const;
+                
+            }; // end of class 'OutputDevice'
+        
+            /**
+             * @return Position where the incremental update starts.
+             */
+            inline size_t OutputDevice::base () const
+            {
+                return base_;
+            }
+        
+            /**
+             * @return Number of original document bytes already hashed.
+             */
+            inline size_t OutputDevice::hashed () const
+            {
+                return hashed_;
+            }
+        
+        } // end of namespace 'podofo'
+
+    } // end of namespace 'pdf'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_PDF_PODOFO_OUTPUT_DEVICE_H_
@@ -29,6 +29,9 @@
 
 #include "cc/debug/types.h" //  CC_DEBUG_ON
 
+#include <chrono> // std::chrono::steady_clock
+#include <deque>
+
 #include "casper/pdf/podofo/annotation.h"
 #include "version.h"
 
@@ -41,6 +44,10 @@ const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_byte_rage_key_ = ::PoDoF
 const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_t_key_         = ::PoDoFo::PdfName("T");
 const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_ft_key_        = ::PoDoFo::PdfName("FT");
 const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_p_key_         = ::PoDoFo::PdfName("P");
+const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_kids_key_      = ::PoDoFo::PdfName("Kids");
+const ::PoDoFo::PdfName casper::pdf::podofo::Writer::sk_annots_key_    = ::PoDoFo::PdfName("Annots");
+
+const size_t casper::pdf::podofo::Writer::sk_max_field_depth_ = 64;
 
 // MARK: -
 
@@ -55,6 +62,20 @@ casper::pdf::podofo::Writer::Writer (const std::string& a_name)
     document_handler_ = nullptr;
     output_handler_   = nullptr;
     sign_handler_     = nullptr;
+    device_handler_   = nullptr;
+    buffer_handler_   = nullptr;
+    memory_           = nullptr;
+    memory_size_      = 0;
+    calculate_digest_ = false;
+    digest_cache_     = nullptr;
+    original_size_    = 0;
+    io_settings_      = { io::File::Backend::MMap, 65536, 4 };
+    copy_strategy_    = io::File::CopyStrategy::None;
+    delta_only_       = false;
+    delta_            = { 0, "" };
+    load_on_demand_   = false;
+    load_us_          = 0;
+    fields_indexed_   = false;
 }
 
 /**
@@ -71,6 +92,12 @@ casper::pdf::podofo::Writer::~Writer ()
     if ( nullptr != sign_handler_ ) {
         delete sign_handler_;
     }
+    if ( nullptr != device_handler_ ) {
+        delete device_handler_;
+    }
+    if ( nullptr != buffer_handler_ ) {
+        delete buffer_handler_;
+    }
 }
 
 // MARK: -
@@ -95,23 +122,145 @@ void casper::pdf::podofo::Writer::Open (const std::string& a_io)
 void casper::pdf::podofo::Writer::Open (const std::string& a_in, const std::string& a_out, const bool /* a_overwrite */)
 {
     // ... already open?
-    if ( nullptr != document_handler_ || nullptr != output_handler_ || nullptr != sign_handler_ ) {
+    if ( nullptr != document_handler_ || nullptr != output_handler_ || nullptr != sign_handler_ || nullptr != device_handler_ || nullptr != buffer_handler_ ) {
         throw ::cc::Exception("Document is already open!");
     }
+    digest_        = "";
+    copy_strategy_ = io::File::CopyStrategy::None;
+    delta_         = { 0, "" };
     // ... prepare ...
+    io::File*   file    = nullptr;
+    EVP_MD_CTX* context = nullptr;
     try {
+        const auto start = std::chrono::steady_clock::now();
         document_handler_ = new ::PoDoFo::PdfMemDocument();
         document_handler_->Load(a_in.c_str(), /* bForUpdate */ true);
-        // ... an existing copy is required ...
-        if ( a_out != a_in ) {
-            if ( false == cc::fs::File::Exists(a_out) ) {
-                cc::fs::File::Copy(a_in, a_out);
-            } else {
-                cc::fs::File::Copy(a_in, a_out, 0 == cc::fs::File::Size(a_out));
+        load_us_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        size_t offset = 0;
+        size_t hashed = 0;
+        if ( true == calculate_digest_ ) {
+            original_size_ = cc::fs::File::Size(a_in);
+            context        = EVP_MD_CTX_new();
+            if ( nullptr == context || 1 != EVP_DigestInit_ex(context, EVP_sha256(), nullptr) ) {
+                throw ::cc::Exception("%s", "Unable to initialize SHA256 context!");
+            }
+            // ... resume from a previously saved SHA256 state, if any, it's bytes can't have changed ...
+            if ( nullptr != digest_cache_ && false == digest_cache_->Restore(a_in, original_size_, context, hashed) ) {
+                hashed = 0;
+            }
+        }
+        if ( true == delta_only_ ) {
+            // ... only the incremental update will be written, original document bytes are at a_in ...
+            if ( a_out == a_in ) {
+                throw ::cc::Exception("%s", "Delta output must not be the original document!");
+            }
+            offset          = cc::fs::File::Size(a_in);
+            output_handler_ = new ::PoDoFo::PdfOutputDevice(a_out.c_str(), /* bTruncate */ true);
+        } else {
+            // ... an existing copy is required, let the filesystem do it ( no data movement when reflinks are supported ) ...
+            if ( a_out != a_in ) {
+                const bool exists = cc::fs::File::Exists(a_out);
+                if ( true == exists && 0 != cc::fs::File::Size(a_out) ) {
+                    throw ::cc::Exception("Unable to copy '%s' to '%s' - destination file already exists!", a_in.c_str(), a_out.c_str());
+                }
+                // ... when bytes are copied in userspace, hash them on the way ...
+                size_t copied = 0;
+                copy_strategy_ = io::File::Copy(a_in, a_out, /* a_overwrite */ exists, [context, hashed, &copied] (const unsigned char* a_bytes, const size_t& a_size) {
+                    if ( nullptr != context && copied + a_size > hashed ) {
+                        const size_t skip = ( copied < hashed ? hashed - copied : 0 );
+                        if ( 1 != EVP_DigestUpdate(context, a_bytes + skip, a_size - skip) ) {
+                            throw ::cc::Exception("%s", "Unable to update SHA256 context!");
+                        }
+                    }
+                    copied += a_size;
+                });
+                if ( nullptr != context && io::File::CopyStrategy::ReadWrite == copy_strategy_ ) {
+                    hashed = copied;
+                }
+            }
+            output_handler_ = new ::PoDoFo::PdfOutputDevice(a_out.c_str(), /* bTruncate */ false);
+        }
+        device_handler_ = new podofo::OutputDevice(output_handler_, calculate_digest_, offset);
+        if ( true == calculate_digest_ ) {
+            if ( 0 != hashed ) {
+                device_handler_->Restore(context, hashed);
+            }
+            // ... hash remaining original document, if not copied in userspace, it was just loaded ( or copied in kernel ) so it should be served from page cache ...
+            if ( hashed < original_size_ ) {
+                file = io::File::New(io_settings_);
+                file->Open(a_in, io::File::Mode::Read);
+                file->Read(hashed, original_size_ - hashed, [this] (const unsigned char* a_bytes, const size_t& a_size) {
+                    device_handler_->Hash(a_bytes, a_size);
+                });
+                file->Close();
+                delete file;
+                file = nullptr;
+            }
+            // ... save SHA256 state for next digest of this document, or of it's copy ...
+            if ( nullptr != digest_cache_ ) {
+                device_handler_->Save(context);
+                digest_cache_->Save(a_in, original_size_, context);
+                if ( false == delta_only_ && a_out != a_in ) {
+                    digest_cache_->Save(a_out, original_size_, context);
+                }
             }
+            EVP_MD_CTX_free(context);
+            context  = nullptr;
+            out_uri_ = ( false == delta_only_ ? a_out : "" );
+        }
+        if ( true == delta_only_ ) {
+            delta_.original_size_ = offset;
+            device_handler_->Snapshot(delta_.original_digest_);
+        }
+        sign_handler_ = new ::PoDoFo::PdfSignOutputDevice(device_handler_);
+    } catch (const ::PoDoFo::PdfError& a_error) {
+        delete file;
+        EVP_MD_CTX_free(context);
+        Close();
+        throw ::cc::Exception("PoDoFo Error: %4d - %s", a_error.GetError(), ::PoDoFo::PdfError::ErrorMessage(a_error.GetError()));
+    } catch (...) {
+        delete file;
+        EVP_MD_CTX_free(context);
+        Close();
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+/**
+ * @brief Open a PDF document, already in memory, writing any change to an in-memory buffer - see \link Output \link.
+ *
+ * @param a_bytes PDF document bytes, must remain valid until \link Close \link is called.
+ * @param a_size  PDF document size, in bytes.
+ */
+void casper::pdf::podofo::Writer::Open (const unsigned char* a_bytes, const size_t a_size)
+{
+    // ... already open?
+    if ( nullptr != document_handler_ || nullptr != output_handler_ || nullptr != sign_handler_ || nullptr != device_handler_ || nullptr != buffer_handler_ ) {
+        throw ::cc::Exception("Document is already open!");
+    }
+    digest_        = "";
+    copy_strategy_ = io::File::CopyStrategy::None;
+    delta_         = { 0, "" };
+    // ... prepare ...
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        document_handler_ = new ::PoDoFo::PdfMemDocument();
+        document_handler_->LoadFromBuffer(reinterpret_cast<const char*>(a_bytes), static_cast<long>(a_size), /* bForUpdate */ true);
+        load_us_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        // ... only the incremental update is written to memory, original document bytes are not copied ...
+        memory_         = a_bytes;
+        memory_size_    = a_size;
+        buffer_handler_ = new ::PoDoFo::PdfRefCountedBuffer();
+        output_handler_ = new ::PoDoFo::PdfOutputDevice(buffer_handler_);
+        device_handler_ = new podofo::OutputDevice(output_handler_, calculate_digest_, a_size);
+        if ( true == calculate_digest_ ) {
+            device_handler_->Hash(a_bytes, a_size);
+        }
+        if ( true == delta_only_ ) {
+            delta_.original_size_ = a_size;
+            device_handler_->Snapshot(delta_.original_digest_);
         }
-        output_handler_ = new ::PoDoFo::PdfOutputDevice(a_out.c_str(), /* bTruncate */ false);
-        sign_handler_   = new ::PoDoFo::PdfSignOutputDevice(output_handler_);
+        sign_handler_ = new ::PoDoFo::PdfSignOutputDevice(device_handler_);
     } catch (const ::PoDoFo::PdfError& a_error) {
         Close();
         throw ::cc::Exception("PoDoFo Error: %4d - %s", a_error.GetError(), ::PoDoFo::PdfError::ErrorMessage(a_error.GetError()));
@@ -121,12 +270,81 @@ void casper::pdf::podofo::Writer::Open (const std::string& a_in, const std::stri
     }
 }
 
+/**
+ * @brief Copy in-memory output, must be called after \link Append \link and before \link Close \link.
+ *
+ * @param o_buffer Original document followed by the incremental update, or just the incremental update when in delta mode.
+ */
+void casper::pdf::podofo::Writer::Output (std::vector<unsigned char>& o_buffer) const
+{
+    if ( nullptr == buffer_handler_ || nullptr == output_handler_ ) {
+        throw ::cc::Exception("Document is not open in memory!");
+    }
+    const unsigned char* increment = reinterpret_cast<const unsigned char*>(buffer_handler_->GetBuffer());
+    const size_t         length    = output_handler_->GetLength();
+    o_buffer.clear();
+    if ( false == delta_only_ ) {
+        o_buffer.reserve(memory_size_ + length);
+        o_buffer.insert(o_buffer.end(), memory_, memory_ + memory_size_);
+    }
+    o_buffer.insert(o_buffer.end(), increment, increment + length);
+}
+
+/**
+ * @brief Calculate /ByteRange digest while opening the original document and writing the incremental update.
+ *
+ * @param a_settings I/O settings to use when reading the original document.
+ * @param a_cache    Optional SHA256 state cache, not owned, used to skip already hashed original document bytes.
+ */
+void casper::pdf::podofo::Writer::EnableDigest (const io::File::Settings& a_settings, pdf::DigestCache* a_cache)
+{
+    // ... must be set before open ...
+    if ( nullptr != document_handler_ ) {
+        throw ::cc::Exception("Document is already open!");
+    }
+    calculate_digest_ = true;
+    digest_cache_     = a_cache;
+    io_settings_      = a_settings;
+}
+
+/**
+ * @brief Write only the incremental update to output, original document bytes are hashed and
+ *        it's size and digest are kept so that output can be later appended to the original document.
+ *
+ * @param a_settings I/O settings to use when reading the original document.
+ * @param a_cache    Optional SHA256 state cache, not owned, used to skip already hashed original document bytes.
+ */
+void casper::pdf::podofo::Writer::EnableDelta (const io::File::Settings& a_settings, pdf::DigestCache* a_cache)
+{
+    EnableDigest(a_settings, a_cache);
+    delta_only_ = true;
+}
+
+/**
+ * @brief Only keep in memory the objects that must be changed.
+ *
+ *        PoDoFo parses objects when they're first dereferenced; when enabled, existing fields that are only
+ *        inspected while searching by name are released right after, and signature page is resolved from the
+ *        widget /P reference instead of walking ( and caching ) every page of the page tree.
+ *
+ * @param a_enabled True to enable, false otherwise.
+ */
+void casper::pdf::podofo::Writer::EnableLoadOnDemand (const bool a_enabled)
+{
+    // ... must be set before open ...
+    if ( nullptr != document_handler_ ) {
+        throw ::cc::Exception("Document is already open!");
+    }
+    load_on_demand_ = a_enabled;
+}
+
 /**
  * @brief Append a signature placeholder.
  *
  * @param a_annotation Annotation properties.
+ * @param o_range      /ByteRange, as written by sign device.
  */
-void casper::pdf::podofo::Writer::Append (const pdf::SignatureAnnotation& a_annotation)
+void casper::pdf::podofo::Writer::Append (const pdf::SignatureAnnotation& a_annotation, pdf::ByteRange& o_range)
 {
     // ... document must be open ..
     if ( nullptr == document_handler_ ) {
@@ -219,6 +437,7 @@ void casper::pdf::podofo::Writer::Append (const pdf::SignatureAnnotation& a_anno
         signature_field->SetSignatureReason(::PoDoFo::PdfString(reinterpret_cast<const ::PoDoFo::pdf_utf8*>(a_annotation.info().reason_.c_str())));
         signature_field->SetSignatureDate(::PoDoFo::PdfDate(cc::time::PARSE_YYMMDDHHMMSSZ(a_annotation.info().utc_date_time_.c_str())));
         signature_field->SetSignature(*sign_handler_->GetSignatureBeacon());
+        device_handler_->SetBeacon(*sign_handler_->GetSignatureBeacon());
         signature_field->SetSignatureCreator(::PoDoFo::PdfName(name_));
 
         // ... write new objects ...
@@ -236,6 +455,14 @@ void casper::pdf::podofo::Writer::Append (const pdf::SignatureAnnotation& a_anno
         // ... write new contents ...
         sign_handler_->Flush();
         
+        // ... /ByteRange is known by now, no need to parse output ...
+        device_handler_->GetByteRange(o_range);
+        
+        // ... original document was already hashed, finish it with the incremental update ...
+        if ( true == calculate_digest_ ) {
+            device_handler_->Digest(digest_);
+        }
+        
         delete signature_field;
         
     } catch (const ::cc::Exception& a_cc_exception) {
@@ -268,6 +495,25 @@ void casper::pdf::podofo::Writer::Close ()
         delete sign_handler_;
         sign_handler_ = nullptr;
     }
+    if ( nullptr != device_handler_ ) {
+        delete device_handler_;
+        device_handler_ = nullptr;
+    }
+    if ( nullptr != buffer_handler_ ) {
+        delete buffer_handler_;
+        buffer_handler_ = nullptr;
+    }
+    memory_      = nullptr;
+    memory_size_ = 0;
+    // ... fields index is only valid for the document it was built from ...
+    fields_.clear();
+    fields_indexed_ = false;
+    // ... incremental update was appended after original document bytes, saved SHA256 state is still valid ...
+    if ( nullptr != digest_cache_ && 0 != out_uri_.length() ) {
+        digest_cache_->Touch(out_uri_, original_size_);
+    }
+    out_uri_       = "";
+    original_size_ = 0;
 }
 
 
@@ -277,6 +523,7 @@ void casper::pdf::podofo::Writer::GetByteRange (const std::string& a_in, pdf::Si
 {
     ::PoDoFo::PdfSignatureField* disposable_signature_field = nullptr;
     ::PoDoFo::PdfAnnotation*     disposable_annotation      = nullptr;
+    ::PoDoFo::PdfPage*           disposable_page            = nullptr;
     
     try {
         
@@ -295,12 +542,26 @@ void casper::pdf::podofo::Writer::GetByteRange (const std::string& a_in, pdf::Si
         }
         
         // ... get signature page ...
-        const ::PoDoFo::PdfPage* ref_page = GetExistingSignaturePage(acro_form, a_annotation.name_);
-        if ( nullptr == ref_page ) {
-            throw ::cc::Exception("%s", "Signature reference page not found!");
+        ::PoDoFo::PdfPage* sig_page = nullptr;
+        if ( true == load_on_demand_ ) {
+            // ... only the page object is needed, don't load the whole page tree - /P is optional, page tree is searched without it ...
+            const ::PoDoFo::PdfObject* p_object    = sig_object->GetDictionary().GetKey(sk_p_key_);
+            ::PoDoFo::PdfObject*       page_object = nullptr;
+            if ( nullptr != p_object && true == p_object->IsReference() ) {
+                page_object = document_handler_->GetObjects()->GetObject(p_object->GetReference());
+            }
+            if ( nullptr != page_object ) {
+                disposable_page = new ::PoDoFo::PdfPage(page_object, std::deque<::PoDoFo::PdfObject*>());
+                sig_page        = disposable_page;
+            }
+        }
+        if ( nullptr == sig_page ) {
+            const ::PoDoFo::PdfPage* ref_page = GetExistingSignaturePage(acro_form, a_annotation.name_);
+            if ( nullptr == ref_page ) {
+                throw ::cc::Exception("%s", "Signature reference page not found!");
+            }
+            sig_page = const_cast<::PoDoFo::PdfPage*>(ref_page);
         }
-        
-        ::PoDoFo::PdfPage* sig_page = const_cast<::PoDoFo::PdfPage*>(ref_page);
         
         disposable_annotation      = new ::PoDoFo::PdfAnnotation(const_cast<::PoDoFo::PdfObject*>(sig_object), sig_page);
         disposable_signature_field = new ::PoDoFo::PdfSignatureField(disposable_annotation);
@@ -322,6 +583,9 @@ void casper::pdf::podofo::Writer::GetByteRange (const std::string& a_in, pdf::Si
         delete disposable_annotation;
         disposable_annotation = nullptr;
         
+        delete disposable_page;
+        disposable_page = nullptr;
+        
     } catch (const ::PoDoFo::PdfError& a_error) {
         throw ::cc::Exception("PoDoFo Error: %4d - %s", a_error.GetError(), ::PoDoFo::PdfError::ErrorMessage(a_error.GetError()));
     } catch (const ::cc::Exception& a_cc_exception) {
@@ -331,6 +595,9 @@ void casper::pdf::podofo::Writer::GetByteRange (const std::string& a_in, pdf::Si
         if ( nullptr != disposable_annotation ) {
             delete disposable_annotation;
         }
+        if ( nullptr != disposable_page ) {
+            delete disposable_page;
+        }
         Close();
         throw a_cc_exception;
     }
@@ -342,71 +609,133 @@ void casper::pdf::podofo::Writer::GetByteRange (const std::string& a_in, pdf::Si
  * @brief Search for 'signature field' object.
  *
  * @param a_form Acro form object.
- * @param a_name Field name.
+ * @param a_name Field fully qualified name.
  * @param a_type Field type.
  */
 ::PoDoFo::PdfObject* casper::pdf::podofo::Writer::GetFieldObject (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name, const ::PoDoFo::PdfName& a_type) const
 {
-    // ... search for specifc signature field by name ...
+    // ... index is built only once per open document ...
+    if ( false == fields_indexed_ ) {
+        IndexFields(a_form);
+    }
+    
+    const auto it = fields_.find(a_name.GetStringUtf8());
+    if ( fields_.end() == it ) {
+        // ... not found ...
+        return nullptr;
+    }
+    
+    // ...  'FT ' MUST exist ...
+    if ( 0 == it->second.type_.GetLength() ) {
+        throw ::cc::Exception("FT item not found!");
+    }
+    
+    // ... a field with the provided name was found ...
+    if ( it->second.type_ == a_type ) {
+        // ... and it's a signature field ..
+        return it->second.object_;
+    }
+    
+    // ... not found ...
+    return nullptr;
+}
+
+/**
+ * @brief Build form fields index, by fully qualified name.
+ *
+ * @param a_form Acro form object.
+ */
+void casper::pdf::podofo::Writer::IndexFields (::PoDoFo::PdfAcroForm* a_form) const
+{
+    fields_.clear();
+    fields_indexed_ = true;
+    
     const ::PoDoFo::PdfDictionary& dictionary = a_form->GetObject()->GetDictionary();
     const ::PoDoFo::PdfObject*     fields     = dictionary.GetKey(sk_fields_key_);
-    const ::PoDoFo::PdfVecObjects* objects    = a_form->GetDocument()->GetObjects();
     
     // ... it' a reference?
-    if ( ::PoDoFo::ePdfDataType_Reference == fields->GetDataType() ) {
+    if ( nullptr != fields && ::PoDoFo::ePdfDataType_Reference == fields->GetDataType() ) {
         // ... fetch actual object ...
-        fields = objects->GetObject(fields->GetReference());
+        fields = a_form->GetDocument()->GetObjects()->GetObject(fields->GetReference());
     }
     
     // ... not found or not an array?
     if ( nullptr == fields || ::PoDoFo::ePdfDataType_Array != fields->GetDataType() ) {
         // ... done ...
-        return nullptr;
+        return;
     }
+    
+    std::set<::PoDoFo::PdfReference> visited;
+    IndexFields(fields->GetArray(), "", ::PoDoFo::PdfName(), 0, visited);
+}
+
+/**
+ * @brief Index form fields and their /Kids.
+ *
+ * @param a_fields  Fields array.
+ * @param a_prefix  Parent fully qualified name, empty for root fields.
+ * @param a_type    Parent field type, empty if not set.
+ * @param a_depth   Parent depth, deeper subtrees are not indexed.
+ * @param a_visited References of the fields already visited, /Kids cycles are skipped.
+ */
+void casper::pdf::podofo::Writer::IndexFields (const ::PoDoFo::PdfArray& a_fields, const std::string& a_prefix, const ::PoDoFo::PdfName& a_type,
+                                               const size_t a_depth, std::set<::PoDoFo::PdfReference>& a_visited) const
+{
+    const ::PoDoFo::PdfVecObjects* objects = document_handler_->GetObjects();
+    for ( auto idx = 0 ; idx < a_fields.size() ; ++idx ) {
         
-    const ::PoDoFo::PdfArray& rArray = fields->GetArray();
-    for ( auto idx = 0 ; idx < rArray.size() ; ++idx) {
-        
-        const auto it = rArray[idx];
-        // ... we're searchinf for a referece ...
+        const auto it = a_fields[idx];
+        // ... we're searching for a reference ...
         if ( ::PoDoFo::ePdfDataType_Reference != it.GetDataType() ) {
             // ... not it, next ...
             continue;
         }
-                
-        // ... ensure 'T' item exists ...
-        ::PoDoFo::PdfObject *item = objects->GetObject(it.GetReference());
-        if ( nullptr == item || false == item->GetDictionary().HasKey(sk_t_key_) || a_name != item->GetDictionary().GetKey(sk_t_key_)->GetString() ) {
-            // ... not found, next ...
+        
+        // ... already visited?
+        if ( false == a_visited.insert(it.GetReference()).second ) {
             continue;
         }
         
-        // ... a field with the searching name was found, search for 'FT' item ...
-        const ::PoDoFo::PdfObject *pFT = item->GetDictionary().GetKey(sk_ft_key_);
-        if ( nullptr == pFT && true == item->GetDictionary().HasKey(sk_parent_key_) ) {
+        // ... widgets without 'T' item belong to their parent field ...
+        ::PoDoFo::PdfObject* item = objects->GetObject(it.GetReference());
+        if ( nullptr == item || false == item->IsDictionary() || false == item->GetDictionary().HasKey(sk_t_key_) ) {
+            continue;
+        }
+        
+        const ::PoDoFo::PdfDictionary& dictionary = item->GetDictionary();
+        const std::string              partial    = dictionary.GetKey(sk_t_key_)->GetString().GetStringUtf8();
+        const std::string              name       = ( 0 == a_prefix.length() ? partial : a_prefix + "." + partial );
+        
+        // ... 'FT' item is inheritable ...
+        ::PoDoFo::PdfName          type = a_type;
+        const ::PoDoFo::PdfObject* pFT  = dictionary.GetKey(sk_ft_key_);
+        if ( nullptr == pFT && 0 == a_depth && true == dictionary.HasKey(sk_parent_key_) ) {
             const ::PoDoFo::PdfObject *pTemp = item->GetIndirectKey(sk_parent_key_);
             if ( nullptr == pTemp ) {
                 throw ::cc::Exception("Invalid data type found while searching form FT item!");
             }
             pFT = pTemp->GetDictionary().GetKey(sk_ft_key_);
         }
+        if ( nullptr != pFT && true == pFT->IsName() ) {
+            type = pFT->GetName();
+        }
         
-        // ...  'FP ' MUST exist ...
-        if ( nullptr == pFT ) {
-            throw ::cc::Exception("FT item not found!");
+        // ... non-terminal field?
+        const ::PoDoFo::PdfObject* kids = item->GetIndirectKey(sk_kids_key_);
+        if ( nullptr != kids && true == kids->IsArray() && a_depth + 1 < sk_max_field_depth_ ) {
+            IndexFields(kids->GetArray(), name, type, a_depth + 1, a_visited);
         }
         
-        // ... a field with the provided name was found ...
-        const ::PoDoFo::PdfName fieldType = pFT->GetName();
-        if ( fieldType == a_type ) {
-            // ... and it's a signature field ..
-            return item;
+        // ... first one wins ...
+        if ( fields_.end() == fields_.find(name) ) {
+            fields_[name] = { item, type };
+        }
+        
+        // ... release it ( it will be parsed again if needed ) ...
+        if ( true == load_on_demand_ && sk_sig_key_ != type ) {
+            document_handler_->FreeObjectMemory(item);
         }
-
     }
-
-    // ... not found ...
-    return nullptr;
 }
 
 /**
@@ -445,17 +774,36 @@ const ::PoDoFo::PdfObject* casper::pdf::podofo::Writer::GetExistingSignatureObje
  * @param a_form Acro form object.
  * @param a_name Signature name.
  *
- * @return Page object.
+ * @return Page object, nullptr if not found.
  */
 const ::PoDoFo::PdfPage* casper::pdf::podofo::Writer::GetExistingSignaturePage (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name) const
 {
     const ::PoDoFo::PdfObject* object = GetExistingSignatureObject(a_form, a_name);
-    if ( false == object->GetDictionary().HasKey(sk_p_key_) ) {
-        throw ::cc::Exception("Signature object named '%s' doesn't have a page reference!",
-                              a_name.GetString()
-        );
+    if ( nullptr == object ) {
+        return nullptr;
     }
-    return document_handler_->GetPagesTree()->GetPage(object->GetDictionary().GetKey(sk_p_key_)->GetReference());
+    // ... /P is optional for widget annotations ...
+    const ::PoDoFo::PdfObject* p_object = object->GetDictionary().GetKey(sk_p_key_);
+    if ( nullptr != p_object && true == p_object->IsReference() ) {
+        const ::PoDoFo::PdfPage* page = document_handler_->GetPagesTree()->GetPage(p_object->GetReference());
+        if ( nullptr != page ) {
+            return page;
+        }
+    }
+    // ... search for the widget in pages /Annots ...
+    for ( int idx = 0 ; idx < document_handler_->GetPageCount() ; ++idx ) {
+        const ::PoDoFo::PdfPage*   page   = document_handler_->GetPage(idx);
+        const ::PoDoFo::PdfObject* annots = ( nullptr != page ? page->GetObject()->GetIndirectKey(sk_annots_key_) : nullptr );
+        if ( nullptr == annots || false == annots->IsArray() ) {
+            continue;
+        }
+        for ( const auto& item : annots->GetArray() ) {
+            if ( true == item.IsReference() && object->Reference() == item.GetReference() ) {
+                return page;
+            }
+        }
+    }
+    return nullptr;
 }
 
 /**
@@ -22,9 +22,16 @@
 #define CASPER_PDF_PODOFO_WRITER_H_
 
 #include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "casper/io/file.h"
 
 #include "casper/pdf/writer.h"
+#include "casper/pdf/digest_cache.h"
 #include "casper/pdf/podofo/includes.h"
+#include "casper/pdf/podofo/output_device.h"
 
 namespace casper
 {
@@ -38,6 +45,13 @@ namespace casper
             class Writer final : public pdf::Writer
             {
                 
+            private: // Data Type(s)
+                
+                typedef struct {
+                    ::PoDoFo::PdfObject* object_; //!< Field object.
+                    ::PoDoFo::PdfName    type_;   //!< Field type ( /FT ), inherited if not set, empty if unknown.
+                } Field;
+                
             private: // Static Const Data
                 
                 static const ::PoDoFo::PdfName sk_fields_key_;
@@ -47,12 +61,32 @@ namespace casper
                 static const ::PoDoFo::PdfName sk_t_key_;
                 static const ::PoDoFo::PdfName sk_ft_key_;
                 static const ::PoDoFo::PdfName sk_p_key_;
+                static const ::PoDoFo::PdfName sk_kids_key_;
+                static const ::PoDoFo::PdfName sk_annots_key_;
+                static const size_t            sk_max_field_depth_;
                 
             private: // Data
                 
-                ::PoDoFo::PdfMemDocument*      document_handler_;
-                ::PoDoFo::PdfOutputDevice*     output_handler_;
-                ::PoDoFo::PdfSignOutputDevice* sign_handler_;
+                ::PoDoFo::PdfMemDocument*            document_handler_;
+                ::PoDoFo::PdfOutputDevice*           output_handler_;
+                ::PoDoFo::PdfSignOutputDevice*       sign_handler_;
+                podofo::OutputDevice*                device_handler_;
+                ::PoDoFo::PdfRefCountedBuffer*       buffer_handler_;
+                const unsigned char*                 memory_;
+                size_t                               memory_size_;
+                bool                                 calculate_digest_;
+                pdf::DigestCache*                    digest_cache_;
+                std::string                          out_uri_;
+                size_t                               original_size_;
+                io::File::Settings                   io_settings_;
+                std::string                          digest_;
+                io::File::CopyStrategy               copy_strategy_;
+                bool                                 delta_only_;
+                pdf::Delta                           delta_;
+                bool                                 load_on_demand_;
+                uint64_t                             load_us_;
+                mutable std::map<std::string, Field> fields_; //!< Form fields by fully qualified name, built once per open document.
+                mutable bool                         fields_indexed_;
                 
             public: // Constructor(s) / Destructor
                 
@@ -65,12 +99,20 @@ namespace casper
                 
                 virtual void Open   (const std::string& a_in, const std::string& a_out, const bool a_overwrite = false);
                 virtual void Open   (const std::string& a_io);
-                virtual void Append (const SignatureAnnotation& a_annotation);
+                virtual void Append (const SignatureAnnotation& a_annotation, ByteRange& o_range);
                 virtual void Close  ();
                 
+            public: // In-Memory Method(s) / Function(s)
+                
+                void Open   (const unsigned char* a_bytes, const size_t a_size);
+                void Output (std::vector<unsigned char>& o_buffer) const;
+                
             private: // Helper(s)
                 
                       ::PoDoFo::PdfObject* GetFieldObject             (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name, const ::PoDoFo::PdfName& a_type) const;
+                void                       IndexFields                (::PoDoFo::PdfAcroForm* a_form) const;
+                void                       IndexFields                (const ::PoDoFo::PdfArray& a_fields, const std::string& a_prefix, const ::PoDoFo::PdfName& a_type,
+                                                                       const size_t a_depth, std::set<::PoDoFo::PdfReference>& a_visited) const;
                 bool                       SignatureObjectExists      (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name) const;
                 const ::PoDoFo::PdfObject* GetExistingSignatureObject (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name) const;
                 const ::PoDoFo::PdfPage*   GetExistingSignaturePage   (::PoDoFo::PdfAcroForm* a_form, const ::PoDoFo::PdfString& a_name) const;
@@ -78,7 +120,17 @@ namespace casper
                         
             public: // Method(s) / Function(s)
             
-                void GetByteRange (const std::string& a_in, pdf::SignatureAnnotation& a_annotation);
+                void EnableDigest       (const io::File::Settings& a_settings, pdf::DigestCache* a_cache = nullptr);
+                void EnableDelta        (const io::File::Settings& a_settings, pdf::DigestCache* a_cache = nullptr);
+                void EnableLoadOnDemand (const bool a_enabled);
+                void GetByteRange       (const std::string& a_in, pdf::SignatureAnnotation& a_annotation);
+                
+            public: // Inline Method(s) / Function(s)
+                
+                const std::string&            digest        () const;
+                const io::File::CopyStrategy& copy_strategy () const;
+                const pdf::Delta&             delta         () const;
+                const uint64_t&               load_us       () const;
                 
             public: // Static Method(s) / Function(s)
                 
@@ -88,7 +140,39 @@ namespace casper
                 
                 static void Demo (const std::string& a_uri);
 
-            }; // end of class 'Annotation'
+            }; // end of class 'Writer'
+        
+            /**
+             * @return R/O access to the strategy used to create output file by the last \link Open \link call.
+             */
+            inline const io::File::CopyStrategy& Writer::copy_strategy () const
+            {
+                return copy_strategy_;
+            }
+        
+            /**
+             * @return R/O access to original document info, set by the last \link Open \link call when in delta mode.
+             */
+            inline const pdf::Delta& Writer::delta () const
+            {
+                return delta_;
+            }
+        
+            /**
+             * @return R/O access to the time spent loading the document by the last \link Open \link call, in microseconds.
+             */
+            inline const uint64_t& Writer::load_us () const
+            {
+                return load_us_;
+            }
+        
+            /**
+             * @return R/O access to /ByteRange SHA256 Base 64 encoded digest, calculated by \link Append \link when enabled.
+             */
+            inline const std::string& Writer::digest () const
+            {
+                return digest_;
+            }
         
         } // end of namespace 'podofo'
 
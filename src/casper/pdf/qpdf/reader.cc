@@ -24,6 +24,8 @@
 #include "cc/exception.h"
 #include "cc/types.h"
 
+#include <algorithm> // std::sort
+
 // MARK: -
 
 const char* const casper::pdf::qpdf::Reader::sk_byte_range_err_msg_prefix_ = "Unable to obtain /Sig/ByteRange";
@@ -35,7 +37,9 @@ const char* const casper::pdf::qpdf::Reader::sk_byte_range_err_msg_prefix_ = "Un
  */
 casper::pdf::qpdf::Reader::Reader ()
 {
-    pdf_ = nullptr;
+    pdf_     = nullptr;
+    indexed_ = false;
+    pages_   = 0;
 }
 
 /**
@@ -64,6 +68,21 @@ void casper::pdf::qpdf::Reader::Open (const std::string& a_uri)
     pdf_->processFile(a_uri.c_str());
 }
 
+/**
+ * @brief Open a PDF document, already in memory, in read only mode.
+ *
+ * @param a_bytes PDF document bytes, must remain valid until \link Close \link is called.
+ * @param a_size  PDF document size, in bytes.
+ */
+void casper::pdf::qpdf::Reader::Open (const unsigned char* a_bytes, const size_t a_size)
+{
+    if ( nullptr != pdf_ ) {
+        throw cc::Exception("%s", "Can't load document, already in use ( close it first! )");
+    }
+    pdf_ = new QPDF();
+    pdf_->processMemoryFile("memory", reinterpret_cast<const char*>(a_bytes), a_size);
+}
+
 /**
  * @brief Read page count.
  *
@@ -89,6 +108,8 @@ size_t casper::pdf::qpdf::Reader::PageCount ()
 /**
  * @brief Search for the signature annotation widget and read it's /ByteRange.
  *
+ *        All pages are traversed only once per open document, by the first call.
+ *
  * @param a_page       Page number, if set it will search only in that page, -1 to search in all.
  * @param a_annotation Annotation to look for and where byte range will be set.
  *
@@ -100,51 +121,94 @@ bool casper::pdf::qpdf::Reader::GetByteRange (const ssize_t a_page, pdf::Signatu
         throw cc::Exception("%s", "Can't read byte range - document is not open!");
     }
     
-    QPDFAcroFormDocumentHelper afdh(*pdf_);
-    QPDFPageDocumentHelper     pdh(*pdf_);
+    if ( false == indexed_ ) {
+        Index();
+    }
     
-    pdf::SignatureAnnotation::ByteRange range;
+    // ... a_page : 1..n ...
+    if ( a_page > 0 && static_cast<size_t>(a_page) > pages_ ) {
+        throw cc::Exception("%s - page number " SIZET_FMT " not found!", sk_byte_range_err_msg_prefix_, a_page);
+    }
     
-    const std::vector<QPDFPageObjectHelper> pages = pdh.getAllPages();
+    const auto it = signatures_.find(a_annotation.name_);
+    if ( signatures_.end() == it ) {
+        // ... not found ...
+        return false;
+    }
     
-    // ... a_page : 1..n ...
-    if ( a_page < 0 ) { // ... backward lookup ...
-        // ... searching in all pages ...
-        for ( std::reverse_iterator<std::vector<QPDFPageObjectHelper>::const_iterator> page_iter = pages.rbegin(); page_iter != pages.rend(); ++page_iter ) {
-            // ... search in all available annotations on the current page ...
-            if ( true == GetByteRange(afdh, afdh.getWidgetAnnotationsForPage(*page_iter), a_annotation.name_, range) ) {
-                // ... set range ...
-                a_annotation.Set(range);
-                // ... found ...
-                return true;
+    // ... signatures are in page order ...
+    const Signature* signature = nullptr;
+    for ( const auto& candidate : it->second ) {
+        if ( a_page < 0 ) { // ... backward lookup, first one in the last page ...
+            if ( nullptr == signature || candidate.page_ > signature->page_ ) {
+                signature = &candidate;
             }
+        } else if ( 0 == a_page || static_cast<size_t>(a_page) == candidate.page_ ) { // ... forward or specific page lookup ...
+            signature = &candidate;
+            break;
         }
-    } else if ( 0 == a_page ) { // ... forward lookup ...
-        // ... searching in all pages ...
-        for ( std::vector<QPDFPageObjectHelper>::const_iterator page_iter = pages.begin(); page_iter != pages.end(); ++page_iter ) {
-            // ... search in all available annotations on the current page ...
-            if ( true == GetByteRange(afdh, afdh.getWidgetAnnotationsForPage(*page_iter), a_annotation.name_, range) ) {
-                // ... set range ...
-                a_annotation.Set(range);
-                // ... found ...
-                return true;
-            }
-        }
-    } else if ( a_page <= pages.size() ) { // ... specifc page lookup ...
-        const std::vector<QPDFPageObjectHelper>::const_iterator it = pages.begin() + static_cast<size_t>(a_page - 1);
-        // ... search in all available annotations on the current page ...
-        if ( true == GetByteRange(afdh, afdh.getWidgetAnnotationsForPage(*it), a_annotation.name_, range) ) {
-            // ... set range ...
-            a_annotation.Set(range);
-            // ... found ...
-            return true;
+    }
+    if ( nullptr == signature ) {
+        // ... not found ...
+        return false;
+    }
+    if ( false == signature->valid_ ) {
+        throw cc::Exception("%s - found but it's not a valid array!", sk_byte_range_err_msg_prefix_);
+    }
+    
+    // ... set range ...
+    a_annotation.Set(signature->range_);
+    
+    // ... found ...
+    return true;
+}
+
+/**
+ * @brief Collect all signatures, sorted by revision.
+ *
+ *        Signature fields without a valid /ByteRange ( not signed yet ) are not collected, nor are
+ *        fields whose widgets are not listed in any page /Annots ( only reachable from /AcroForm /Fields ).
+ *
+ * @param o_signatures Signatures descriptors.
+ */
+void casper::pdf::qpdf::Reader::GetSignatures (pdf::SignatureDescriptors& o_signatures)
+{
+    if ( nullptr == pdf_ ) {
+        throw cc::Exception("%s", "Can't read signatures - document is not open!");
+    }
+    
+    if ( false == indexed_ ) {
+        Index();
+    }
+    
+    o_signatures.clear();
+    for ( const auto& it : signatures_ ) {
+        // ... same field, one descriptor ( first widget ) ...
+        const Signature& signature = it.second.front();
+        if ( false == signature.valid_ ) {
+            continue;
         }
-    } else {
-        throw cc::Exception("%s - page number " SIZET_FMT " not found!", sk_byte_range_err_msg_prefix_, a_page);
+        o_signatures.push_back({
+            /* name_           */ it.first,
+            /* page_           */ signature.page_,
+            /* byte_range_     */ signature.range_,
+            /* contents_start_ */ signature.range_.before_start_ + signature.range_.before_size_,
+            /* contents_end_   */ signature.range_.after_start_,
+            /* signing_time_   */ signature.signing_time_,
+            /* reason_         */ signature.reason_,
+            /* revision_       */ 0
+        });
     }
     
-    // ... not found ...
-    return false;
+    // ... a signature covers all revisions before it ...
+    std::sort(o_signatures.begin(), o_signatures.end(), [](const pdf::SignatureDescriptor& a_lhs, const pdf::SignatureDescriptor& a_rhs) {
+        const size_t lhs = a_lhs.byte_range_.after_start_ + a_lhs.byte_range_.after_size_;
+        const size_t rhs = a_rhs.byte_range_.after_start_ + a_rhs.byte_range_.after_size_;
+        return ( lhs < rhs || ( lhs == rhs && a_lhs.name_ < a_rhs.name_ ) );
+    });
+    for ( size_t idx = 0 ; idx < o_signatures.size() ; ++idx ) {
+        o_signatures[idx].revision_ = idx + 1;
+    }
 }
 
 /**
@@ -157,42 +221,67 @@ void casper::pdf::qpdf::Reader::Close ()
     }
     delete pdf_;
     pdf_ = nullptr;
+    signatures_.clear();
+    indexed_ = false;
+    pages_   = 0;
 }
 
 // MARK: - [PRIVATE] - Helpers
 
 /**
- * @brief Search for the signature annotation widget and read it's /ByteRange.
- *
- * @param a_form        Page number, if set it will search only in that page, -1 to search in all.
- * @param a_annotations Available annotations.
- * @param a_name        Annotation name to look for.
- * @param o_range       Signature byte range.
- *
- * @return True if found, false othewise.
+ * @brief Index all signature fields widgets, by page, and read their /ByteRange.
  */
-bool casper::pdf::qpdf::Reader::GetByteRange (QPDFAcroFormDocumentHelper& a_form,
-                                              const std::vector<QPDFAnnotationObjectHelper>& a_annotations, const std::string& a_name,
-                                              SignatureAnnotation::ByteRange& o_range) const
+void casper::pdf::qpdf::Reader::Index ()
 {
-    // ... iterate all annoations ...
-    for ( std::vector<QPDFAnnotationObjectHelper>::const_iterator annot_iter = a_annotations.begin(); annot_iter != a_annotations.end(); ++annot_iter) {
-        // ... check if it's the annotation we're looking for ...
-        QPDFFormFieldObjectHelper ffh = a_form.getFieldForAnnotation(*annot_iter);
-        if ( "/Sig" == ffh.getFieldType() && a_name == ffh.getFullyQualifiedName() ) {
-            // ... load range ...
-            auto byte_range = ffh.getValue().getKey("/ByteRange");
-            if ( QPDFObject::ot_array != byte_range.getTypeCode() || 4 != byte_range.getArrayNItems() ) {
-                throw cc::Exception("%s - found but it's not a valid array!", sk_byte_range_err_msg_prefix_);
+    signatures_.clear();
+    
+    QPDFAcroFormDocumentHelper afdh(*pdf_);
+    QPDFPageDocumentHelper     pdh(*pdf_);
+    
+    const std::vector<QPDFPageObjectHelper> pages = pdh.getAllPages();
+    
+    size_t number = 0;
+    for ( std::vector<QPDFPageObjectHelper>::const_iterator page_iter = pages.begin(); page_iter != pages.end(); ++page_iter ) {
+        ++number;
+        // ... iterate all annotations of the current page ...
+        const std::vector<QPDFAnnotationObjectHelper> annotations = afdh.getWidgetAnnotationsForPage(*page_iter);
+        for ( std::vector<QPDFAnnotationObjectHelper>::const_iterator annot_iter = annotations.begin(); annot_iter != annotations.end(); ++annot_iter) {
+            // ... only signatures ...
+            QPDFFormFieldObjectHelper ffh = afdh.getFieldForAnnotation(*annot_iter);
+            if ( "/Sig" != ffh.getFieldType() ) {
+                continue;
+            }
+            Signature signature = { number, false, { 0, 0, 0, 0 }, "", "" };
+            // ... load range, errors are reported only when it's requested ...
+            auto value      = ffh.getValue();
+            auto byte_range = value.getKey("/ByteRange");
+            if ( QPDFObject::ot_array == byte_range.getTypeCode() && 4 == byte_range.getArrayNItems() ) {
+                signature.valid_ = true;
+                int idx = 0;
+                for ( auto v : { &signature.range_.before_start_, &signature.range_.before_size_, &signature.range_.after_start_, &signature.range_.after_size_ } ) {
+                    auto item = byte_range.getArrayItem(idx++);
+                    if ( false == item.isNumber() ) {
+                        signature.valid_ = false;
+                        break;
+                    }
+                    (*v) = static_cast<size_t>(item.getNumericValue());
+                }
             }
-            int idx = 0;
-            for ( auto v : { &o_range.before_start_, &o_range.before_size_, &o_range.after_start_, &o_range.after_size_ } ) {
-                (*v) = static_cast<size_t>(byte_range.getArrayItem(idx++).getNumericValue());
+            // ... optional info ...
+            if ( true == value.isDictionary() ) {
+                auto m      = value.getKey("/M");
+                auto reason = value.getKey("/Reason");
+                if ( true == m.isString() ) {
+                    signature.signing_time_ = m.getStringValue();
+                }
+                if ( true == reason.isString() ) {
+                    signature.reason_ = reason.getUTF8Value();
+                }
             }
-            // ... found ...
-            return true;
+            signatures_[ffh.getFullyQualifiedName()].push_back(signature);
         }
     }
-    // ... not found ...
-    return false;
+    
+    pages_   = pages.size();
+    indexed_ = true;
 }
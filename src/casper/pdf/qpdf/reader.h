@@ -24,9 +24,12 @@
 #include "casper/pdf/reader.h"
 
 #include "casper/pdf/annotation.h"
+#include "casper/pdf/types.h"
 
 #include <inttypes.h>
 #include <string>
+#include <vector>
+#include <map>
 
 #include "casper/pdf/qpdf/includes.h"
 
@@ -41,6 +44,16 @@ namespace casper
 
             class Reader final : public ::casper::pdf::Reader
             {
+                
+            private: // Data Type(s)
+                
+                typedef struct {
+                    size_t                              page_;         //!< Page number, 1..n.
+                    bool                                valid_;        //!< False when /ByteRange is missing or it's not a valid array.
+                    pdf::SignatureAnnotation::ByteRange range_;
+                    std::string                         signing_time_; //!< /M, as written.
+                    std::string                         reason_;       //!< /Reason, UTF-8 encoded.
+                } Signature;
 
             private: // Static Const Data
                 
@@ -53,19 +66,26 @@ namespace casper
                 
             private: // Data(s)
                 
-                QPDF* pdf_;
+                QPDF*                                         pdf_;
+                bool                                          indexed_;
+                size_t                                        pages_;      //!< Number of pages, when indexed.
+                std::map<std::string, std::vector<Signature>> signatures_; //!< /Sig fields by fully qualified name, in page order.
 
             public: // Inherited Method(s) / Function(s) from pdf::Reader
                 
                 virtual void   Open         (const std::string& a_uri);
+                virtual void   Open         (const unsigned char* a_bytes, const size_t a_size);
                 virtual bool   GetByteRange (const ssize_t a_page, pdf::SignatureAnnotation& a_annotation);
                 virtual size_t PageCount    ();
                 virtual void   Close        ();
+                
+            public: // Method(s) / Function(s)
+                
+                void GetSignatures (pdf::SignatureDescriptors& o_signatures);
                                 
             private: // Method(s) / Function(s)
                 
-                bool GetByteRange (QPDFAcroFormDocumentHelper& a_form,
-                                   const std::vector<QPDFAnnotationObjectHelper>& a_annotations, const std::string& a_name, pdf::SignatureAnnotation::ByteRange& o_range) const;
+                void Index ();
 
             }; // end of class 'Reader'
     
@@ -45,6 +45,7 @@ namespace casper
         public: // Pure Virtual Method(s) / Function(s)
             
             virtual void   Open         (const std::string& a_uri) = 0;
+            virtual void   Open         (const unsigned char* a_bytes, const size_t a_size) = 0;
             virtual bool   GetByteRange (const ssize_t a_page, pdf::SignatureAnnotation& o_annotation) = 0;
             virtual size_t PageCount    () = 0;
             virtual void   Close        () = 0;
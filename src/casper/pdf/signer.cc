@@ -27,14 +27,30 @@
 
 #include "cc/b64.h"
 #include "cc/crypto/rsa.h"
-#include "cc/hash/sha256.h"
 #include "cc/types.h"
 #include "cc/fs/file.h"
 
+#include <algorithm> // std::min
+#include <chrono>    // std::chrono::steady_clock
+#include <stdio.h>   // fopen, fgets
+#include <strings.h> // strcasecmp
+#include <sys/resource.h> // getrusage
+
+#include <openssl/evp.h>
+
+#include "casper/codec/hex.h"
+
+#include "casper/io/memory/file.h"
+
+#include "casper/openssl/private_key_store.h"
+
 #include "casper/pdf/qpdf/reader.h"
 
 #include "casper/pdf/podofo/writer.h"
 
+#include "casper/pdf/native/writer.h"
+#include "casper/pdf/native/reader.h"
+
 // MARK: - STATIC CONST DATA
 
 const char* const casper::pdf::Signer::sk_name_                                                                    = "casper-pdf-signature";
@@ -70,8 +86,13 @@ const char* const casper::pdf::Signer::sk_pkcs7_err_msg_fmt_write_mismatch_
 casper::pdf::Signer::Signer (const char* const a_signer_name, const char* const a_signature_name)
  : signer_name_(a_signer_name), signature_name_(a_signature_name)
 {
-    buffer_size_ = 1024;
-    buffer_      = new unsigned char [buffer_size_];    
+    io_settings_       = { io::File::Backend::MMap, 65536, 4 };
+    digest_stats_      = { 0, 0, 0.0, "" };
+    copy_strategy_     = io::File::CopyStrategy::None;
+    digest_cache_      = nullptr;
+    writer_backend_    = WriterBackend::PoDoFo;
+    load_on_demand_    = false;
+    placeholder_stats_ = { WriterBackend::PoDoFo, 0, 0, 0 };
 }
 
 /**
@@ -79,7 +100,59 @@ casper::pdf::Signer::Signer (const char* const a_signer_name, const char* const
  */
 casper::pdf::Signer::~Signer ()
 {
-    delete [] buffer_;
+    /* empty */
+}
+
+// MARK: - [PUBLIC] - Setup
+
+/**
+ * @brief Set I/O backend and buffer size used by all file operations.
+ *
+ * @param a_settings See \link io::File::Settings \link.
+ */
+void casper::pdf::Signer::Set (const io::File::Settings& a_settings)
+{
+    if ( 0 == a_settings.buffer_size_ ) {
+        throw cc::Exception(sk_field_err_msg_invalid_or_missing_, "io::File::Settings.buffer_size_");
+    }
+    // ... validate backend ...
+    (void)io::File::Backend2CString(a_settings.backend_);
+    io_settings_ = a_settings;
+}
+
+/**
+ * @brief Set SHA256 state cache used by all digest calculations.
+ *
+ * @param a_cache Shared cache, not owned, must outlive this object - nullptr to disable.
+ */
+void casper::pdf::Signer::Set (pdf::DigestCache* a_cache)
+{
+    digest_cache_ = a_cache;
+}
+
+/**
+ * @brief Set writer backend used by file based, non-delta, \link SetPlaceholder \link calls.
+ *
+ *        Native backend only reads the trailer, cross-reference sections, catalog, /AcroForm and target page,
+ *        so memory usage doesn't depend on document size; only invisible signatures are supported.
+ *
+ * @param a_backend One of \link WriterBackend \link, default is PoDoFo.
+ */
+void casper::pdf::Signer::Set (const Signer::WriterBackend a_backend)
+{
+    // ... validate backend ...
+    (void)WriterBackend2CString(a_backend);
+    writer_backend_ = a_backend;
+}
+
+/**
+ * @brief Enable or disable podofo::Writer load on demand mode, see \link podofo::Writer::EnableLoadOnDemand \link.
+ *
+ * @param a_enabled True to enable, false otherwise ( default ).
+ */
+void casper::pdf::Signer::EnableLoadOnDemand (const bool a_enabled)
+{
+    load_on_demand_ = a_enabled;
 }
 
 /**
@@ -118,18 +191,7 @@ void casper::pdf::Signer::SetPlaceholder (const std::string& a_in, pdf::Signatur
     }
     cc::fs::File::Unique(path, name, ext, o_out);
     
-    casper::pdf::podofo::Writer writer(signer_name_);
-
-    // ... append placeholder ...
-    writer.Open(a_in, o_out);
-    writer.Append(a_annotation);
-    writer.Close();
-
-    // ... get byte range ..
-    writer.GetByteRange(o_out, a_annotation);
-        
-    // ... zero-out /Contents ....
-    ZeroOut(o_out, a_annotation.byte_range());
+    AppendPlaceholder(a_in, o_out, a_annotation, /* o_digest */ nullptr);
 }
 
 /**
@@ -141,19 +203,89 @@ void casper::pdf::Signer::SetPlaceholder (const std::string& a_in, pdf::Signatur
  * @param a_annotation Prefilled signature annotation, /link ByteRange /link will be set here.
  */
 void casper::pdf::Signer::SetPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation)
+{
+    AppendPlaceholder(a_in, a_out, a_annotation, /* o_digest */ nullptr);
+}
+
+/**
+ * @brief Set a signature placeholder in a PDF document by creating a copy and keeping original intact
+ *       ( because PDF will be invalid until is signed ), calculating /ByteRange digest while doing it.
+ *
+ * @param a_in         PDF local URI.
+ * @param a_out        PDF local URI with placeholder.
+ * @param a_annotation Prefilled signature annotation, /link ByteRange /link will be set here.
+ * @param o_digest     SHA256 Base 64 encoded calculated digest value, to be used as \link SigningInfo \link 'digest_'.
+ */
+void casper::pdf::Signer::SetPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation,
+                                          std::string& o_digest)
+{
+    AppendPlaceholder(a_in, a_out, a_annotation, &o_digest);
+}
+
+/**
+ * @brief Set a signature placeholder in a PDF document, writing only the incremental update ( delta ).
+ *
+ * @param a_in         PDF local URI.
+ * @param a_delta      Incremental update local URI, see \link Materialize \link.
+ * @param a_annotation Prefilled signature annotation, /link ByteRange /link will be set here ( relative to the complete document ).
+ * @param o_delta      Original document size and digest, see \link Delta \link.
+ * @param o_digest     SHA256 Base 64 encoded calculated digest value, to be used as \link SigningInfo \link 'digest_'.
+ */
+void casper::pdf::Signer::SetPlaceholder (const std::string& a_in, const std::string& a_delta, pdf::SignatureAnnotation& a_annotation,
+                                          Signer::Delta& o_delta, std::string& o_digest)
 {
     casper::pdf::podofo::Writer writer(signer_name_);
 
+    // ... original document is hashed while it's opened, only the incremental update is written ...
+    writer.EnableDelta(io_settings_, digest_cache_);
+    writer.EnableLoadOnDemand(load_on_demand_);
+    
+    Signer::ByteRange range;
+    
     // ... append placeholder ...
-    writer.Open(a_in, a_out);
-    writer.Append(a_annotation);
+    writer.Open(a_in, a_delta);
+    writer.Append(a_annotation, range);
     writer.Close();
+    
+    copy_strategy_ = writer.copy_strategy();
+
+    // ... byte range and digests are known ...
+    a_annotation.Set(range);
+    o_delta  = writer.delta();
+    o_digest = writer.digest();
+}
+
+/**
+ * @brief Set a signature placeholder in a PDF document that is already in memory, calculating /ByteRange digest while doing it.
+ *
+ * @param a_bytes      PDF document bytes.
+ * @param a_size       PDF document size, in bytes.
+ * @param a_annotation Prefilled signature annotation, /link ByteRange /link will be set here.
+ * @param o_out        PDF document with placeholder.
+ * @param o_digest     SHA256 Base 64 encoded calculated digest value, to be used as \link SigningInfo \link 'digest_'.
+ */
+void casper::pdf::Signer::SetPlaceholder (const unsigned char* a_bytes, const size_t a_size, pdf::SignatureAnnotation& a_annotation,
+                                          std::vector<unsigned char>& o_out, std::string& o_digest)
+{
+    casper::pdf::podofo::Writer writer(signer_name_);
 
-    // ... get byte range ..
-    writer.GetByteRange(a_out, a_annotation);
+    // ... original document is hashed while it's opened, incremental update while it's written ...
+    writer.EnableDigest(io_settings_);
+    writer.EnableLoadOnDemand(load_on_demand_);
+    
+    Signer::ByteRange range;
+    
+    // ... append placeholder ...
+    writer.Open(a_bytes, a_size);
+    writer.Append(a_annotation, range);
+    writer.Output(o_out);
+    writer.Close();
+    
+    copy_strategy_ = io::File::CopyStrategy::None;
 
-    // ... zero-out /Contents ....
-    ZeroOut(a_out, a_annotation.byte_range());
+    // ... byte range and digest are known ...
+    a_annotation.Set(range);
+    o_digest = writer.digest();
 }
 
 // MARK: - [PUBLIC] - Signing Attributes Calculation
@@ -200,6 +332,56 @@ void casper::pdf::Signer::CalculateSigningAttributes (const std::string& a_uri,
     casper::openssl::P7::CalculateSigningAttributes(a_info.digest_, &a_certificate, a_info.signing_time_, a_info.auth_attr_);
 }
 
+/**
+ * @brief Calculate 'signing attributes' in a PDF document that is already in memory.
+ *
+ * @param a_bytes PDF document bytes.
+ * @param a_size  PDF document size, in bytes.
+ * @param a_range See \link ByteRange \link.
+ * @param a_info  Calculate and set some of the \link SigningInfo \link fields.
+ *                ( 'digest_', 'signing_time_' and 'auth_attr_' will be calculated and set here ).
+ */
+void casper::pdf::Signer::CalculateSigningAttributes (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_range,
+                                                      casper::pdf::Signer::SigningInfo& a_info)
+{
+    // ... document digest calculation ...
+    // ( 'digest_' will be calculated here )
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_bytes, a_size);
+    CalculateDigest(file, a_range, a_info.digest_);
+    file.Close();
+
+    // ... calculate unsigned 'signing attributes' but do not sign them ...
+    // ( 'signing_time_' and 'auth_attr_' will be calculated here )
+    casper::openssl::P7::CalculateSigningAttributes(a_info.digest_, nullptr, a_info.signing_time_, a_info.auth_attr_);
+}
+
+/**
+ * @brief Calculate 'signing attributes' in a PDF document that is already in memory.
+ *
+ * @param a_bytes       PDF document bytes.
+ * @param a_size        PDF document size, in bytes.
+ * @param a_range       See \link ByteRange \link.
+ * @param a_certificate Signing certificate.
+ * @param a_info        Calculate and set some of the \link SigningInfo \link fields.
+ *                      ( 'digest_', 'signing_time_' and 'auth_attr_' will be calculated and set here ).
+ */
+void casper::pdf::Signer::CalculateSigningAttributes (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_range,
+                                                      const casper::pdf::Signer::Certificate& a_certificate,
+                                                      casper::pdf::Signer::SigningInfo& a_info)
+{
+    // ... document digest calculation ...
+    // ( 'digest_' will be calculated here )
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_bytes, a_size);
+    CalculateDigest(file, a_range, a_info.digest_);
+    file.Close();
+
+    // ... calculate unsigned 'signing attributes' but do not sign them ...
+    // ( 'signing_time_' and 'auth_attr_' will be calculated here )
+    casper::openssl::P7::CalculateSigningAttributes(a_info.digest_, &a_certificate, a_info.signing_time_, a_info.auth_attr_);
+}
+
 /**
  * @brief Calculate 'signing attributes' in a PDF document.
  *
@@ -253,7 +435,13 @@ void casper::pdf::Signer::SignSigningAttributes (const Signer::PrivateKey a_key,
             sz = cppcodec::base64_url_unpadded::decode(ua, mds, auth_attr.c_str(), auth_attr.length());
         }
         
-        a_info.enc_digest_ = cc::crypto::RSA::SignSHA256(ua, sz, a_key.uri_, a_key.password_);
+        // ... already decrypted key?
+        openssl::PrivateKeyStore* store = openssl::PrivateKey::store();
+        if ( nullptr != store ) {
+            a_info.enc_digest_ = store->SignSHA256(a_key, ua, sz);
+        } else {
+            a_info.enc_digest_ = cc::crypto::RSA::SignSHA256(ua, sz, a_key.uri_, a_key.password_);
+        }
         delete [] ua;
         
     } catch (...) {
@@ -281,6 +469,43 @@ void casper::pdf::Signer::Sign (const std::string& a_uri,
                                 const casper::pdf::Signer::ByteRange& a_range,  const std::string& a_digest,
                                 const casper::pdf::Signer::Certificates& a_certificates, const casper::pdf::Signer::PrivateKey& a_key,
                                 casper::pdf::Signer::SigningInfo& o_info)
+{
+    // ... a complete document is a delta that starts at offset 0 ...
+    Sign(a_uri, Signer::Delta({ 0, "" }), a_range, a_digest, a_certificates, a_key, o_info);
+}
+
+/**
+ * @brief Sign a PDF document using a previously calculated 'SIGNER INFO' SIGNED attributes.
+ *
+ * @param a_uri          PDF local URI.
+ * @param a_range        See \link ByteRange \link.
+ * @param a_info         See \link SigningInfo \link.
+ * @param a_certificates Signing certificate and ( optionally ) all other certificates in chain.
+ */
+void casper::pdf::Signer::Sign (const std::string& a_uri,
+                                const casper::pdf::Signer::ByteRange& a_range, const casper::pdf::Signer::SigningInfo& a_info,
+                                const casper::pdf::Signer::Certificates& a_certificates)
+{
+    // ... a complete document is a delta that starts at offset 0 ...
+    Sign(a_uri, Signer::Delta({ 0, "" }), a_range, a_info, a_certificates);
+}
+
+/**
+ * @brief Sign an incremental update, written by delta \link SetPlaceholder \link, using a previously calculated 'SIGNER INFO'
+ *        UNSIGNED attributes usign the private key.
+ *
+ * @param a_delta        Incremental update local URI.
+ * @param a_delta_info   See \link Delta \link.
+ * @param a_range        See \link ByteRange \link, offsets are relative to the original document.
+ * @param a_digest       PDF document SHA256 digest base 64 encoded.
+ * @param a_certificates Signing certificate and ( optionally ) all other certificates in chain.
+ * @param a_key          Private key info.
+ * @param o_info         See \link SigningInfo \link.
+ */
+void casper::pdf::Signer::Sign (const std::string& a_delta, const casper::pdf::Signer::Delta& a_delta_info,
+                                const casper::pdf::Signer::ByteRange& a_range, const std::string& a_digest,
+                                const casper::pdf::Signer::Certificates& a_certificates, const casper::pdf::Signer::PrivateKey& a_key,
+                                casper::pdf::Signer::SigningInfo& o_info)
 {
     o_info.digest_       = a_digest;
     o_info.signing_time_ = "";
@@ -290,30 +515,82 @@ void casper::pdf::Signer::Sign (const std::string& a_uri,
     CalculateSigningAttributes(a_certificates.signing_, o_info);
     SignSigningAttributes(a_key, o_info);
 
+    const size_t offset = a_delta_info.original_size_;
     casper::openssl::P7::Sign(a_certificates.signing_, a_certificates.chain_, o_info.digest_, o_info.enc_digest_, o_info.signing_time_,
-                              [this, a_uri, a_range] (const unsigned char* a_bytes, const size_t& a_size) {
-                                Write(a_uri, a_range, a_bytes, a_size);
+                              [this, a_delta, offset, a_range] (const unsigned char* a_bytes, const size_t& a_size) {
+                                Write(a_delta, offset, a_range, a_bytes, a_size);
                               }
     );
 }
 
 /**
- * @brief Sign a PDF document using a previously calculated 'SIGNER INFO' SIGNED attributes.
+ * @brief Sign an incremental update, written by delta \link SetPlaceholder \link, using a previously calculated 'SIGNER INFO'
+ *        SIGNED attributes.
  *
- * @param a_uri          PDF local URI.
+ * @param a_delta        Incremental update local URI.
+ * @param a_delta_info   See \link Delta \link.
+ * @param a_range        See \link ByteRange \link, offsets are relative to the original document.
+ * @param a_info         See \link SigningInfo \link.
+ * @param a_certificates Signing certificate and ( optionally ) all other certificates in chain.
+ */
+void casper::pdf::Signer::Sign (const std::string& a_delta, const casper::pdf::Signer::Delta& a_delta_info,
+                                const casper::pdf::Signer::ByteRange& a_range, const casper::pdf::Signer::SigningInfo& a_info,
+                                const casper::pdf::Signer::Certificates& a_certificates)
+{
+    const size_t offset = a_delta_info.original_size_;
+    casper::openssl::P7::Sign(a_certificates.signing_, a_certificates.chain_, a_info.digest_, a_info.enc_digest_, a_info.signing_time_,
+                              [this, a_delta, offset, a_range] (const unsigned char* a_bytes, const size_t& a_size) {
+                                Write(a_delta, offset, a_range, a_bytes, a_size);
+                              }
+    );
+}
+
+/**
+ * @brief Sign a PDF document that is already in memory using a previously calculated 'SIGNER INFO' UNSIGNED attributes usign the private key.
+ *
+ * @param a_buffer       PDF document, with placeholder, PKCS7 object will be written here.
+ * @param a_range        See \link ByteRange \link.
+ * @param a_digest       PDF document SHA256 digest base 64 encoded.
+ * @param a_certificates Signing certificate and ( optionally ) all other certificates in chain.
+ * @param a_key          Private key info.
+ * @param o_info         See \link SigningInfo \link.
+ */
+void casper::pdf::Signer::Sign (std::vector<unsigned char>& a_buffer,
+                                const casper::pdf::Signer::ByteRange& a_range, const std::string& a_digest,
+                                const casper::pdf::Signer::Certificates& a_certificates, const casper::pdf::Signer::PrivateKey& a_key,
+                                casper::pdf::Signer::SigningInfo& o_info)
+{
+    o_info.digest_       = a_digest;
+    o_info.signing_time_ = "";
+    o_info.auth_attr_    = "";
+    o_info.enc_digest_   = "";
+
+    CalculateSigningAttributes(a_certificates.signing_, o_info);
+    SignSigningAttributes(a_key, o_info);
+
+    Sign(a_buffer, a_range, o_info, a_certificates);
+}
+
+/**
+ * @brief Sign a PDF document that is already in memory using a previously calculated 'SIGNER INFO' SIGNED attributes.
+ *
+ * @param a_buffer       PDF document, with placeholder, PKCS7 object will be written here.
  * @param a_range        See \link ByteRange \link.
  * @param a_info         See \link SigningInfo \link.
  * @param a_certificates Signing certificate and ( optionally ) all other certificates in chain.
  */
-void casper::pdf::Signer::Sign (const std::string& a_uri,
+void casper::pdf::Signer::Sign (std::vector<unsigned char>& a_buffer,
                                 const casper::pdf::Signer::ByteRange& a_range, const casper::pdf::Signer::SigningInfo& a_info,
                                 const casper::pdf::Signer::Certificates& a_certificates)
 {
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_buffer);
     casper::openssl::P7::Sign(a_certificates.signing_, a_certificates.chain_, a_info.digest_, a_info.enc_digest_, a_info.signing_time_,
-                              [this, a_uri, a_range] (const unsigned char* a_bytes, const size_t& a_size) {
-                                Write(a_uri, a_range, a_bytes, a_size);
+                              [this, &file, a_range] (const unsigned char* a_bytes, const size_t& a_size) {
+                                Write(file, /* a_offset */ 0, a_range, a_bytes, a_size);
                               }
     );
+    file.Close();
 }
 
 // MARK: - [PUBLIC] - OTHER
@@ -326,19 +603,83 @@ void casper::pdf::Signer::Sign (const std::string& a_uri,
  */
 void casper::pdf::Signer::ZeroOut (const std::string& a_uri, const Signer::ByteRange& a_range)
 {
-    FILE* fp = fopen(a_uri.c_str(), "r+");
-    if ( nullptr == fp ) {
-        throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), strerror(errno));
-    }
+    io::File* file = io::File::New(io_settings_);
     try {
-        ZeroOut(fp, a_range);
-    } catch (const cc::Exception& a_cc_exception) {
-        throw a_cc_exception;
+        file->Open(a_uri, io::File::Mode::ReadWrite);
+        ZeroOut(*file, a_range);
+        file->Close();
+        delete file;
+        if ( nullptr != digest_cache_ ) {
+            digest_cache_->Touch(a_uri, a_range.before_start_ + a_range.before_size_, a_range.after_start_);
+        }
     } catch (...) {
-        cc::Exception::Rethrow(/* a_unhandled */ true, __FILE__, __LINE__, __FUNCTION__);
+        delete file;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+/**
+ * @brief Zero-out a /Contents in a PDF document that is already in memory.
+ *
+ * @param a_buffer PDF document.
+ * @param a_range  /ByteRange info to zero-out.
+ */
+void casper::pdf::Signer::ZeroOut (std::vector<unsigned char>& a_buffer, const Signer::ByteRange& a_range)
+{
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_buffer);
+    ZeroOut(file, a_range);
+    file.Close();
+}
+
+/**
+ * @brief Rebuild a complete PDF document from it's original version and an incremental update written in delta mode.
+ *
+ * @param a_original Original PDF local URI.
+ * @param a_delta    Incremental update local URI.
+ * @param a_info     See \link Delta \link.
+ * @param a_out      Complete PDF local URI, must not exist.
+ * @param a_verify   When true, original document digest is verified.
+ */
+void casper::pdf::Signer::Materialize (const std::string& a_original, const std::string& a_delta, const Signer::Delta& a_info,
+                                       const std::string& a_out, const bool a_verify)
+{
+    // ... original document must be the one used to write the incremental update ...
+    if ( cc::fs::File::Size(a_original) != a_info.original_size_ ) {
+        throw cc::Exception("Unable to materialize '%s' - original document size mismatch: " SIZET_FMT " vs " SIZET_FMT " expected!",
+                            a_out.c_str(), cc::fs::File::Size(a_original), a_info.original_size_);
+    }
+    if ( true == a_verify ) {
+        const Signer::ByteRange all = { 0, a_info.original_size_, a_info.original_size_, 0 };
+        std::string             digest;
+        CalculateDigest(a_original, all, digest);
+        if ( digest != a_info.original_digest_ ) {
+            throw cc::Exception("Unable to materialize '%s' - original document digest mismatch!", a_out.c_str());
+        }
     }
-    if ( 0 != fclose(fp) ) {
-        throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
+    
+    // ... copy original document ( cheap when reflinks are supported ) ...
+    copy_strategy_ = io::File::Copy(a_original, a_out, /* a_overwrite */ false);
+    
+    // ... and append incremental update ...
+    io::File* in  = io::File::New(io_settings_);
+    io::File* out = io::File::New(io_settings_);
+    try {
+        in->Open(a_delta, io::File::Mode::Read);
+        out->Open(a_out, io::File::Mode::ReadWrite);
+        size_t offset = a_info.original_size_;
+        in->Read(0, in->Size(), [out, &offset] (const unsigned char* a_bytes, const size_t& a_size) {
+            out->Write(offset, a_bytes, a_size);
+            offset += a_size;
+        });
+        out->Close();
+        in->Close();
+        delete out;
+        delete in;
+    } catch (...) {
+        delete out;
+        delete in;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
     }
 }
 
@@ -347,6 +688,8 @@ void casper::pdf::Signer::ZeroOut (const std::string& a_uri, const Signer::ByteR
 /**
  * @brief Get \link ByteRange \link info from   PDF document.
  *
+ *        The last incremental updates are searched first, the whole document is parsed only if not found there.
+ *
  * @param a_uri   PDF local URI.
  * @param a_page  Page number where to look for annotation.
  * @param o_range Loaded data, see \link ByteRange \link.
@@ -354,8 +697,30 @@ void casper::pdf::Signer::ZeroOut (const std::string& a_uri, const Signer::ByteR
 
 void casper::pdf::Signer::GetByteRange (const std::string& a_uri, const ssize_t a_page, Signer::ByteRange& o_range)
 {
-    pdf::qpdf::Reader        reader;
     pdf::SignatureAnnotation annotation(signature_name_);
+    // ... fast path: search only the last incremental updates ...
+    {
+        pdf::native::Reader locator(io_settings_);
+        bool                found = false;
+        try {
+            locator.Open(a_uri);
+            found = locator.GetByteRange(a_page, annotation);
+        } catch (const ::cc::Exception& /* a_cc_exception */) {
+            // ... field found but it's /ByteRange is not valid: conclusive ...
+            if ( true == locator.invalid() ) {
+                locator.Close();
+                throw;
+            }
+            // ... not conclusive, let qpdf deal with it ...
+            found = false;
+        }
+        locator.Close();
+        if ( true == found ) {
+            o_range = annotation.byte_range();
+            return;
+        }
+    }
+    pdf::qpdf::Reader reader;
     // ... open PDF ...
     reader.Open(a_uri);
     // ... must be already present ...
@@ -368,6 +733,69 @@ void casper::pdf::Signer::GetByteRange (const std::string& a_uri, const ssize_t
     reader.Close();
 }
 
+/**
+ * @brief Get \link ByteRange \link info from a PDF document that is already in memory.
+ *
+ * @param a_bytes PDF document bytes.
+ * @param a_size  PDF document size, in bytes.
+ * @param a_page  Page number where to look for annotation.
+ * @param o_range Loaded data, see \link ByteRange \link.
+ */
+void casper::pdf::Signer::GetByteRange (const unsigned char* a_bytes, const size_t a_size, const ssize_t a_page, Signer::ByteRange& o_range)
+{
+    pdf::qpdf::Reader        reader;
+    pdf::SignatureAnnotation annotation(signature_name_);
+    // ... open PDF ...
+    reader.Open(a_bytes, a_size);
+    // ... must be already present ...
+    if ( false == reader.GetByteRange(a_page, annotation) ) {
+        throw cc::Exception(sk_pdf_byte_range_not_found_, annotation.name_.c_str());
+    }
+    // ... copy data ...
+    o_range = annotation.byte_range();
+    // ... close PDF ...
+    reader.Close();
+}
+
+/**
+ * @brief Get all signatures, in the order they were added, from a PDF document.
+ *
+ *        Only signature fields with a widget listed in a page /Annots are found, see \link qpdf::Reader::GetSignatures \link.
+ *
+ * @param a_uri        PDF local URI.
+ * @param o_signatures Signatures, see \link SignatureDescriptor \link.
+ */
+void casper::pdf::Signer::GetSignatures (const std::string& a_uri, Signer::SignatureDescriptors& o_signatures)
+{
+    pdf::qpdf::Reader reader;
+    // ... open PDF ...
+    reader.Open(a_uri);
+    // ... one traversal, all signatures ...
+    reader.GetSignatures(o_signatures);
+    // ... close PDF ...
+    reader.Close();
+}
+
+/**
+ * @brief Get all signatures, in the order they were added, from a PDF document that is already in memory.
+ *
+ *        Only signature fields with a widget listed in a page /Annots are found, see \link qpdf::Reader::GetSignatures \link.
+ *
+ * @param a_bytes      PDF document bytes.
+ * @param a_size       PDF document size, in bytes.
+ * @param o_signatures Signatures, see \link SignatureDescriptor \link.
+ */
+void casper::pdf::Signer::GetSignatures (const unsigned char* a_bytes, const size_t a_size, Signer::SignatureDescriptors& o_signatures)
+{
+    pdf::qpdf::Reader reader;
+    // ... open PDF ...
+    reader.Open(a_bytes, a_size);
+    // ... one traversal, all signatures ...
+    reader.GetSignatures(o_signatures);
+    // ... close PDF ...
+    reader.Close();
+}
+
 /**
  * @brief Export a PCKS7 in PEM format.
  *
@@ -379,89 +807,109 @@ void casper::pdf::Signer::Export (const std::string& a_uri,
                                   const casper::pdf::Signer::ByteRange& a_range,
                                   const std::string& o_uri)
 {
-    FILE* fp = fopen(a_uri.c_str(), "r");
-    if ( nullptr == fp ) {
-        throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), strerror(errno));
-    }
-    unsigned char* bf = nullptr;
+    io::File* file = io::File::New(io_settings_);
     try {
-        
-        if ( 0 != fseek(fp, 0, SEEK_END) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_seek_to_end_of_file_, strerror(errno));
-        }
-        
-        const size_t size = ftell(fp);
-        rewind(fp);
-        
-        const size_t start  = a_range.before_start_ + a_range.before_size_ + 1;
-        const size_t end    = a_range.after_start_ - 1;
-        const size_t length = end - start;
-        
-        if ( size < length ) {
-            throw cc::Exception("%s", sk_pdf_contents_not_enough_bytes_to_read_);
-        }
+        file->Open(a_uri, io::File::Mode::Read);
+        Export(*file, a_range, &o_uri, nullptr);
+        file->Close();
+        delete file;
+    } catch (...) {
+        delete file;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
 
-        if ( 0 != fseek(fp, start, SEEK_SET) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_seek_to_position_of_file_, start, strerror(errno));
-        }
+/**
+ * @brief Export a PCKS7, from a PDF document that is already in memory, in PEM format.
+ *
+ * @param a_bytes PDF document bytes.
+ * @param a_size  PDF document size, in bytes.
+ * @param a_range /ByteRange info where PKCS7 is at.
+ * @param o_uri   PKCS7 decoded data.
+ */
+void casper::pdf::Signer::Export (const unsigned char* a_bytes, const size_t a_size,
+                                  const casper::pdf::Signer::ByteRange& a_range,
+                                  const std::string& o_uri)
+{
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_bytes, a_size);
+    Export(file, a_range, &o_uri, nullptr);
+    file.Close();
+}
 
-        bf = new unsigned char[length];
-        
-        const size_t bytes_read = fread(bf, sizeof(unsigned char), length, fp);
-        if ( ferror(fp) ) {
-            throw cc::Exception(sk_file_err_msg_fmt_read_error_, strerror(errno));
-        }
-        
-        if ( bytes_read != length ) {
-            throw cc::Exception(sk_file_err_msg_fmt_read_mismatch_, bytes_read, length);
-        }
+/**
+ * @brief Export a PCKS7, from a PDF document that is already in memory, in PEM format.
+ *
+ * @param a_bytes PDF document bytes.
+ * @param a_size  PDF document size, in bytes.
+ * @param a_range /ByteRange info where PKCS7 is at.
+ * @param o_pem   PKCS7 PEM data.
+ */
+void casper::pdf::Signer::Export (const unsigned char* a_bytes, const size_t a_size,
+                                  const casper::pdf::Signer::ByteRange& a_range,
+                                  std::vector<unsigned char>& o_pem)
+{
+    io::memory::File file(io_settings_.buffer_size_);
+    file.Open(a_bytes, a_size);
+    Export(file, a_range, nullptr, &o_pem);
+    file.Close();
+}
+
+// MARK: - [PRIVATE] - PLACEHOLDER
 
-        if ( 0 != fclose(fp) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
+/**
+ * @brief Append a signature placeholder to a copy of a PDF document, using the selected writer backend - see \link WriterBackend \link.
+ *
+ * @param a_in         PDF local URI.
+ * @param a_out        PDF local URI with placeholder.
+ * @param a_annotation Prefilled signature annotation, /link ByteRange /link will be set here.
+ * @param o_digest     When not null, SHA256 Base 64 encoded calculated digest value, to be used as \link SigningInfo \link 'digest_'.
+ */
+void casper::pdf::Signer::AppendPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation,
+                                             std::string* o_digest)
+{
+    Signer::ByteRange range;
+    
+    const auto start = std::chrono::steady_clock::now();
+    
+    uint64_t load_us = 0;
+    if ( WriterBackend::Native == writer_backend_ ) {
+        // ... only trailer, cross-reference sections, catalog, /AcroForm and target page are read ...
+        casper::pdf::native::Writer writer(signer_name_);
+        if ( nullptr != o_digest ) {
+            writer.EnableDigest(io_settings_, digest_cache_);
         }
-        fp = nullptr;
-        
-        // HEX 2 BIN
-        const unsigned char* r_ptr  = bf;
-        unsigned char*       w_ptr  = bf;
-        size_t               len    = length;
-        unsigned char        hex[3] = {0,0,0};
-        size_t               adv    = 0;
-        unsigned             v      = 0;
-        const size_t         k1      = sizeof(unsigned char);
-        const size_t         k2      = sizeof(unsigned char) * 2;
-        while ( len ) {
-            hex[0] = r_ptr[0];
-            hex[1] = r_ptr[1];
-            const unsigned char* hex_ptr = hex;
-            while (*hex_ptr) {
-                // get current character then increment
-                char byte = *hex_ptr++;
-                // transform hex character to the 4bit equivalent number, using the ascii table indexes
-                if (byte >= '0' && byte <= '9') byte = byte - '0';
-                else if (byte >= 'a' && byte <='f') byte = byte - 'a' + 10;
-                else if (byte >= 'A' && byte <='F') byte = byte - 'A' + 10;
-                // shift 4 to make space for new digit, and add the 4 bits of the new digit
-                v = (v << 4) | (byte & 0xF);
-            }
-            w_ptr[0] = v;
-            w_ptr   += k1;
-            adv     += k1;
-            r_ptr   += k2;
-            len     -= k2;
+        writer.Open(a_in, a_out);
+        writer.Append(a_annotation, range);
+        writer.Close();
+        copy_strategy_ = writer.copy_strategy();
+        if ( nullptr != o_digest ) {
+            (*o_digest) = writer.digest();
         }
-        
-        casper::openssl::P7::Export(bf, adv, o_uri);
-        
-        delete [] bf;
-
-    } catch (const cc::Exception& a_cc_exception) {
-        delete [] bf;
-        if ( fp != nullptr && 0 != fclose(fp) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
+    } else {
+        casper::pdf::podofo::Writer writer(signer_name_);
+        // ... original document is hashed while it's copied, incremental update while it's written ...
+        if ( nullptr != o_digest ) {
+            writer.EnableDigest(io_settings_, digest_cache_);
+        }
+        writer.EnableLoadOnDemand(load_on_demand_);
+        writer.Open(a_in, a_out);
+        load_us = writer.load_us();
+        writer.Append(a_annotation, range);
+        writer.Close();
+        copy_strategy_ = writer.copy_strategy();
+        if ( nullptr != o_digest ) {
+            (*o_digest) = writer.digest();
         }
-        throw a_cc_exception;
     }
+    
+    placeholder_stats_.backend_    = writer_backend_;
+    placeholder_stats_.elapsed_us_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    placeholder_stats_.load_us_    = load_us;
+    placeholder_stats_.peak_rss_   = PeakRSS();
+
+    // ... byte range ( and digest ) are known, no need to read output again ...
+    a_annotation.Set(range);
 }
 
 // MARK: - [PRIVATE] - WRITE
@@ -469,15 +917,44 @@ void casper::pdf::Signer::Export (const std::string& a_uri,
 /**
  * @brief Write a PKCS7 object ( BER FORMAT ) o a PDF document.
  *
- * @param a_uri   PDF local URI.
- * @param a_range /ByteRange info where to write PKCS7 object.
- * @param a_bytes PCKS7 object bytes.
- * @param a_size  PCKS7 object size ( in bytes ).
+ * @param a_uri    PDF local URI.
+ * @param a_offset Logical offset of the first byte of the file ( non-zero when writing to a delta ).
+ * @param a_range  /ByteRange info where to write PKCS7 object.
+ * @param a_bytes  PCKS7 object bytes.
+ * @param a_size   PCKS7 object size ( in bytes ).
+ */
+void casper::pdf::Signer::Write (const std::string& a_uri, const size_t a_offset, const Signer::ByteRange& a_range,
+                                 const unsigned char* a_bytes, const size_t a_size)
+{
+    io::File* file = io::File::New(io_settings_);
+    try {
+        file->Open(a_uri, io::File::Mode::ReadWrite);
+        Write(*file, a_offset, a_range, a_bytes, a_size);
+        file->Close();
+        delete file;
+        // ... only /Contents was written, SHA256 states of the bytes before it are still valid ...
+        if ( nullptr != digest_cache_ && 0 == a_offset ) {
+            digest_cache_->Touch(a_uri, a_range.before_start_ + a_range.before_size_, a_range.after_start_);
+        }
+    } catch (...) {
+        delete file;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+/**
+ * @brief Write a PKCS7 object ( BER FORMAT ) o a PDF document.
+ *
+ * @param a_file   Previously open file.
+ * @param a_offset Logical offset of the first byte of the file ( non-zero when writing to a delta ).
+ * @param a_range  /ByteRange info where to write PKCS7 object.
+ * @param a_bytes  PCKS7 object bytes.
+ * @param a_size   PCKS7 object size ( in bytes ).
  */
-void casper::pdf::Signer::Write (const std::string& a_uri, const Signer::ByteRange& a_range,
+void casper::pdf::Signer::Write (io::File& a_file, const size_t a_offset, const Signer::ByteRange& a_range,
                                  const unsigned char* a_bytes, const size_t a_size)
 {
-    FILE* fp = nullptr;
+    unsigned char* window = nullptr;
     
     try {
         
@@ -491,65 +968,25 @@ void casper::pdf::Signer::Write (const std::string& a_uri, const Signer::ByteRan
         if ( length < pkcs7_hex_length ) {
             throw ::cc::Exception("%s", sk_pkcs7_err_msg_fmt_unable_to_write_data_not_enough_space_);
         }
-        
-        // ... open file ...
-        fp = fopen(a_uri.c_str(), "r+");
-        if ( nullptr == fp ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_open_file_with_, a_uri.c_str(), strerror(errno));
+        // ... /Contents must be part of the file ( when writing to a delta ) ...
+        if ( start < a_offset ) {
+            throw ::cc::Exception(sk_pkcs7_err_msg_fmt_unable_to_write_data_failed_seek_to_start_of_contents_, "not part of the incremental update");
         }
         
-        // ... go to the beginning of /Contents ...
-        if ( 0 != fseek(fp, start, SEEK_SET) ) {
-            throw ::cc::Exception(sk_pkcs7_err_msg_fmt_unable_to_write_data_failed_seek_to_start_of_contents_, strerror(errno));
-        }
+        // ... build the whole /Contents window: PKCS7 data followed by 'unused' space zeroed out ...
+        window = new unsigned char[length];
+        casper::codec::Hex::Encode(a_bytes, a_size, window);
+        memset(window + pkcs7_hex_length, '0', length - pkcs7_hex_length);
         
-        // ... write PKCS7 data ...
-        {
-            const unsigned char* ptr = a_bytes;
-            size_t               len = a_size;
-            size_t               bw   = 0;
-            char data[2];
-            while ( len-- ) {
-                data[0]  = (*ptr & 0xF0) >> 4;
-                data[0] += (data[0] > 9 ? 'A' - 10 : '0');
-                data[1]  = (*ptr & 0x0F);
-                data[1] += (data[1] > 9 ? 'A' - 10 : '0');
-                bw = fwrite(data, sizeof(char), 2, fp);
-                if ( 2 != bw ) {
-                    throw cc::Exception(sk_pkcs7_err_msg_fmt_write_mismatch_, bw, static_cast<size_t>(2));
-                } else if ( 0 != ferror(fp) ) {
-                    throw cc::Exception(sk_pkcs7_err_msg_fmt_write_error_, strerror(errno));
-                }
-                ++ptr;
-            }
-        }
-
-        // ... go to the beginning of the 'unused' bytes ...
-        if ( 0 != fseek(fp, ( start + pkcs7_hex_length ), SEEK_SET) ) {
-            throw ::cc::Exception(sk_pkcs7_err_msg_fmt_unable_to_write_data_failed_seek_to_end_of_contents_, strerror(errno));
-        }
-
-        // ... zero out signature remaining 'unused' space ...
-        ZeroOut(fp, ( length - pkcs7_hex_length ));
+        // ... and write it at once ...
+        a_file.Write(start - a_offset, window, length);
+        
+        delete [] window;
         
-        // ... close file ...
-        if ( 0 != fclose(fp) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
-        }
-        fp = nullptr;
-    } catch (const cc::Exception& a_cc_exception) {
-        if ( fp != nullptr && 0 != fclose(fp) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
-        }
-        throw a_cc_exception;
     } catch (...) {
-        if ( fp != nullptr && 0 != fclose(fp) ) {
-            throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_close_file_with_, a_uri.c_str(), strerror(errno));
-        }
-        cc::Exception::Rethrow(/* a_unhandled */ true, __FILE__, __LINE__, __FUNCTION__);
+        delete [] window;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
     }
-    
-    CC_ASSERT(nullptr == fp);
 }
 
 // MARK: - [PRIVATE] - ZERO-OUT
@@ -557,98 +994,218 @@ void casper::pdf::Signer::Write (const std::string& a_uri, const Signer::ByteRan
 /**
  * @brief Zero-out a /Contents in the PDF file
  *
- * @param a_fp         FILE* Previously open file.
+ * @param a_file       Previously open file.
  * @param a_byte_range /ByteRange info where to write PKCS7 object.
  */
-void casper::pdf::Signer::ZeroOut (FILE* a_fp, const Signer::ByteRange& a_byte_range)
+void casper::pdf::Signer::ZeroOut (io::File& a_file, const Signer::ByteRange& a_byte_range)
 {
     const size_t start  = a_byte_range.before_start_ + a_byte_range.before_size_ + 1;
     const size_t end    = a_byte_range.after_start_ - 1;
     const size_t length = end - start;
     
-    // ... go to the beginning of the /Contents object ...
-    if ( 0 != fseek(a_fp, start, SEEK_SET) ) {
-        throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_seek_to_position_of_file_, start, strerror(errno));
-    }
-    
     // ... zero-out until the end of the /Contents object ...
-    ZeroOut(a_fp, length);
-    
-    // ... rewind to the beginning of the /Contents object ...
-    if ( 0 != fseek(a_fp, start, SEEK_SET) ) {
-        throw ::cc::Exception(sk_file_err_msg_fmt_unable_to_seek_to_position_of_file_, start, strerror(errno));
-    }
+    a_file.Fill(start, '0', length);
 }
 
+// MARK: - [PRIVATE] - DIGEST CALCULATION
+
 /**
- * @brief Zero-out a file.
+ * @brief Calculate PDF digest.
  *
- * @param a_fp   FILE* Previously open file.
- * @param a_size Number of bytes to write.
+ * @param a_uri        PDF local URI.
+ * @param a_byte_range /ByteRange info where PKCS7 object is or will be.
+ * @param o_digest     SHA256 Base 64 encoded calculated digest value.
  */
-void casper::pdf::Signer::ZeroOut (FILE* a_fp, const size_t& a_size)
+void casper::pdf::Signer::CalculateDigest (const std::string& a_uri, const Signer::ByteRange& a_byte_range, std::string& o_digest)
 {
-    ssize_t remainder  = a_size;
-    size_t  chunk_size = std::min(buffer_size_, static_cast<size_t>(remainder));
-    size_t  bw         = 0;
-    memset(buffer_, '0', buffer_size_);
-    while ( remainder > 0 ) {
-        bw = fwrite(buffer_, sizeof(unsigned char), chunk_size, a_fp);
-        if ( chunk_size != bw ) {
-            throw cc::Exception(sk_file_err_msg_fmt_write_mismatch_, bw, chunk_size);
-        } else if ( 0 != ferror(a_fp) ) {
-            throw cc::Exception(sk_file_err_msg_fmt_write_error_, strerror(errno));
-        }
-        remainder -= chunk_size;
-        chunk_size = std::min(buffer_size_, static_cast<size_t>(remainder));
+    // ... unchanged file, already calculated ( retried signing sessions ), don't even open it ...
+    if ( nullptr != digest_cache_ && true == digest_cache_->Lookup(a_uri, a_byte_range, o_digest) ) {
+        digest_stats_ = { 0, 0, 0.0, "" };
+        return;
+    }
+    
+    io::File* file = io::File::New(io_settings_);
+    try {
+        file->Open(a_uri, io::File::Mode::Read);
+        CalculateDigest(*file, a_byte_range, o_digest);
+        file->Close();
+        delete file;
+    } catch (...) {
+        delete file;
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
     }
 }
 
-// MARK: - [PRIVATE] - DIGEST CALCULATION
-
 /**
  * @brief Calculate PDF digest.
  *
- * @param a_uri        PDF local URI.
+ * @param a_file       Previously open file.
  * @param a_byte_range /ByteRange info where PKCS7 object is or will be.
  * @param o_digest     SHA256 Base 64 encoded calculated digest value.
  */
-void casper::pdf::Signer::CalculateDigest (const std::string& a_uri, const Signer::ByteRange& a_byte_range, std::string& o_digest)
+void casper::pdf::Signer::CalculateDigest (io::File& a_file, const Signer::ByteRange& a_byte_range, std::string& o_digest)
 {
-    cc::fs::file::Reader fr;
+    const bool cache = ( nullptr != digest_cache_ && nullptr == dynamic_cast<io::memory::File*>(&a_file) );
     
-    fr.Open(a_uri, cc::fs::file::Reader::Mode::Read);
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if ( nullptr == context || 1 != EVP_DigestInit_ex(context, EVP_sha256(), nullptr) ) {
+        EVP_MD_CTX_free(context);
+        throw ::cc::Exception("%s", "Unable to initialize SHA256 context!");
+    }
     
-    const std::vector<std::pair<size_t, size_t>> chunks = {
-        // ... bytes before '/Contents'
-        { a_byte_range.before_start_ , a_byte_range.before_size_ },
-        // ... bytes after '/Contents'
-        { a_byte_range.after_start_ , a_byte_range.after_size_ }
-    };
+    try {
+        
+        // ... bytes before '/Contents' never change, resume from a saved SHA256 state ( if any ) ...
+        const bool resume = ( true == cache && 0 == a_byte_range.before_start_ );
+        size_t     skip   = 0;
+        if ( true == resume && false == digest_cache_->Restore(a_file.uri(), a_byte_range.before_size_, context, skip) ) {
+            skip = 0;
+            if ( 1 != EVP_DigestInit_ex(context, EVP_sha256(), nullptr) ) {
+                throw ::cc::Exception("%s", "Unable to initialize SHA256 context!");
+            }
+        }
+
+        const auto update = [context] (const unsigned char* a_bytes, const size_t& a_size) {
+            if ( 1 != EVP_DigestUpdate(context, a_bytes, a_size) ) {
+                throw ::cc::Exception("%s", "Unable to update SHA256 context!");
+            }
+        };
+        
+        // ... bytes before '/Contents' ...
+        a_file.Read(a_byte_range.before_start_ + skip, a_byte_range.before_size_ - skip, update);
+        // ... they are also the start of the next signed version of this document ...
+        if ( true == resume ) {
+            digest_cache_->Save(a_file.uri(), a_byte_range.before_size_, context);
+        }
+        // ... bytes after '/Contents' ...
+        a_file.Read(a_byte_range.after_start_, a_byte_range.after_size_, update);
+        
+        digest_stats_ = a_file.stats();
+        
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int  length = 0;
+        if ( 1 != EVP_DigestFinal_ex(context, md, &length) ) {
+            throw ::cc::Exception("%s", "Unable to calculate SHA256 digest!");
+        }
+        
+        EVP_MD_CTX_free(context);
+        
+        unsigned char encoded[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+        const int     encoded_length = EVP_EncodeBlock(encoded, md, static_cast<int>(length));
+        o_digest = std::string(reinterpret_cast<const char*>(encoded), static_cast<size_t>(encoded_length));
+        
+        if ( true == cache ) {
+            digest_cache_->Remember(a_file.uri(), a_byte_range, o_digest);
+        }
+        
+    } catch (...) {
+        EVP_MD_CTX_free(context);
+        cc::Exception::Rethrow(/* a_unhandled */ false, __FILE__, __LINE__, __FUNCTION__);
+    }
+}
+
+// MARK: - [PRIVATE] - EXPORT
+
+/**
+ * @brief Export a PCKS7 in PEM format.
+ *
+ * @param a_file  Previously open file.
+ * @param a_range /ByteRange info where PKCS7 is at.
+ * @param o_uri   When not null, local file URI where to write PKCS7 PEM data.
+ * @param o_pem   When not null, PKCS7 PEM data.
+ */
+void casper::pdf::Signer::Export (io::File& a_file, const casper::pdf::Signer::ByteRange& a_range, const std::string* o_uri, std::vector<unsigned char>* o_pem)
+{
+    const size_t size = a_file.Size();
     
-    cc::hash::SHA256 sha256;
+    const size_t start  = a_range.before_start_ + a_range.before_size_ + 1;
+    const size_t end    = a_range.after_start_ - 1;
+    const size_t length = end - start;
     
-    sha256.Initialize();
-
-    // ... two iterations required ...
-    for ( auto it : chunks ) {        
-        // ... go ot the beginning of byte range ...
-        fr.Seek(it.first);
-        size_t br  = 0;
-        size_t rm  = it.second;
-        size_t cs  = std::min(buffer_size_, rm);
-        bool   eof = true;
-        // ... read and update hash calculation ...
-        while ( ( br = fr.Read(buffer_, cs, eof) ) && false == eof ) {
-            sha256.Update(buffer_, br);
-            rm -= br;
-            cs  = std::min(buffer_size_, rm);
-        }
+    if ( size < length ) {
+        throw cc::Exception("%s", sk_pdf_contents_not_enough_bytes_to_read_);
     }
     
-    fr.Close();
+    // ... PKCS7 object is followed by '0' padding, use DER header to skip it ...
+    unsigned char header[12];
+    const size_t  header_hex_length = std::min(( length / 2 ) * 2, 2 * sizeof(header));
+    unsigned char header_hex[2 * sizeof(header)];
+    a_file.Read(start, header_hex, header_hex_length);
+    const size_t  header_length     = casper::codec::Hex::Decode(header_hex, header_hex_length, header);
+    const size_t  der_length        = casper::openssl::P7::DERLength(header, header_length);
     
-    o_digest = sha256.FinalEncoded(::cc::hash::SHA256::OutputFormat::BASE64_RFC4648);
+    // ... unknown or bogus length? decode the whole window ...
+    const size_t  hex_length        = ( 0 != der_length && 2 * der_length <= length ) ? 2 * der_length : ( length / 2 ) * 2;
+    
+    // ... HEX 2 BIN, streamed by chunks straight to PKCS7 loader ...
+    io::File* file = &a_file;
+    const auto producer = [file, start, hex_length] (const std::function<void(const unsigned char*, const size_t&)>& a_callback) {
+        unsigned char bin[4096];
+        unsigned char pending[2];
+        bool          has_pending = false;
+        file->Read(start, hex_length, [&a_callback, &bin, &pending, &has_pending] (const unsigned char* a_hex, const size_t& a_size) {
+            const unsigned char* ptr = a_hex;
+            size_t               len = a_size;
+            // ... chunk boundary split a byte? ...
+            if ( true == has_pending && len > 0 ) {
+                pending[1] = ptr[0];
+                a_callback(bin, casper::codec::Hex::Decode(pending, 2, bin));
+                has_pending = false;
+                ptr += 1;
+                len -= 1;
+            }
+            while ( len >= 2 ) {
+                const size_t count = std::min(len / 2, sizeof(bin));
+                a_callback(bin, casper::codec::Hex::Decode(ptr, 2 * count, bin));
+                ptr += 2 * count;
+                len -= 2 * count;
+            }
+            if ( 1 == len ) {
+                pending[0]  = ptr[0];
+                has_pending = true;
+            }
+        });
+    };
+    if ( nullptr != o_pem ) {
+        casper::openssl::P7::Export(producer, *o_pem);
+    } else {
+        casper::openssl::P7::Export(producer, *o_uri);
+    }
+}
+
+// MARK: - [PRIVATE] - STATIC Method(s) / Function(s)
+
+/**
+ * @return Process peak resident set size, in bytes, since process start.
+ */
+size_t casper::pdf::Signer::PeakRSS ()
+{
+#ifdef __linux__
+    FILE* status = fopen("/proc/self/status", "r");
+    if ( nullptr != status ) {
+        char   line[256];
+        size_t kb = 0;
+        while ( nullptr != fgets(line, sizeof(line), status) ) {
+            if ( 0 == strncmp(line, "VmHWM:", 6) ) {
+                kb = static_cast<size_t>(strtoull(line + 6, nullptr, 10));
+                break;
+            }
+        }
+        fclose(status);
+        if ( 0 != kb ) {
+            return kb * 1024;
+        }
+    }
+#endif
+    struct rusage usage;
+    if ( 0 != getrusage(RUSAGE_SELF, &usage) ) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
 }
 
 // MARK: - STATIC OneShot Call Method(s) / Function(s)
@@ -660,3 +1217,20 @@ void casper::pdf::Signer::Setup ()
 {
     casper::pdf::podofo::Writer::Setup();
 }
+
+/**
+ * @brief Translate a C string to a \link Signer::WriterBackend \link.
+ *
+ * @param a_backend Backend name, case insensitive ( 'podofo' or 'native' ).
+ *
+ * @return One of \link Signer::WriterBackend \link.
+ */
+casper::pdf::Signer::WriterBackend casper::pdf::Signer::CString2WriterBackend (const char* const a_backend)
+{
+    for ( auto backend : { Signer::WriterBackend::PoDoFo, Signer::WriterBackend::Native } ) {
+        if ( 0 == strcasecmp(a_backend, WriterBackend2CString(backend)) ) {
+            return backend;
+        }
+    }
+    throw ::cc::Exception("Don't know how to translate '%s' to a writer backend!", a_backend);
+}
@@ -23,12 +23,18 @@
 
 #include "cc/non-copyable.h"
 #include "cc/non-movable.h"
+#include "cc/exception.h"
+#include "cc/types.h"
 
 #include <string>
+#include <vector>
 
 #include "casper/openssl/p7.h"
 
+#include "casper/io/file.h"
+
 #include "casper/pdf/annotation.h"
+#include "casper/pdf/digest_cache.h"
 
 namespace casper
 {
@@ -46,6 +52,21 @@ namespace casper
                 typedef ::casper::pdf::ByteRange    ByteRange;
                 typedef ::casper::pdf::SigningInfo  SigningInfo;
                 typedef ::casper::pdf::Certificates Certificates;
+                typedef ::casper::pdf::Delta        Delta;
+                
+                typedef ::casper::pdf::SignatureDescriptors SignatureDescriptors;
+                
+                enum class WriterBackend : uint8_t {
+                    PoDoFo = 0, //!< podofo::Writer, loads the document object model.
+                    Native      //!< native::Writer, reads only what's needed and serializes new objects directly - invisible signatures only.
+                };
+                
+                typedef struct {
+                    WriterBackend backend_;    //!< Backend that wrote the placeholder.
+                    uint64_t      elapsed_us_; //!< Time spent writing the placeholder, in microseconds.
+                    uint64_t      load_us_;    //!< Time spent loading the document, in microseconds - 0 for native backend.
+                    size_t        peak_rss_;   //!< Process peak resident set size since start, sampled after writing the placeholder, in bytes - process wide, not per call.
+                } PlaceholderStats;
                 
             public: // Static Data
                 
@@ -78,8 +99,13 @@ namespace casper
                 
             private: // Data
                 
-                size_t          buffer_size_;
-                unsigned char*  buffer_;
+                io::File::Settings     io_settings_;
+                io::File::Stats        digest_stats_;
+                io::File::CopyStrategy copy_strategy_;
+                pdf::DigestCache*      digest_cache_;
+                WriterBackend          writer_backend_;
+                bool                   load_on_demand_;
+                PlaceholderStats       placeholder_stats_;
 
             public: // Constructor(s) / Destructor
                 
@@ -87,6 +113,18 @@ namespace casper
                 Signer (const char* const a_signer_name, const char* const a_signature_name = "casper-pdf-signature");
                 virtual ~Signer ();
                 
+            public: // Setup - Method(s) / Function(s)
+                
+                void                      Set                (const io::File::Settings& a_settings);
+                void                      Set                (pdf::DigestCache* a_cache);
+                void                      Set                (const WriterBackend a_backend);
+                void                      EnableLoadOnDemand (const bool a_enabled);
+                const io::File::Settings& io_settings        () const;
+                const io::File::Stats&    digest_stats       () const;
+                io::File::CopyStrategy    copy_strategy      () const;
+                WriterBackend             writer_backend     () const;
+                const PlaceholderStats&   placeholder_stats  () const;
+                
             public: // Placeholder - Method(s) / Function(s)
                 
                 void GetSigningTime (std::string& o_time);
@@ -95,6 +133,15 @@ namespace casper
                                      std::string& o_out);
 
                 void SetPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation);
+                
+                void SetPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation,
+                                     std::string& o_digest);
+                
+                void SetPlaceholder (const std::string& a_in, const std::string& a_delta, pdf::SignatureAnnotation& a_annotation,
+                                     Signer::Delta& o_delta, std::string& o_digest);
+
+                void SetPlaceholder (const unsigned char* a_bytes, const size_t a_size, pdf::SignatureAnnotation& a_annotation,
+                                     std::vector<unsigned char>& o_out, std::string& o_digest);
 
             public: // Signing Attributes - Method(s) / Function(s)
                 
@@ -105,6 +152,13 @@ namespace casper
                                                  const Signer::Certificate& a_certificate,
                                                  Signer::SigningInfo& a_info);
                 
+                void CalculateSigningAttributes (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_byte_range,
+                                                 Signer::SigningInfo& a_info);
+                
+                void CalculateSigningAttributes (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_byte_range,
+                                                 const Signer::Certificate& a_certificate,
+                                                 Signer::SigningInfo& a_info);
+                
                 void CalculateSigningAttributes (const Signer::Certificate& a_certificate,
                                                  Signer::SigningInfo& a_info);
                 
@@ -120,33 +174,133 @@ namespace casper
                 void Sign (const std::string& a_uri,
                            const Signer::ByteRange& a_range, const Signer::SigningInfo& a_info,
                            const Signer::Certificates& a_certificates);
+                
+                void Sign (const std::string& a_delta, const Signer::Delta& a_delta_info,
+                           const Signer::ByteRange& a_range, const std::string& a_digest,
+                           const Signer::Certificates& a_certificates, const Signer::PrivateKey& a_key,
+                           Signer::SigningInfo& o_info);
+                
+                void Sign (const std::string& a_delta, const Signer::Delta& a_delta_info,
+                           const Signer::ByteRange& a_range, const Signer::SigningInfo& a_info,
+                           const Signer::Certificates& a_certificates);
+                
+                void Sign (std::vector<unsigned char>& a_buffer,
+                           const Signer::ByteRange& a_range, const std::string& a_digest,
+                           const Signer::Certificates& a_certificates, const Signer::PrivateKey& a_key,
+                           Signer::SigningInfo& o_info);
+                
+                void Sign (std::vector<unsigned char>& a_buffer,
+                           const Signer::ByteRange& a_range, const Signer::SigningInfo& a_info,
+                           const Signer::Certificates& a_certificates);
 
             public: // Method(s) / Function(s)
                 
-                void ZeroOut (const std::string& a_uri, const Signer::ByteRange& a_byte_range);
+                void ZeroOut     (const std::string& a_uri, const Signer::ByteRange& a_byte_range);
+                void ZeroOut     (std::vector<unsigned char>& a_buffer, const Signer::ByteRange& a_byte_range);
+                void Materialize (const std::string& a_original, const std::string& a_delta, const Signer::Delta& a_info,
+                                  const std::string& a_out, const bool a_verify = false);
                                 
             public: // Data Extraction - Method(s) / Function(s)
                 
                 void GetByteRange (const std::string& a_uri, const ssize_t a_page, Signer::ByteRange& o_range);
                 void Export       (const std::string& a_uri, const Signer::ByteRange& a_range, const std::string& o_uri);
+                
+                void GetByteRange (const unsigned char* a_bytes, const size_t a_size, const ssize_t a_page, Signer::ByteRange& o_range);
+                void Export       (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_range, const std::string& o_uri);
+                void Export       (const unsigned char* a_bytes, const size_t a_size, const Signer::ByteRange& a_range, std::vector<unsigned char>& o_pem);
+                
+                void GetSignatures (const std::string& a_uri, Signer::SignatureDescriptors& o_signatures);
+                void GetSignatures (const unsigned char* a_bytes, const size_t a_size, Signer::SignatureDescriptors& o_signatures);
 
             private: // Method(s) / Function(s)
                 
-                void Write (const std::string& a_uri, const Signer::ByteRange& a_byte_range,
+                void AppendPlaceholder (const std::string& a_in, const std::string& a_out, pdf::SignatureAnnotation& a_annotation,
+                                        std::string* o_digest);
+                
+                void Write (const std::string& a_uri, const size_t a_offset, const Signer::ByteRange& a_byte_range,
+                            const unsigned char* a_bytes, const size_t a_size);
+                
+                void Write (io::File& a_file, const size_t a_offset, const Signer::ByteRange& a_byte_range,
                             const unsigned char* a_bytes, const size_t a_size);
                                 
-                void ZeroOut (FILE* a_fp, const Signer::ByteRange& a_byte_range);
-
-                void ZeroOut (FILE* a_fp, const size_t& a_size);
+                void ZeroOut (io::File& a_file, const Signer::ByteRange& a_byte_range);
                 
                 void CalculateDigest (const std::string& a_uri, const Signer::ByteRange& a_byte_range, std::string& o_digest);
+                void CalculateDigest (io::File& a_file, const Signer::ByteRange& a_byte_range, std::string& o_digest);
+                
+                void Export (io::File& a_file, const Signer::ByteRange& a_range, const std::string* o_uri, std::vector<unsigned char>* o_pem);
+                
+            private: // Static Method(s) / Function(s)
+                
+                static size_t PeakRSS ();
                 
             public: // Static Method(s) / Function(s)
                 
-                static void Setup ();
+                static void              Setup                 ();
+                static const char* const WriterBackend2CString (const WriterBackend& a_backend);
+                static WriterBackend     CString2WriterBackend (const char* const a_backend);
 
             }; // end of class 'Signer'
     
+            /**
+             * @return R/O access to I/O settings.
+             */
+            inline const io::File::Settings& Signer::io_settings () const
+            {
+                return io_settings_;
+            }
+    
+            /**
+             * @return R/O access to the last digest calculation I/O statistics.
+             */
+            inline const io::File::Stats& Signer::digest_stats () const
+            {
+                return digest_stats_;
+            }
+    
+            /**
+             * @return Strategy used to create the output file by the last \link SetPlaceholder \link call.
+             */
+            inline io::File::CopyStrategy Signer::copy_strategy () const
+            {
+                return copy_strategy_;
+            }
+    
+            /**
+             * @return Backend used by file based, non-delta, \link SetPlaceholder \link calls.
+             */
+            inline Signer::WriterBackend Signer::writer_backend () const
+            {
+                return writer_backend_;
+            }
+    
+            /**
+             * @return R/O access to the last file based \link SetPlaceholder \link call time and memory statistics.
+             */
+            inline const Signer::PlaceholderStats& Signer::placeholder_stats () const
+            {
+                return placeholder_stats_;
+            }
+    
+            /**
+             * @brief Translate a \link Signer::WriterBackend \link to a C string.
+             *
+             * @param a_backend One of \link Signer::WriterBackend \link.
+             *
+             * @return Backend as C string.
+             */
+            inline const char* const Signer::WriterBackend2CString (const Signer::WriterBackend& a_backend)
+            {
+                switch(a_backend) {
+                    case Signer::WriterBackend::PoDoFo:
+                        return "podofo";
+                    case Signer::WriterBackend::Native:
+                        return "native";
+                    default:
+                        throw ::cc::Exception("Don't know how to translate writer backend " UINT8_FMT " to string!", static_cast<uint8_t>(a_backend));
+                }
+            }
+    
     } // end of namespace 'pdf'
 
 } // end of namespace 'casper'
@@ -24,6 +24,7 @@
 #include "casper/openssl/certificate.h"
 
 #include <string>
+#include <vector>
 
 namespace casper
 {
@@ -38,6 +39,24 @@ namespace casper
             size_t after_size_;
         } ByteRange;
 
+        typedef struct {
+            std::string name_;           //!< Signature field fully qualified name.
+            size_t      page_;           //!< Number of the page, 1..n, where the first widget is.
+            ByteRange   byte_range_;     //!< Signed bytes.
+            size_t      contents_start_; //!< /Contents hexadecimal string offset, '<' included.
+            size_t      contents_end_;   //!< /Contents hexadecimal string end offset, exclusive ( one past '>' ).
+            std::string signing_time_;   //!< /M, as written ( PDF date ), empty if not set.
+            std::string reason_;         //!< /Reason, UTF-8 encoded, empty if not set.
+            size_t      revision_;       //!< 1..n, order in which signatures were added ( by signed bytes coverage ).
+        } SignatureDescriptor;
+
+        typedef std::vector<SignatureDescriptor> SignatureDescriptors;
+
+        typedef struct {
+            size_t      original_size_;   //!< Original document size, in bytes - incremental update starts at this offset.
+            std::string original_digest_; //!< Original document SHA256, base 64 encoded.
+        } Delta;
+
         typedef struct {
             std::string oid_;
             std::string author_;
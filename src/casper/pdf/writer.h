@@ -52,7 +52,7 @@ namespace casper
             
             virtual void Open   (const std::string& a_in, const std::string& a_out, const bool a_overwrite = false) = 0;
             virtual void Open   (const std::string& a_io) = 0;
-            virtual void Append (const SignatureAnnotation& a_annotation) = 0;
+            virtual void Append (const SignatureAnnotation& a_annotation, ByteRange& o_range) = 0;
             virtual void Close  () = 0;
             
         }; // end of class 'Writer'
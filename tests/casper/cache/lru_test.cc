@@ -0,0 +1,89 @@
+/**
+ * @file lru_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/cache/lru.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// MARK: - Helper(s)
+
+static std::vector<int> Entries (const casper::cache::LRU<int>& a_lru)
+{
+    return std::vector<int>(a_lru.begin(), a_lru.end());
+}
+
+// MARK: - Test(s)
+
+TEST(LRUTest, EvictsLeastRecentlyUsed)
+{
+    std::vector<int>        released;
+    casper::cache::LRU<int> lru(3, [&released] (int& a_entry) {
+        released.push_back(a_entry);
+    });
+
+    EXPECT_EQ(0u, lru.Push(1));
+    EXPECT_EQ(0u, lru.Push(2));
+    EXPECT_EQ(0u, lru.Push(3));
+    lru.Touch(lru.Find([] (const int& a_entry) { return 1 == a_entry; }));
+    EXPECT_EQ(std::vector<int>({ 2, 3, 1 }), Entries(lru));
+
+    EXPECT_EQ(1u, lru.Push(4));
+    EXPECT_EQ(std::vector<int>({ 3, 1, 4 }), Entries(lru));
+    EXPECT_EQ(std::vector<int>({ 2 }), released);
+}
+
+TEST(LRUTest, ReleasesErasedEntries)
+{
+    std::vector<int>        released;
+    casper::cache::LRU<int> lru(8, [&released] (int& a_entry) {
+        released.push_back(a_entry);
+    });
+
+    for ( int entry = 1 ; entry <= 6 ; ++entry ) {
+        (void)lru.Push(static_cast<int>(entry));
+    }
+    lru.EraseIf([] (const int& a_entry) { return 0 == a_entry % 2; });
+    EXPECT_EQ(std::vector<int>({ 1, 3, 5 }), Entries(lru));
+    EXPECT_EQ(std::vector<int>({ 2, 4, 6 }), released);
+
+    EXPECT_EQ(lru.end(), lru.Find([] (const int& a_entry) { return 2 == a_entry; }));
+    (void)lru.Erase(lru.Find([] (const int& a_entry) { return 3 == a_entry; }));
+    EXPECT_EQ(std::vector<int>({ 1, 5 }), Entries(lru));
+
+    lru.Clear();
+    EXPECT_EQ(0u, lru.size());
+    EXPECT_EQ(std::vector<int>({ 2, 4, 6, 3, 1, 5 }), released);
+}
+
+TEST(LRUTest, ReleasesOnDestruction)
+{
+    size_t released = 0;
+    {
+        casper::cache::LRU<int> lru(2, [&released] (int&) {
+            released++;
+        });
+        (void)lru.Push(1);
+        (void)lru.Push(2);
+    }
+    EXPECT_EQ(2u, released);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file hex_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/codec/hex.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+// MARK: - Helper(s)
+
+static std::string Reference (const std::vector<unsigned char>& a_bytes)
+{
+    static const char* const sk_digits = "0123456789ABCDEF";
+    std::string hex;
+    for ( auto byte : a_bytes ) {
+        hex += sk_digits[byte >> 4];
+        hex += sk_digits[byte & 0x0F];
+    }
+    return hex;
+}
+
+static std::vector<unsigned char> Bytes (const size_t a_size, const unsigned a_seed)
+{
+    std::vector<unsigned char> bytes(a_size);
+    unsigned                   state = a_seed;
+    for ( auto& byte : bytes ) {
+        state = state * 1103515245 + 12345;
+        byte  = static_cast<unsigned char>(state >> 16);
+    }
+    return bytes;
+}
+
+// MARK: - Encode
+
+TEST(Hex, EncodesEveryByteValue)
+{
+    std::vector<unsigned char> bytes(256);
+    for ( size_t idx = 0 ; idx < bytes.size() ; ++idx ) {
+        bytes[idx] = static_cast<unsigned char>(idx);
+    }
+    std::string hex(2 * bytes.size(), '\0');
+    casper::codec::Hex::Encode(bytes.data(), bytes.size(), reinterpret_cast<unsigned char*>(&hex[0]));
+    EXPECT_EQ(Reference(bytes), hex);
+}
+
+TEST(Hex, EncodesAnySizeAndAlignment)
+{
+    // ... cover vector bodies, scalar tails and unaligned buffers ...
+    for ( size_t size = 0 ; size < 200 ; ++size ) {
+        for ( size_t offset = 0 ; offset < 4 ; ++offset ) {
+            const std::vector<unsigned char> bytes = Bytes(size + offset, static_cast<unsigned>(size));
+            const std::vector<unsigned char> slice(bytes.begin() + static_cast<long>(offset), bytes.end());
+            std::vector<unsigned char>       hex(2 * size + offset + 1, 0xAA);
+            casper::codec::Hex::Encode(bytes.data() + offset, size, hex.data() + offset);
+            EXPECT_EQ(Reference(slice), std::string(reinterpret_cast<const char*>(hex.data() + offset), 2 * size)) << "size " << size << ", offset " << offset;
+            // ... nothing is written past the output ...
+            EXPECT_EQ(0xAA, hex[2 * size + offset]);
+        }
+    }
+}
+
+// MARK: - Decode
+
+TEST(Hex, DecodesUpperAndLowerCase)
+{
+    const std::string upper = "00017F80FFA5C3DEADBEEF0123456789ABCDEF";
+    std::string       lower = upper;
+    for ( auto& c : lower ) {
+        c = static_cast<char>(tolower(c));
+    }
+    for ( const auto& hex : { upper, lower } ) {
+        std::vector<unsigned char> bytes(hex.length() / 2);
+        ASSERT_EQ(bytes.size(), casper::codec::Hex::Decode(reinterpret_cast<const unsigned char*>(hex.data()), hex.length(), bytes.data()));
+        EXPECT_EQ(upper, Reference(bytes));
+    }
+}
+
+TEST(Hex, RoundTripsAnySize)
+{
+    for ( size_t size = 0 ; size < 200 ; ++size ) {
+        const std::vector<unsigned char> bytes = Bytes(size, static_cast<unsigned>(size) + 7);
+        std::vector<unsigned char>       hex(2 * size);
+        std::vector<unsigned char>       decoded(size);
+        casper::codec::Hex::Encode(bytes.data(), size, hex.data());
+        ASSERT_EQ(size, casper::codec::Hex::Decode(hex.data(), hex.size(), decoded.data()));
+        EXPECT_EQ(bytes, decoded) << "size " << size;
+    }
+}
+
+TEST(Hex, RejectsOddLength)
+{
+    const std::string          hex = "ABC";
+    std::vector<unsigned char> bytes(2);
+    EXPECT_THROW(casper::codec::Hex::Decode(reinterpret_cast<const unsigned char*>(hex.data()), hex.length(), bytes.data()), ::cc::Exception);
+}
+
+TEST(Hex, RejectsInvalidCharacterAtAnyPosition)
+{
+    // ... invalid character in vector bodies and scalar tails ...
+    for ( size_t length = 2 ; length <= 96 ; length += 2 ) {
+        for ( size_t position = 0 ; position < length ; ++position ) {
+            std::string hex(length, 'a');
+            hex[position] = 'g';
+            std::vector<unsigned char> bytes(length / 2);
+            EXPECT_THROW(casper::codec::Hex::Decode(reinterpret_cast<const unsigned char*>(hex.data()), hex.length(), bytes.data()), ::cc::Exception)
+                << "length " << length << ", position " << position;
+        }
+    }
+    for ( const char c : { ' ', '/', ':', '@', 'G', '`', '\0', '\xFF' } ) {
+        std::string hex(32, '0');
+        hex[17] = c;
+        std::vector<unsigned char> bytes(16);
+        EXPECT_THROW(casper::codec::Hex::Decode(reinterpret_cast<const unsigned char*>(hex.data()), hex.length(), bytes.data()), ::cc::Exception);
+    }
+}
@@ -0,0 +1,132 @@
+/**
+ * @file file_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/io/memory/file.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+// MARK: - Helper(s)
+
+static std::vector<unsigned char> Bytes (const std::string& a_string)
+{
+    return std::vector<unsigned char>(a_string.begin(), a_string.end());
+}
+
+// MARK: - Read only buffers
+
+TEST(MemoryFile, ReadsFromReadOnlyBuffer)
+{
+    const std::vector<unsigned char> bytes = Bytes("%PDF-1.7 hello world");
+
+    casper::io::memory::File file(4);
+    file.Open(bytes.data(), bytes.size());
+    EXPECT_EQ(bytes.size(), file.Size());
+
+    unsigned char buffer[5];
+    file.Read(9, buffer, sizeof(buffer));
+    EXPECT_EQ("hello", std::string(reinterpret_cast<const char*>(buffer), sizeof(buffer)));
+
+    // ... callback read delivers the whole range straight from memory, in one chunk ...
+    std::string read;
+    size_t      calls = 0;
+    file.Read(0, bytes.size(), [&read, &calls] (const unsigned char* a_bytes, const size_t& a_length) {
+        read.append(reinterpret_cast<const char*>(a_bytes), a_length);
+        calls++;
+    });
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), read);
+    EXPECT_EQ(1u, calls);
+    EXPECT_EQ(bytes.size(), file.stats().bytes_);
+
+    file.Close();
+}
+
+TEST(MemoryFile, RejectsOutOfBoundsReads)
+{
+    const std::vector<unsigned char> bytes = Bytes("0123456789");
+
+    casper::io::memory::File file(4);
+    file.Open(bytes.data(), bytes.size());
+
+    unsigned char buffer[4];
+    EXPECT_THROW(file.Read(8, buffer, 4), ::cc::Exception);
+    EXPECT_THROW(file.Read(11, buffer, 0), ::cc::Exception);
+    EXPECT_THROW(file.Read(1, static_cast<size_t>(-1), [] (const unsigned char*, const size_t&) {}), ::cc::Exception);
+    EXPECT_NO_THROW(file.Read(10, buffer, 0));
+
+    file.Close();
+}
+
+TEST(MemoryFile, RejectsWritesToReadOnlyBuffer)
+{
+    const std::vector<unsigned char> bytes = Bytes("0123456789");
+
+    casper::io::memory::File file(4);
+    file.Open(bytes.data(), bytes.size());
+    EXPECT_THROW(file.Write(0, bytes.data(), 1), ::cc::Exception);
+    EXPECT_THROW(file.Fill(0, '0', 1), ::cc::Exception);
+    file.Close();
+}
+
+// MARK: - Read / write buffers
+
+TEST(MemoryFile, WritesAndFillsReadWriteBuffer)
+{
+    std::vector<unsigned char> buffer = Bytes("/Contents <ABCDEF>");
+
+    casper::io::memory::File file(4);
+    file.Open(buffer);
+
+    // ... fill, as used to zero-out a /Contents, spans several buffer sized chunks ...
+    file.Fill(11, '0', 6);
+    EXPECT_EQ("/Contents <000000>", std::string(buffer.begin(), buffer.end()));
+
+    // ... writing past the end grows the buffer ...
+    const std::vector<unsigned char> tail = Bytes("\n%%EOF");
+    file.Write(buffer.size(), tail.data(), tail.size());
+    EXPECT_EQ("/Contents <000000>\n%%EOF", std::string(buffer.begin(), buffer.end()));
+    EXPECT_EQ(buffer.size(), file.Size());
+
+    file.Close();
+}
+
+// MARK: - Open / Close
+
+TEST(MemoryFile, RequiresABuffer)
+{
+    std::vector<unsigned char> buffer;
+
+    casper::io::memory::File file(4);
+    EXPECT_THROW(file.Size(), ::cc::Exception);
+    EXPECT_THROW(file.Open("/tmp/document.pdf", casper::io::File::Mode::Read), ::cc::Exception);
+
+    file.Open(buffer);
+    EXPECT_THROW(file.Open(buffer), ::cc::Exception);
+    file.Close();
+    // ... close is idempotent and the file can be re-opened ...
+    file.Close();
+    EXPECT_NO_THROW(file.Open(buffer));
+    file.Close();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file certificate_cache_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/certificate.h"
+#include "casper/openssl/certificate_cache.h"
+
+#include "pki.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstdio>  // remove
+#include <cstdlib> // mkstemp
+
+#include <fcntl.h>    // AT_FDCWD
+#include <sys/stat.h> // utimensat
+#include <unistd.h>   // close
+
+// MARK: - Helper(s)
+
+class CertificateCacheTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string                        uri_;
+    std::string                        pem_[2];
+    std::string                        cn_[2];
+    casper::openssl::CertificateCache* cache_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        char tmp[] = "/tmp/casper-certificate-cache-XXXXXX";
+        const int fd = mkstemp(tmp);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        uri_ = tmp;
+        EVP_PKEY* key = casper::tests::PKI::Key();
+        ASSERT_NE(nullptr, key);
+        for ( size_t idx = 0 ; idx < 2 ; ++idx ) {
+            cn_[idx]   = "certificate " + std::to_string(idx);
+            X509* x509 = casper::tests::PKI::Certificate(key, cn_[idx]);
+            pem_[idx]  = casper::tests::PKI::PEM(x509);
+            X509_free(x509);
+        }
+        EVP_PKEY_free(key);
+        cache_ = new casper::openssl::CertificateCache(4, 64 * 1024);
+        casper::openssl::Certificate::SetCache(cache_);
+    }
+
+    virtual void TearDown ()
+    {
+        casper::openssl::Certificate::SetCache(nullptr);
+        delete cache_;
+        remove(uri_.c_str());
+    }
+
+    void Write (const std::string& a_pem, const time_t a_mtime)
+    {
+        ASSERT_TRUE(casper::tests::PKI::Write(uri_, a_pem));
+        // ... explicit modification time, file system timestamps may be too coarse for back to back writes ...
+        const struct timespec times[2] = { { a_mtime, 0 }, { a_mtime, 0 } };
+        ASSERT_EQ(0, utimensat(AT_FDCWD, uri_.c_str(), times, 0));
+    }
+
+    static std::string CN (X509* a_x509)
+    {
+        char cn[256] = { 0 };
+        X509_NAME_get_text_by_NID(X509_get_subject_name(a_x509), NID_commonName, cn, sizeof(cn));
+        return cn;
+    }
+
+    static std::string Load (const casper::openssl::Certificate& a_certificate)
+    {
+        X509* x509 = nullptr;
+        casper::openssl::Certificate::Load(a_certificate, &x509);
+        const std::string cn = CN(x509);
+        casper::openssl::Certificate::Unload(&x509);
+        return cn;
+    }
+
+};
+
+// MARK: - File origin
+
+TEST_F(CertificateCacheTest, ReusesUnchangedFile)
+{
+    Write(pem_[0], 1000);
+    const casper::openssl::Certificate certificate(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::File,
+                                                   casper::openssl::Certificate::Format::DER, uri_);
+    EXPECT_EQ(cn_[0], Load(certificate));
+    EXPECT_EQ(cn_[0], Load(certificate));
+    EXPECT_EQ(1u, cache_->stats().hits_);
+    EXPECT_EQ(1u, cache_->stats().misses_);
+}
+
+TEST_F(CertificateCacheTest, InvalidatesOnModificationTimeChange)
+{
+    Write(pem_[0], 1000);
+    const casper::openssl::Certificate certificate(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::File,
+                                                   casper::openssl::Certificate::Format::DER, uri_);
+    EXPECT_EQ(cn_[0], Load(certificate));
+
+    // ... same size, only modification time tells them apart ...
+    ASSERT_EQ(pem_[0].length(), pem_[1].length());
+    Write(pem_[1], 2000);
+    EXPECT_EQ(cn_[1], Load(certificate));
+    EXPECT_EQ(0u, cache_->stats().hits_);
+    EXPECT_EQ(2u, cache_->stats().misses_);
+}
+
+// MARK: - Memory origin
+
+TEST_F(CertificateCacheTest, KeysMemoryOriginByContents)
+{
+    const casper::openssl::Certificate first(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                             casper::openssl::Certificate::Format::DER, pem_[0]);
+    const casper::openssl::Certificate same(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                            casper::openssl::Certificate::Format::DER, pem_[0]);
+    const casper::openssl::Certificate other(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                             casper::openssl::Certificate::Format::DER, pem_[1]);
+    EXPECT_EQ(cn_[0], Load(first));
+    EXPECT_EQ(cn_[0], Load(same));
+    EXPECT_EQ(cn_[1], Load(other));
+    EXPECT_EQ(1u, cache_->stats().hits_);
+    EXPECT_EQ(2u, cache_->stats().misses_);
+}
+
+// MARK: - Limits
+
+TEST_F(CertificateCacheTest, RespectsLimits)
+{
+    casper::openssl::CertificateCache cache(1, 64 * 1024);
+    casper::openssl::Certificate::SetCache(&cache);
+
+    const casper::openssl::Certificate first(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                             casper::openssl::Certificate::Format::DER, pem_[0]);
+    const casper::openssl::Certificate second(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                              casper::openssl::Certificate::Format::DER, pem_[1]);
+    EXPECT_EQ(cn_[0], Load(first));
+    EXPECT_EQ(cn_[1], Load(second));
+    EXPECT_EQ(1u, cache.stats().evictions_);
+    EXPECT_EQ(cn_[0], Load(first));
+    EXPECT_EQ(0u, cache.stats().hits_);
+
+    // ... certificates larger than allowed are not kept ...
+    casper::openssl::CertificateCache tiny(4, 16);
+    casper::openssl::Certificate::SetCache(&tiny);
+    EXPECT_EQ(cn_[0], Load(first));
+    EXPECT_EQ(cn_[0], Load(first));
+    EXPECT_EQ(0u, tiny.stats().hits_);
+
+    casper::openssl::Certificate::SetCache(cache_);
+}
+
+TEST_F(CertificateCacheTest, HandedOutCertificatesOutliveEviction)
+{
+    const casper::openssl::Certificate certificate(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                                   casper::openssl::Certificate::Format::DER, pem_[0]);
+    X509* x509 = nullptr;
+    casper::openssl::Certificate::Load(certificate, &x509);
+    cache_->Clear();
+    EXPECT_EQ(cn_[0], CN(x509));
+    casper::openssl::Certificate::Unload(&x509);
+}
@@ -0,0 +1,205 @@
+/**
+ * @file p7_template_cache_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/p7.h"
+#include "casper/openssl/p7_template_cache.h"
+
+#include "pki.h"
+
+#include "cc/b64.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <openssl/rand.h>
+
+// MARK: - Helper(s)
+
+class P7TemplateCacheTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string pem_[2];
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        EVP_PKEY* key = casper::tests::PKI::Key();
+        ASSERT_NE(nullptr, key);
+        for ( size_t idx = 0 ; idx < 2 ; ++idx ) {
+            X509* x509 = casper::tests::PKI::Certificate(key, "certificate " + std::to_string(idx));
+            pem_[idx]  = casper::tests::PKI::PEM(x509);
+            X509_free(x509);
+        }
+        EVP_PKEY_free(key);
+    }
+
+    virtual void TearDown ()
+    {
+        casper::openssl::P7::SetTemplateCache(nullptr);
+    }
+
+    static casper::openssl::P7TemplateCache::Template Template (const char a_fill)
+    {
+        casper::openssl::P7TemplateCache::Template t;
+        t.der_          = std::string(64, a_fill);
+        t.digest_       = { 0, 32 };
+        t.signing_time_ = { 0, 0  };
+        t.enc_digest_   = { 32, 32 };
+        return t;
+    }
+
+    static std::string Random (const size_t a_size)
+    {
+        std::string bytes(a_size, '\0');
+        EXPECT_EQ(1, RAND_bytes(reinterpret_cast<unsigned char*>(&bytes[0]), static_cast<int>(a_size)));
+        return ::cc::base64_rfc4648::encode(reinterpret_cast<const unsigned char*>(bytes.c_str()), bytes.length());
+    }
+
+    std::string Sign (const std::string& a_digest, const std::string& a_enc_digest, const std::string& a_signing_time)
+    {
+        const casper::openssl::Certificate certificate(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                                       casper::openssl::Certificate::Format::DER, pem_[0]);
+        casper::openssl::Certificate::Chain chain;
+        chain.push_back(casper::openssl::Certificate(casper::openssl::Certificate::Type::Issuer, casper::openssl::Certificate::Origin::Memory,
+                                                     casper::openssl::Certificate::Format::DER, pem_[1]));
+        std::string der;
+        casper::openssl::P7::Sign(certificate, chain, a_digest, a_enc_digest, a_signing_time,
+                                  [&der] (const unsigned char* a_bytes, const size_t& a_size) {
+                                      der.assign(reinterpret_cast<const char*>(a_bytes), a_size);
+                                  });
+        return der;
+    }
+
+};
+
+// MARK: - Cache
+
+TEST_F(P7TemplateCacheTest, RejectsZeroCapacity)
+{
+    EXPECT_THROW(casper::openssl::P7TemplateCache(0), ::cc::Exception);
+}
+
+TEST_F(P7TemplateCacheTest, KeepsTemplates)
+{
+    casper::openssl::P7TemplateCache           cache(2);
+    casper::openssl::P7TemplateCache::Template t;
+
+    EXPECT_FALSE(cache.Get("a", t));
+    cache.Put("a", Template('a'));
+    ASSERT_TRUE(cache.Get("a", t));
+    EXPECT_EQ(std::string(64, 'a'), t.der_);
+    EXPECT_EQ(32u, t.enc_digest_.offset_);
+
+    // ... same key replaces previous template ...
+    cache.Put("a", Template('b'));
+    ASSERT_TRUE(cache.Get("a", t));
+    EXPECT_EQ(std::string(64, 'b'), t.der_);
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(2u, stats.hits_);
+    EXPECT_EQ(1u, stats.misses_);
+    EXPECT_EQ(0u, stats.evictions_);
+}
+
+TEST_F(P7TemplateCacheTest, EvictsLeastRecentlyUsed)
+{
+    casper::openssl::P7TemplateCache           cache(2);
+    casper::openssl::P7TemplateCache::Template t;
+
+    cache.Put("a", Template('a'));
+    cache.Put("b", Template('b'));
+    // ... 'a' becomes the most recently used one ...
+    ASSERT_TRUE(cache.Get("a", t));
+    cache.Put("c", Template('c'));
+
+    EXPECT_TRUE(cache.Get("a", t));
+    EXPECT_FALSE(cache.Get("b", t));
+    EXPECT_TRUE(cache.Get("c", t));
+    EXPECT_EQ(1u, cache.stats().evictions_);
+
+    cache.Clear();
+    EXPECT_FALSE(cache.Get("a", t));
+    EXPECT_FALSE(cache.Get("c", t));
+}
+
+TEST_F(P7TemplateCacheTest, RejectsSlotsOutOfBounds)
+{
+    casper::openssl::P7TemplateCache           cache(2);
+    casper::openssl::P7TemplateCache::Template t = Template('a');
+
+    t.enc_digest_ = { 60, 32 };
+    cache.Put("a", t);
+    EXPECT_FALSE(cache.Get("a", t));
+
+    t = Template('a');
+    t.signing_time_ = { static_cast<size_t>(-1), 2 };
+    cache.Put("a", t);
+    EXPECT_FALSE(cache.Get("a", t));
+}
+
+// MARK: - P7::Sign
+
+TEST_F(P7TemplateCacheTest, MatchesRegularPath)
+{
+    casper::openssl::P7TemplateCache cache(4);
+
+    const char* const times[] = { "251016101010Z", "", "491231235959Z", "500101000000Z", "20500101000000Z" };
+    for ( size_t idx = 0 ; idx < 20 ; ++idx ) {
+        const std::string digest     = Random(0 == idx % 2 ? 32 : 48);
+        const std::string enc_digest = Random(256);
+        const std::string time       = times[idx % 5];
+
+        casper::openssl::P7::SetTemplateCache(nullptr);
+        const std::string expected = Sign(digest, enc_digest, time);
+
+        casper::openssl::P7::SetTemplateCache(&cache);
+        EXPECT_EQ(expected, Sign(digest, enc_digest, time)) << "#" << idx << " '" << time << "'";
+    }
+
+    EXPECT_LT(0u, cache.stats().hits_);
+}
+
+TEST_F(P7TemplateCacheTest, InvalidSigningTimeFallsBackToRegularPath)
+{
+    casper::openssl::P7TemplateCache cache(4);
+
+    const std::string digest     = Random(32);
+    const std::string enc_digest = Random(256);
+    // ... same length as a valid UTCTime, so the template key matches ...
+    const std::string invalid    = "251399999999Z";
+
+    casper::openssl::P7::SetTemplateCache(&cache);
+    (void)Sign(digest, enc_digest, "251016101010Z");
+    (void)Sign(digest, enc_digest, "251016101010Z");
+    const auto before = cache.stats();
+    ASSERT_EQ(1u, before.hits_);
+
+    const std::string actual = Sign(digest, enc_digest, invalid);
+    const auto        after  = cache.stats();
+    EXPECT_EQ(before.hits_, after.hits_);
+
+    casper::openssl::P7::SetTemplateCache(nullptr);
+    EXPECT_EQ(Sign(digest, enc_digest, invalid), actual);
+}
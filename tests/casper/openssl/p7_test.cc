@@ -0,0 +1,175 @@
+/**
+ * @file p7_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/p7.h"
+
+#include "pki.h"
+
+#include "cc/b64.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstring> // strlen
+
+#include <openssl/rand.h>
+
+// MARK: - Helper(s)
+
+class P7Test : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string pem_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        EVP_PKEY* key = casper::tests::PKI::Key();
+        ASSERT_NE(nullptr, key);
+        X509* x509 = casper::tests::PKI::Certificate(key, "signer");
+        pem_ = casper::tests::PKI::PEM(x509);
+        X509_free(x509);
+        EVP_PKEY_free(key);
+    }
+
+    static std::string Random (const size_t a_size)
+    {
+        std::string bytes(a_size, '\0');
+        EXPECT_EQ(1, RAND_bytes(reinterpret_cast<unsigned char*>(&bytes[0]), static_cast<int>(a_size)));
+        return ::cc::base64_rfc4648::encode(reinterpret_cast<const unsigned char*>(bytes.c_str()), bytes.length());
+    }
+
+    static std::string Decode (const std::string& a_b64)
+    {
+        std::string bytes(( a_b64.length() / 4 ) * 3, '\0');
+        const int   length = EVP_DecodeBlock(reinterpret_cast<unsigned char*>(&bytes[0]),
+                                             reinterpret_cast<const unsigned char*>(a_b64.c_str()), static_cast<int>(a_b64.length()));
+        EXPECT_LE(0, length);
+        size_t padding = 0;
+        for ( auto it = a_b64.rbegin() ; a_b64.rend() != it && '=' == *it ; ++it ) {
+            padding++;
+        }
+        bytes.resize(static_cast<size_t>(length) - padding);
+        return bytes;
+    }
+
+    casper::openssl::Certificate Certificate () const
+    {
+        return casper::openssl::Certificate(casper::openssl::Certificate::Type::Entity, casper::openssl::Certificate::Origin::Memory,
+                                            casper::openssl::Certificate::Format::DER, pem_);
+    }
+
+    /**
+     * @brief Encode signed attributes the way it was done before \link P7::CalculateSigningAttributes \link had it's own encoder:
+     *        through a \link PKCS7_SIGNER_INFO \link built by OpenSSL and ASN1_item_i2d.
+     */
+    std::string Reference (const std::string& a_digest, const bool a_certificate, const std::string& a_signing_time)
+    {
+        std::string der;
+        casper::openssl::P7::Sign(Certificate(), casper::openssl::Certificate::Chain(), a_digest, Random(256), a_signing_time,
+                                  [&der] (const unsigned char* a_bytes, const size_t& a_size) {
+                                      der.assign(reinterpret_cast<const char*>(a_bytes), a_size);
+                                  });
+        
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(der.c_str());
+        PKCS7*               p7    = d2i_PKCS7(nullptr, &bytes, static_cast<long>(der.length()));
+        EXPECT_NE(nullptr, p7);
+        if ( nullptr == p7 ) {
+            return "";
+        }
+        PKCS7_SIGNER_INFO* si = sk_PKCS7_SIGNER_INFO_value(PKCS7_get_signer_info(p7), 0);
+        if ( false == a_certificate ) {
+            const int loc = X509at_get_attr_by_NID(si->auth_attr, NID_id_smime_aa_signingCertificateV2, -1);
+            EXPECT_LE(0, loc);
+            X509_ATTRIBUTE_free(X509at_delete_attr(si->auth_attr, loc));
+        }
+        unsigned char* ab     = nullptr;
+        const int      length = ASN1_item_i2d(reinterpret_cast<ASN1_VALUE*>(si->auth_attr), &ab, ASN1_ITEM_rptr(PKCS7_ATTR_SIGN));
+        EXPECT_LT(0, length);
+        const std::string rv = ::cc::base64_rfc4648::encode(ab, static_cast<size_t>(length));
+        OPENSSL_free(ab);
+        PKCS7_free(p7);
+        return rv;
+    }
+
+    std::string Calculate (const std::string& a_digest, const bool a_certificate, std::string& io_signing_time)
+    {
+        const casper::openssl::Certificate certificate = Certificate();
+        std::string auth_attr;
+        casper::openssl::P7::CalculateSigningAttributes(a_digest, ( true == a_certificate ? &certificate : nullptr ), io_signing_time, auth_attr);
+        return auth_attr;
+    }
+
+};
+
+// MARK: - CalculateSigningAttributes
+
+TEST_F(P7Test, SigningAttributesMatchOpenSSLEncoding)
+{
+    const char* const times[] = { "251016101010Z", "", "491231235959Z", "500101000000Z" };
+    
+    for ( const bool certificate : { true, false } ) {
+        for ( const size_t size : { 32, 48 } ) {
+            for ( const char* const time : times ) {
+                const std::string digest = Random(size);
+                std::string       signing_time = time;
+                const std::string actual = Calculate(digest, certificate, signing_time);
+                if ( 0 == strlen(time) ) {
+                    // ... current time was used ...
+                    ASSERT_NE(0u, signing_time.length());
+                } else {
+                    EXPECT_EQ(time, signing_time);
+                }
+                EXPECT_EQ(Reference(digest, certificate, signing_time), actual)
+                    << "certificate: " << certificate << ", digest size: " << size << ", time: '" << time << "'";
+            }
+        }
+    }
+}
+
+TEST_F(P7Test, InvalidSigningTimeIsEncodedEmpty)
+{
+    for ( const char* const time : { "251399999999Z", "not a time", "20251016101010Z" } ) {
+        const std::string digest       = Random(32);
+        std::string       signing_time = time;
+        const std::string actual       = Calculate(digest, true, signing_time);
+        EXPECT_EQ("", signing_time) << time;
+        EXPECT_EQ(Reference(digest, true, time), actual) << time;
+        // ... SET { UTCTime ( empty ) } ...
+        EXPECT_NE(std::string::npos, Decode(actual).find(std::string("\x31\x02\x17\x00", 4))) << time;
+    }
+}
+
+TEST_F(P7Test, SigningTimeOutsideUTCTimeRangeIsGeneralizedTime)
+{
+    for ( const char* const time : { "20500101000000Z", "19491231235959Z" } ) {
+        const std::string digest       = Random(32);
+        std::string       signing_time = time;
+        const std::string actual       = Calculate(digest, true, signing_time);
+        EXPECT_EQ(time, signing_time);
+        // ... SET { GeneralizedTime } ...
+        EXPECT_NE(std::string::npos, Decode(actual).find(std::string("\x31\x11\x18\x0F", 4) + time)) << time;
+        EXPECT_EQ(Reference(digest, true, time), actual) << time;
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * @file pki.h
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CASPER_TESTS_OPENSSL_PKI_H_
+#define CASPER_TESTS_OPENSSL_PKI_H_
+
+#include <string>
+#include <cstdio> // fopen, fwrite, fclose
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+namespace casper
+{
+
+    namespace tests
+    {
+    
+        /**
+         * @brief Throw away keys and self-signed certificates, generated at run time.
+         */
+        class PKI final
+        {
+            
+        public: // Static Method(s) / Function(s)
+            
+            /**
+             * @return A new key, caller must release it with EVP_PKEY_free.
+             *
+             * @param a_type EVP_PKEY_RSA or EVP_PKEY_EC.
+             */
+            static EVP_PKEY* Key (const int a_type = EVP_PKEY_RSA)
+            {
+                EVP_PKEY*     key     = nullptr;
+                EVP_PKEY_CTX* context = EVP_PKEY_CTX_new_id(a_type, nullptr);
+                if ( nullptr != context && 1 == EVP_PKEY_keygen_init(context) ) {
+                    if ( EVP_PKEY_RSA == a_type ) {
+                        (void)EVP_PKEY_CTX_set_rsa_keygen_bits(context, 2048);
+                    } else if ( EVP_PKEY_EC == a_type ) {
+                        (void)EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context, NID_X9_62_prime256v1);
+                    }
+                    (void)EVP_PKEY_keygen(context, &key);
+                }
+                EVP_PKEY_CTX_free(context);
+                return key;
+            }
+            
+            /**
+             * @return A new self-signed certificate, caller must release it with X509_free.
+             *
+             * @param a_key Certificate key.
+             * @param a_cn  Subject and issuer common name.
+             */
+            static X509* Certificate (EVP_PKEY* a_key, const std::string& a_cn)
+            {
+                X509* x509 = X509_new();
+                X509_set_version(x509, 2);
+                ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+                X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+                X509_gmtime_adj(X509_getm_notAfter(x509), 24 * 60 * 60);
+                X509_NAME* name = X509_get_subject_name(x509);
+                X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(a_cn.c_str()), -1, -1, 0);
+                X509_set_issuer_name(x509, name);
+                X509_set_pubkey(x509, a_key);
+                X509_sign(x509, a_key, EVP_sha256());
+                return x509;
+            }
+            
+            /**
+             * @return Certificate in PEM format.
+             */
+            static std::string PEM (X509* a_x509)
+            {
+                BIO* bio = BIO_new(BIO_s_mem());
+                PEM_write_bio_X509(bio, a_x509);
+                return Drain(bio);
+            }
+            
+            /**
+             * @return Private key in PEM format, encrypted when a password is provided.
+             */
+            static std::string PEM (EVP_PKEY* a_key, const std::string& a_password = "")
+            {
+                BIO* bio = BIO_new(BIO_s_mem());
+                if ( 0 == a_password.length() ) {
+                    PEM_write_bio_PrivateKey(bio, a_key, nullptr, nullptr, 0, nullptr, nullptr);
+                } else {
+                    PEM_write_bio_PrivateKey(bio, a_key, EVP_aes_256_cbc(), nullptr, 0, nullptr, const_cast<char*>(a_password.c_str()));
+                }
+                return Drain(bio);
+            }
+            
+            /**
+             * @brief Write data to a file.
+             */
+            static bool Write (const std::string& a_uri, const std::string& a_data)
+            {
+                FILE* file = fopen(a_uri.c_str(), "wb");
+                if ( nullptr == file ) {
+                    return false;
+                }
+                const bool ok = ( a_data.length() == fwrite(a_data.data(), 1, a_data.length(), file) );
+                return ( 0 == fclose(file) && ok );
+            }
+            
+        private: // Static Method(s) / Function(s)
+            
+            static std::string Drain (BIO* a_bio)
+            {
+                BUF_MEM* mem = nullptr;
+                BIO_get_mem_ptr(a_bio, &mem);
+                const std::string data = ( nullptr != mem ? std::string(mem->data, mem->length) : "" );
+                BIO_free(a_bio);
+                return data;
+            }
+            
+        }; // end of class 'PKI'
+    
+    } // end of namespace 'tests'
+
+} // end of namespace 'casper'
+
+#endif // CASPER_TESTS_OPENSSL_PKI_H_
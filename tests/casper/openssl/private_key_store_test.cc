@@ -0,0 +1,186 @@
+/**
+ * @file private_key_store_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/openssl/private_key_store.h"
+
+#include "cc/exception.h"
+
+#include "pki.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdio>  // remove
+#include <cstdlib> // mkstemp
+
+#include <fcntl.h>    // AT_FDCWD
+#include <sys/stat.h> // utimensat
+#include <unistd.h>   // close
+
+// MARK: - Helper(s)
+
+class PrivateKeyStoreTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string uri_;
+    EVP_PKEY*   key_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        char tmp[] = "/tmp/casper-private-key-store-XXXXXX";
+        const int fd = mkstemp(tmp);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        uri_ = tmp;
+        key_ = casper::tests::PKI::Key();
+        ASSERT_NE(nullptr, key_);
+        Write(casper::tests::PKI::PEM(key_, "secret"), 1000);
+    }
+
+    virtual void TearDown ()
+    {
+        EVP_PKEY_free(key_);
+        remove(uri_.c_str());
+    }
+
+    void Write (const std::string& a_pem, const time_t a_mtime)
+    {
+        ASSERT_TRUE(casper::tests::PKI::Write(uri_, a_pem));
+        // ... explicit modification time, file system timestamps may be too coarse for back to back writes ...
+        const struct timespec times[2] = { { a_mtime, 0 }, { a_mtime, 0 } };
+        ASSERT_EQ(0, utimensat(AT_FDCWD, uri_.c_str(), times, 0));
+    }
+
+    /**
+     * @return True when a base 64 encoded SHA256 signature was made by \link a_key \link.
+     */
+    static bool Verify (EVP_PKEY* a_key, const std::string& a_data, const std::string& a_signature)
+    {
+        std::vector<unsigned char> signature(a_signature.length());
+        int length = EVP_DecodeBlock(signature.data(), reinterpret_cast<const unsigned char*>(a_signature.c_str()), static_cast<int>(a_signature.length()));
+        for ( size_t idx = a_signature.length() ; idx > 0 && '=' == a_signature[idx - 1] ; --idx ) {
+            --length;
+        }
+        EVP_MD_CTX* context = EVP_MD_CTX_new();
+        const bool  ok      = (    length > 0
+                                && 1 == EVP_DigestVerifyInit(context, nullptr, EVP_sha256(), nullptr, a_key)
+                                && 1 == EVP_DigestVerify(context, signature.data(), static_cast<size_t>(length),
+                                                         reinterpret_cast<const unsigned char*>(a_data.c_str()), a_data.length()) );
+        EVP_MD_CTX_free(context);
+        return ok;
+    }
+
+};
+
+// MARK: - Get
+
+TEST_F(PrivateKeyStoreTest, DecryptsOnce)
+{
+    casper::openssl::PrivateKeyStore store(2);
+    const casper::openssl::PrivateKey key(uri_, "secret");
+
+    EVP_PKEY* first  = store.Get(key);
+    EVP_PKEY* second = store.Get(key);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1, EVP_PKEY_cmp(first, key_));
+    EVP_PKEY_free(first);
+    EVP_PKEY_free(second);
+
+    EXPECT_EQ(1u, store.stats().hits_);
+    EXPECT_EQ(1u, store.stats().misses_);
+}
+
+TEST_F(PrivateKeyStoreTest, RejectsWrongPassword)
+{
+    casper::openssl::PrivateKeyStore store(2);
+    EVP_PKEY* pkey = store.Get(casper::openssl::PrivateKey(uri_, "secret"));
+    EVP_PKEY_free(pkey);
+    // ... a stored key is never handed out for a different password ...
+    EXPECT_THROW(store.Get(casper::openssl::PrivateKey(uri_, "wrong")), ::cc::Exception);
+}
+
+TEST_F(PrivateKeyStoreTest, InvalidatesOnModificationTimeChange)
+{
+    casper::openssl::PrivateKeyStore store(2);
+    const casper::openssl::PrivateKey key(uri_, "secret");
+
+    EVP_PKEY* before = store.Get(key);
+
+    EVP_PKEY* other = casper::tests::PKI::Key();
+    ASSERT_NE(nullptr, other);
+    Write(casper::tests::PKI::PEM(other, "secret"), 2000);
+
+    EVP_PKEY* after = store.Get(key);
+    EXPECT_EQ(1, EVP_PKEY_cmp(after, other));
+    // ... references handed out remain valid ...
+    EXPECT_EQ(1, EVP_PKEY_cmp(before, key_));
+    EXPECT_EQ(2u, store.stats().misses_);
+
+    EVP_PKEY_free(before);
+    EVP_PKEY_free(after);
+    EVP_PKEY_free(other);
+}
+
+TEST_F(PrivateKeyStoreTest, RejectsNonRSAKeys)
+{
+    EVP_PKEY* ec = casper::tests::PKI::Key(EVP_PKEY_EC);
+    ASSERT_NE(nullptr, ec);
+    Write(casper::tests::PKI::PEM(ec, "secret"), 2000);
+    EVP_PKEY_free(ec);
+
+    casper::openssl::PrivateKeyStore store(2);
+    EXPECT_THROW(store.Get(casper::openssl::PrivateKey(uri_, "secret")), ::cc::Exception);
+    EXPECT_THROW(casper::openssl::PrivateKeyStore::Load(casper::openssl::PrivateKey(uri_, "secret")), ::cc::Exception);
+}
+
+// MARK: - SignSHA256
+
+TEST_F(PrivateKeyStoreTest, Signs)
+{
+    casper::openssl::PrivateKeyStore store(2);
+    const casper::openssl::PrivateKey key(uri_, "secret");
+    const std::string                 data = "signed attributes";
+
+    const std::string signature = store.SignSHA256(key, reinterpret_cast<const unsigned char*>(data.c_str()), data.length());
+    EXPECT_TRUE(Verify(key_, data, signature));
+    EXPECT_FALSE(Verify(key_, data + "!", signature));
+    // ... PKCS #1 v1.5 is deterministic ...
+    EXPECT_EQ(signature, store.SignSHA256(key, reinterpret_cast<const unsigned char*>(data.c_str()), data.length()));
+}
+
+TEST_F(PrivateKeyStoreTest, ForgetsEvictedKeys)
+{
+    casper::openssl::PrivateKeyStore store(1);
+    const casper::openssl::PrivateKey key(uri_, "secret");
+
+    EVP_PKEY* pkey = store.Get(key);
+    EVP_PKEY_free(pkey);
+    store.Evict(key);
+    pkey = store.Get(key);
+    EVP_PKEY_free(pkey);
+    EXPECT_EQ(0u, store.stats().hits_);
+    EXPECT_EQ(2u, store.stats().misses_);
+}
@@ -0,0 +1,217 @@
+/**
+ * @file digest_cache_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/digest_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstdio>  // fopen, fwrite, fclose, remove
+#include <cstdlib> // mkstemp
+
+#include <fcntl.h>    // AT_FDCWD
+#include <sys/stat.h> // utimensat
+#include <unistd.h>   // close
+
+#include <openssl/evp.h>
+
+// MARK: - Helper(s)
+
+class DigestCacheTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string uri_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        char tmp[] = "/tmp/casper-digest-cache-XXXXXX";
+        const int fd = mkstemp(tmp);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        uri_ = tmp;
+        Write("%PDF-1.7 0123456789 abcdefghijklmnopqrstuvwxyz", "w", 1000);
+    }
+
+    virtual void TearDown ()
+    {
+        remove(uri_.c_str());
+    }
+
+    void Write (const std::string& a_data, const char* const a_mode, const time_t a_mtime)
+    {
+        FILE* file = fopen(uri_.c_str(), a_mode);
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(a_data.size(), fwrite(a_data.c_str(), 1, a_data.size(), file));
+        fclose(file);
+        // ... explicit modification time, file system timestamps may be too coarse for back to back writes ...
+        const struct timespec times[2] = { { a_mtime, 0 }, { a_mtime, 0 } };
+        ASSERT_EQ(0, utimensat(AT_FDCWD, uri_.c_str(), times, 0));
+    }
+
+    static EVP_MD_CTX* Context (const std::string& a_data)
+    {
+        EVP_MD_CTX* context = EVP_MD_CTX_new();
+        EVP_DigestInit_ex(context, EVP_sha256(), nullptr);
+        EVP_DigestUpdate(context, a_data.c_str(), a_data.size());
+        return context;
+    }
+
+    static std::string Final (EVP_MD_CTX* a_context)
+    {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int  length = 0;
+        EVP_DigestFinal_ex(a_context, md, &length);
+        return std::string(reinterpret_cast<const char*>(md), length);
+    }
+
+};
+
+// MARK: - SHA256 contexts
+
+TEST_F(DigestCacheTest, RestoresSavedContext)
+{
+    casper::pdf::DigestCache cache(4);
+
+    EVP_MD_CTX* saved = Context("%PDF-1.7 ");
+    cache.Save(uri_, 9, saved);
+
+    EVP_MD_CTX* restored = EVP_MD_CTX_new();
+    size_t      size     = 0;
+    ASSERT_TRUE(cache.Restore(uri_, 100, restored, size));
+    EXPECT_EQ(9u, size);
+
+    // ... a restored context continues hashing as the saved one would ...
+    EVP_DigestUpdate(saved, "0123", 4);
+    EVP_DigestUpdate(restored, "0123", 4);
+    EXPECT_EQ(Final(saved), Final(restored));
+
+    // ... never restore more bytes than allowed ...
+    EXPECT_FALSE(cache.Restore(uri_, 8, restored, size));
+    EXPECT_EQ(1u, cache.stats().hits_);
+    EXPECT_EQ(1u, cache.stats().misses_);
+
+    EVP_MD_CTX_free(saved);
+    EVP_MD_CTX_free(restored);
+}
+
+TEST_F(DigestCacheTest, InvalidatesContextOnModificationTimeChange)
+{
+    casper::pdf::DigestCache cache(4);
+
+    EVP_MD_CTX* context = Context("%PDF-1.7 ");
+    cache.Save(uri_, 9, context);
+
+    size_t size = 0;
+    Write("!", "a", 2000);
+    EXPECT_FALSE(cache.Restore(uri_, 100, context, size));
+
+    // ... unless the write was acknowledged and didn't touch hashed bytes ...
+    cache.Save(uri_, 9, context);
+    Write("!", "a", 3000);
+    cache.Touch(uri_, 47);
+    EXPECT_TRUE(cache.Restore(uri_, 100, context, size));
+    cache.Touch(uri_, 5);
+    EXPECT_FALSE(cache.Restore(uri_, 100, context, size));
+
+    EVP_MD_CTX_free(context);
+}
+
+TEST_F(DigestCacheTest, EvictsLeastRecentlyUsedContext)
+{
+    casper::pdf::DigestCache cache(2);
+
+    EVP_MD_CTX* context = Context("");
+    cache.Save(uri_, 1, context);
+    cache.Save(uri_, 2, context);
+    cache.Save(uri_, 3, context);
+    EXPECT_EQ(1u, cache.stats().evictions_);
+
+    size_t size = 0;
+    EXPECT_TRUE(cache.Restore(uri_, 100, context, size));
+    EXPECT_EQ(3u, size);
+    EXPECT_FALSE(cache.Restore(uri_, 1, context, size));
+
+    EVP_MD_CTX_free(context);
+}
+
+// MARK: - /ByteRange digests
+
+TEST_F(DigestCacheTest, InvalidatesDigestOnModificationTimeChange)
+{
+    casper::pdf::DigestCache cache(4);
+
+    const casper::pdf::ByteRange range = { 0, 10, 20, 26 };
+    std::string                  digest;
+
+    cache.Remember(uri_, range, "digest");
+    ASSERT_TRUE(cache.Lookup(uri_, range, digest));
+    EXPECT_EQ("digest", digest);
+
+    Write("%PDF-1.7 0123456789 abcdefghijklmnopqrstuvwxyZ", "w", 2000);
+    EXPECT_FALSE(cache.Lookup(uri_, range, digest));
+}
+
+TEST_F(DigestCacheTest, KeepsDigestWhenOnlyContentsIsWritten)
+{
+    casper::pdf::DigestCache cache(4);
+
+    const casper::pdf::ByteRange range = { 0, 10, 20, 26 };
+    std::string                  digest;
+
+    cache.Remember(uri_, range, "digest");
+    Write("%PDF-1.7 0xxxxxxxx9 abcdefghijklmnopqrstuvwxyz", "w", 2000);
+    cache.Touch(uri_, 10, 20);
+    EXPECT_TRUE(cache.Lookup(uri_, range, digest));
+
+    Write("%PDF-1.7 0123456789 abcdefghijklmnopqrstuvwxyz", "w", 3000);
+    cache.Touch(uri_, 0, 10);
+    EXPECT_FALSE(cache.Lookup(uri_, range, digest));
+}
+
+TEST_F(DigestCacheTest, PersistsDigests)
+{
+    const casper::pdf::ByteRange range = { 0, 10, 20, 26 };
+    const std::string            dump  = uri_ + ".digests";
+    std::string                  digest;
+
+    casper::pdf::DigestCache cache(4);
+    cache.Remember(uri_, range, "n4bQgYhMfWWaL+qgxVrQFaO/TxsrC4Is0V1sFbDwCgg=");
+    cache.Dump(dump);
+
+    casper::pdf::DigestCache loaded(4);
+    loaded.Load(dump);
+    ASSERT_TRUE(loaded.Lookup(uri_, range, digest));
+    EXPECT_EQ("n4bQgYhMfWWaL+qgxVrQFaO/TxsrC4Is0V1sFbDwCgg=", digest);
+
+    // ... stale entries are loaded but never match ...
+    Write("%PDF-1.7 0123456789 abcdefghijklmnopqrstuvwxyz", "w", 2000);
+    casper::pdf::DigestCache stale(4);
+    stale.Load(dump);
+    EXPECT_FALSE(stale.Lookup(uri_, range, digest));
+
+    // ... missing file is not an error ...
+    remove(dump.c_str());
+    EXPECT_NO_THROW(stale.Load(dump));
+}
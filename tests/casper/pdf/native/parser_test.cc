@@ -0,0 +1,280 @@
+/**
+ * @file parser_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/parser.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>  // fopen, fwrite, fclose, remove, snprintf
+#include <cstdlib> // mkstemp
+
+#include <unistd.h> // close
+
+#include <zlib.h>
+
+// MARK: - Helper(s)
+
+/**
+ * @brief Writes a minimal document whose only cross-reference section is a stream.
+ */
+class XRefStreamDocument
+{
+
+public: // Data
+
+    std::vector<std::string> objects_;    //!< Objects 1..n, without 'obj' / 'endobj'.
+    std::vector<size_t>      offsets_;    //!< Objects 1..n offsets, set by \link Write \link.
+    size_t                   xref_;       //!< Cross-reference stream offset, set by \link Write \link.
+    std::string              dictionary_; //!< Cross-reference stream dictionary entries, other than /Type and /Length.
+    bool                     deflate_;    //!< When true, cross-reference stream data is deflated.
+
+public: // Constructor(s) / Destructor
+
+    XRefStreamDocument ()
+    {
+        xref_    = 0;
+        deflate_ = false;
+    }
+
+public: // Method(s) / Function(s)
+
+    /**
+     * @brief Write document.
+     *
+     * @param a_uri  Local file URI.
+     * @param a_data Cross-reference stream data producer, called with objects and stream offsets already known.
+     */
+    void Write (const std::string& a_uri, const std::function<std::string(const XRefStreamDocument&)>& a_data)
+    {
+        std::string document = "%PDF-1.7\n";
+        offsets_.clear();
+        for ( size_t idx = 0 ; idx < objects_.size() ; ++idx ) {
+            offsets_.push_back(document.length());
+            document += std::to_string(idx + 1) + " 0 obj\n" + objects_[idx] + "\nendobj\n";
+        }
+        xref_ = document.length();
+        std::string data = a_data(*this);
+        if ( true == deflate_ ) {
+            data = Deflate(data);
+        }
+        document += std::to_string(objects_.size() + 1) + " 0 obj\n<< /Type /XRef " + dictionary_
+                 +  ( true == deflate_ ? " /Filter /FlateDecode" : "" ) + " /Length " + std::to_string(data.length()) + " >>\nstream\n"
+                 +  data + "\nendstream\nendobj\nstartxref\n" + std::to_string(xref_) + "\n%%EOF\n";
+        FILE* file = fopen(a_uri.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(document.length(), fwrite(document.data(), 1, document.length(), file));
+        fclose(file);
+    }
+
+    /**
+     * @return A /W [1 4 2] cross-reference stream row.
+     */
+    static std::string Row (const uint8_t a_type, const uint32_t a_field2, const uint16_t a_field3)
+    {
+        std::string row(1, static_cast<char>(a_type));
+        for ( int shift = 24 ; shift >= 0 ; shift -= 8 ) {
+            row += static_cast<char>(( a_field2 >> shift ) & 0xFF);
+        }
+        row += static_cast<char>(a_field3 >> 8);
+        row += static_cast<char>(a_field3 & 0xFF);
+        return row;
+    }
+
+    /**
+     * @return Deflated data.
+     */
+    static std::string Deflate (const std::string& a_data)
+    {
+        uLongf      length = compressBound(static_cast<uLong>(a_data.length()));
+        std::string deflated(length, '\0');
+        EXPECT_EQ(Z_OK, compress2(reinterpret_cast<Bytef*>(&deflated[0]), &length, reinterpret_cast<const Bytef*>(a_data.data()),
+                                  static_cast<uLong>(a_data.length()), Z_BEST_COMPRESSION));
+        deflated.resize(length);
+        return deflated;
+    }
+
+};
+
+class ParserTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string                     uri_;
+    casper::io::File::Settings      settings_;
+    XRefStreamDocument              document_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        char tmp[] = "/tmp/casper-parser-XXXXXX";
+        const int fd = mkstemp(tmp);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        uri_      = tmp;
+        settings_ = { casper::io::File::Backend::POSIX, 4096, 4 };
+        document_.objects_.push_back("<< /Type /Catalog /Pages 2 0 R >>");
+        document_.objects_.push_back("<< /Type /Pages /Kids [] /Count 0 >>");
+    }
+
+    virtual void TearDown ()
+    {
+        remove(uri_.c_str());
+    }
+
+    /**
+     * @return Rows for object 0 ( free ), every object in use and the cross-reference stream itself.
+     */
+    static std::string Rows (const XRefStreamDocument& a_document)
+    {
+        std::string rows = XRefStreamDocument::Row(0, 0, 65535);
+        for ( auto offset : a_document.offsets_ ) {
+            rows += XRefStreamDocument::Row(1, static_cast<uint32_t>(offset), 0);
+        }
+        rows += XRefStreamDocument::Row(1, static_cast<uint32_t>(a_document.xref_), 0);
+        return rows;
+    }
+
+    /**
+     * @return True when document can be opened and it's catalog loaded.
+     */
+    bool Open ()
+    {
+        casper::pdf::native::Parser parser(settings_);
+        try {
+            parser.Open(uri_);
+            casper::pdf::native::Value catalog;
+            parser.Resolve(*parser.trailer().Get("Root"), catalog);
+            const casper::pdf::native::Value* type = catalog.Get("Type");
+            parser.Close();
+            return ( nullptr != type && "Catalog" == type->token() );
+        } catch (const ::cc::Exception& a_exception) {
+            parser.Close();
+            return false;
+        }
+    }
+
+};
+
+// MARK: - Well formed
+
+TEST_F(ParserTest, ReadsCrossReferenceStream)
+{
+    document_.dictionary_ = "/Root 1 0 R /W [1 4 2] /Size 4";
+    document_.Write(uri_, Rows);
+    EXPECT_TRUE(Open());
+}
+
+TEST_F(ParserTest, ReadsDeflatedCrossReferenceStreamWithIndex)
+{
+    document_.dictionary_ = "/Root 1 0 R /W [1 4 2] /Size 4 /Index [0 1 1 3]";
+    document_.deflate_    = true;
+    document_.Write(uri_, Rows);
+    EXPECT_TRUE(Open());
+}
+
+// MARK: - Malformed /Size and /Index
+
+TEST_F(ParserTest, RejectsMissingOrInvalidSize)
+{
+    for ( auto size : { "", "/Size -1", "/Size 4.0", "/Size (4)" } ) {
+        document_.dictionary_ = std::string("/Root 1 0 R /W [1 4 2] ") + size;
+        document_.Write(uri_, Rows);
+        EXPECT_FALSE(Open()) << size;
+    }
+}
+
+TEST_F(ParserTest, RejectsInvalidIndex)
+{
+    for ( auto index : { "/Index [0]", "/Index [0 4 5]", "/Index [0 /Four]", "/Index [0.0 4]", "/Index [-1 4]", "/Index [0 -4]", "/Index 0" } ) {
+        document_.dictionary_ = std::string("/Root 1 0 R /W [1 4 2] /Size 4 ") + index;
+        document_.Write(uri_, Rows);
+        EXPECT_FALSE(Open()) << index;
+    }
+}
+
+TEST_F(ParserTest, RejectsIndexBeyondSize)
+{
+    for ( auto index : { "/Index [0 5]", "/Index [1 4]", "/Index [5 0]", "/Index [0 9223372036854775807]", "/Index [9223372036854775807 9223372036854775807]" } ) {
+        document_.dictionary_ = std::string("/Root 1 0 R /W [1 4 2] /Size 4 ") + index;
+        document_.Write(uri_, Rows);
+        EXPECT_FALSE(Open()) << index;
+    }
+}
+
+TEST_F(ParserTest, RejectsTruncatedData)
+{
+    document_.dictionary_ = "/Root 1 0 R /W [1 4 2] /Size 4";
+    document_.Write(uri_, [] (const XRefStreamDocument& a_document) {
+        const std::string rows = Rows(a_document);
+        return rows.substr(0, rows.length() - 1);
+    });
+    EXPECT_FALSE(Open());
+}
+
+TEST_F(ParserTest, RejectsInvalidWidths)
+{
+    for ( auto w : { "/W [0 0 0]", "/W [1 4]", "/W [1 9 2]", "/W [1 -4 2]" } ) {
+        document_.dictionary_ = std::string("/Root 1 0 R /Size 4 ") + w;
+        document_.Write(uri_, Rows);
+        EXPECT_FALSE(Open()) << w;
+    }
+}
+
+// MARK: - Hostile streams
+
+TEST_F(ParserTest, RejectsInflateBomb)
+{
+    // ... more than allowed once inflated, a few KiB on disk ...
+    document_.dictionary_ = "/Root 1 0 R /W [1 4 2] /Size 4";
+    document_.deflate_    = true;
+    document_.Write(uri_, [] (const XRefStreamDocument& a_document) {
+        return Rows(a_document) + std::string(65 * 1024 * 1024, '\0');
+    });
+    EXPECT_FALSE(Open());
+}
+
+TEST_F(ParserTest, RejectsSelfReferencingObjectStream)
+{
+    // ... object 1 is compressed in object stream 3, whose /Length is object 4, compressed in object stream 3 ...
+    document_.objects_.push_back("<< /Type /ObjStm /N 2 /First 8 /Length 4 0 R >>\nstream\n1 0 4 34 << /Type /Catalog /Pages 2 0 R >> 62\nendstream");
+    document_.dictionary_ = "/Root 1 0 R /W [1 4 2] /Size 6";
+    document_.Write(uri_, [] (const XRefStreamDocument& a_document) {
+        return   XRefStreamDocument::Row(0, 0, 65535)
+               + XRefStreamDocument::Row(2, 3, 0)
+               + XRefStreamDocument::Row(1, static_cast<uint32_t>(a_document.offsets_[1]), 0)
+               + XRefStreamDocument::Row(1, static_cast<uint32_t>(a_document.offsets_[2]), 0)
+               + XRefStreamDocument::Row(2, 3, 1)
+               + XRefStreamDocument::Row(1, static_cast<uint32_t>(a_document.xref_), 0);
+    });
+
+    casper::pdf::native::Parser parser(settings_);
+    parser.Open(uri_);
+    casper::pdf::native::Value catalog;
+    EXPECT_THROW(parser.Load(1, catalog), ::cc::Exception);
+    parser.Close();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file reader_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/reader.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdio>  // fopen, fwrite, fclose, remove, snprintf
+#include <cstdlib> // mkstemp
+
+#include <unistd.h> // close
+
+// MARK: - Helper(s)
+
+class NativeReaderTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string                uri_;
+    casper::io::File::Settings settings_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        char tmp[] = "/tmp/casper-native-reader-XXXXXX";
+        const int fd = mkstemp(tmp);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        uri_      = tmp;
+        settings_ = { casper::io::File::Backend::POSIX, 4096, 4 };
+    }
+
+    virtual void TearDown ()
+    {
+        remove(uri_.c_str());
+    }
+
+    /**
+     * @brief Write a two pages document with a signature field, 6 0 R, whose widget is merged with it.
+     *
+     * @param a_p           Widget /P object number.
+     * @param a_annots_page Object number of the page that lists the widget in it's /Annots.
+     * @param a_byte_range  Signature /ByteRange.
+     */
+    void Write (const int a_p, const int a_annots_page, const std::string& a_byte_range = "[0 10 20 30]")
+    {
+        const std::string annots = " /Annots [6 0 R]";
+        const std::vector<std::string> objects = {
+            "<< /Type /Catalog /Pages 2 0 R /AcroForm << /Fields [6 0 R] /SigFlags 3 >> >>",
+            "<< /Type /Pages /Kids [3 0 R 4 0 R] /Count 2 /MediaBox [0 0 595 842] >>",
+            "<< /Type /Page /Parent 2 0 R" + std::string(3 == a_annots_page ? annots : "") + " >>",
+            "<< /Type /Page /Parent 2 0 R" + std::string(4 == a_annots_page ? annots : "") + " >>",
+            "<< /Type /Sig /Filter /Adobe.PPKLite /SubFilter /adbe.pkcs7.detached /ByteRange " + a_byte_range + " /Contents <00> >>",
+            "<< /Type /Annot /Subtype /Widget /FT /Sig /T (Signature1) /V 5 0 R /P " + std::to_string(a_p) + " 0 R /Rect [0 0 0 0] /F 132 >>"
+        };
+        std::vector<size_t> offsets;
+        std::string         document = "%PDF-1.7\n";
+        for ( size_t idx = 0 ; idx < objects.size() ; ++idx ) {
+            offsets.push_back(document.length());
+            document += std::to_string(idx + 1) + " 0 obj\n" + objects[idx] + "\nendobj\n";
+        }
+        const size_t xref = document.length();
+        document += "xref\n0 " + std::to_string(objects.size() + 1) + "\n0000000000 65535 f \n";
+        for ( auto offset : offsets ) {
+            char entry[21];
+            snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offset);
+            document += entry;
+        }
+        document += "trailer\n<< /Size " + std::to_string(objects.size() + 1) + " /Root 1 0 R >>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n";
+
+        FILE* file = fopen(uri_.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(document.length(), fwrite(document.data(), 1, document.length(), file));
+        fclose(file);
+    }
+
+    /**
+     * @return \link casper::pdf::native::Reader::GetByteRange \link result.
+     */
+    bool GetByteRange (const ssize_t a_page, casper::pdf::SignatureAnnotation::ByteRange* o_range = nullptr)
+    {
+        casper::pdf::native::Reader      reader(settings_);
+        casper::pdf::SignatureAnnotation annotation("Signature1");
+        reader.Open(uri_);
+        const bool found = reader.GetByteRange(a_page, annotation);
+        reader.Close();
+        if ( nullptr != o_range ) {
+            (*o_range) = annotation.byte_range();
+        }
+        return found;
+    }
+
+};
+
+// MARK: - GetByteRange
+
+TEST_F(NativeReaderTest, FindsSignatureInAnyPage)
+{
+    Write(/* a_p */ 4, /* a_annots_page */ 4);
+    casper::pdf::SignatureAnnotation::ByteRange range;
+    ASSERT_TRUE(GetByteRange(-1, &range));
+    EXPECT_EQ(0u, range.before_start_);
+    EXPECT_EQ(10u, range.before_size_);
+    EXPECT_EQ(20u, range.after_start_);
+    EXPECT_EQ(30u, range.after_size_);
+}
+
+TEST_F(NativeReaderTest, FindsSignatureInRequestedPage)
+{
+    Write(/* a_p */ 4, /* a_annots_page */ 4);
+    EXPECT_TRUE(GetByteRange(2));
+    EXPECT_FALSE(GetByteRange(1));
+}
+
+TEST_F(NativeReaderTest, DoesNotTrustPageThatDoesNotListWidget)
+{
+    // ... /P says page 1, but only page 2 lists the widget - inconclusive for any page ...
+    Write(/* a_p */ 3, /* a_annots_page */ 4);
+    EXPECT_FALSE(GetByteRange(1));
+    EXPECT_FALSE(GetByteRange(2));
+    // ... page wasn't requested, /P doesn't matter ...
+    EXPECT_TRUE(GetByteRange(0));
+}
+
+TEST_F(NativeReaderTest, RejectsInvalidByteRange)
+{
+    Write(/* a_p */ 4, /* a_annots_page */ 4, "[0 10 20]");
+    casper::pdf::native::Reader      reader(settings_);
+    casper::pdf::SignatureAnnotation annotation("Signature1");
+    reader.Open(uri_);
+    EXPECT_THROW(reader.GetByteRange(-1, annotation), ::cc::Exception);
+    EXPECT_TRUE(reader.invalid());
+    reader.Close();
+}
+
+// MARK: - PageCount
+
+TEST_F(NativeReaderTest, CountsPages)
+{
+    Write(/* a_p */ 4, /* a_annots_page */ 4);
+    casper::pdf::native::Reader reader(settings_);
+    reader.Open(uri_);
+    EXPECT_EQ(2u, reader.PageCount());
+    reader.Close();
+}
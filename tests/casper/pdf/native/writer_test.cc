@@ -0,0 +1,239 @@
+/**
+ * @file writer_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/native/writer.h"
+#include "casper/pdf/native/parser.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdio>  // fopen, fread, fwrite, fclose, remove, snprintf, sscanf
+#include <cstdlib> // mkstemp
+
+#include <unistd.h> // close
+
+#include <openssl/evp.h>
+
+// MARK: - Helper(s)
+
+class NativeWriterTest : public ::testing::Test
+{
+
+protected: // Data
+
+    std::string                in_;
+    std::string                out_;
+    std::string                document_;
+    casper::io::File::Settings settings_;
+
+protected: // Method(s) / Function(s)
+
+    virtual void SetUp ()
+    {
+        in_       = Temporary();
+        out_      = Temporary();
+        settings_ = { casper::io::File::Backend::POSIX, 4096, 4 };
+        // ... one page, cross-reference table ...
+        const std::vector<std::string> objects = {
+            "<< /Type /Catalog /Pages 2 0 R >>",
+            "<< /Type /Pages /Kids [3 0 R] /Count 1 /MediaBox [0 0 595 842] >>",
+            "<< /Type /Page /Parent 2 0 R >>"
+        };
+        std::vector<size_t> offsets;
+        document_ = "%PDF-1.7\n";
+        for ( size_t idx = 0 ; idx < objects.size() ; ++idx ) {
+            offsets.push_back(document_.length());
+            document_ += std::to_string(idx + 1) + " 0 obj\n" + objects[idx] + "\nendobj\n";
+        }
+        const size_t xref = document_.length();
+        document_ += "xref\n0 4\n0000000000 65535 f \n";
+        for ( auto offset : offsets ) {
+            char entry[21];
+            snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offset);
+            document_ += entry;
+        }
+        document_ += "trailer\n<< /Size 4 /Root 1 0 R >>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n";
+        Write(in_, document_);
+    }
+
+    virtual void TearDown ()
+    {
+        remove(in_.c_str());
+        remove(out_.c_str());
+    }
+
+    static std::string Temporary ()
+    {
+        char tmp[] = "/tmp/casper-native-writer-XXXXXX";
+        const int fd = mkstemp(tmp);
+        EXPECT_NE(-1, fd);
+        close(fd);
+        return tmp;
+    }
+
+    static void Write (const std::string& a_uri, const std::string& a_data)
+    {
+        FILE* file = fopen(a_uri.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(a_data.length(), fwrite(a_data.data(), 1, a_data.length(), file));
+        fclose(file);
+    }
+
+    static std::string Read (const std::string& a_uri)
+    {
+        std::string data;
+        FILE*       file = fopen(a_uri.c_str(), "rb");
+        EXPECT_NE(nullptr, file);
+        if ( nullptr != file ) {
+            char   buffer[4096];
+            size_t length;
+            while ( 0 != ( length = fread(buffer, 1, sizeof(buffer), file) ) ) {
+                data.append(buffer, length);
+            }
+            fclose(file);
+        }
+        return data;
+    }
+
+    static casper::pdf::SignatureAnnotation Annotation (const std::string& a_name)
+    {
+        casper::pdf::SignatureAnnotation annotation(a_name);
+        annotation.Set({ 0, 0, 0, 0 }, 1, /* a_visible */ false);
+        annotation.Set(casper::pdf::SignatureAnnotation::SignatureInfo({ "", "author", "reason", "", "", "200101000000Z", 1024 }));
+        return annotation;
+    }
+
+    static std::string SHA256 (const std::string& a_data, const casper::pdf::ByteRange& a_range)
+    {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int  length  = 0;
+        EVP_MD_CTX*   context = EVP_MD_CTX_new();
+        EVP_DigestInit_ex(context, EVP_sha256(), nullptr);
+        EVP_DigestUpdate(context, a_data.data() + a_range.before_start_, a_range.before_size_);
+        EVP_DigestUpdate(context, a_data.data() + a_range.after_start_, a_range.after_size_);
+        EVP_DigestFinal_ex(context, md, &length);
+        EVP_MD_CTX_free(context);
+        unsigned char encoded[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+        const int     encoded_length = EVP_EncodeBlock(encoded, md, static_cast<int>(length));
+        return std::string(reinterpret_cast<const char*>(encoded), static_cast<size_t>(encoded_length));
+    }
+
+};
+
+// MARK: - Open
+
+TEST_F(NativeWriterTest, AcceptsEmptyDestination)
+{
+    casper::pdf::native::Writer writer("test");
+    EXPECT_NO_THROW(writer.Open(in_, out_));
+    writer.Close();
+    EXPECT_EQ(document_, Read(out_));
+}
+
+TEST_F(NativeWriterTest, HonorsOverwrite)
+{
+    Write(out_, "previous contents, longer than nothing");
+    {
+        casper::pdf::native::Writer writer("test");
+        EXPECT_THROW(writer.Open(in_, out_, /* a_overwrite */ false), ::cc::Exception);
+        writer.Close();
+        EXPECT_EQ("previous contents, longer than nothing", Read(out_));
+    }
+    {
+        casper::pdf::native::Writer writer("test");
+        EXPECT_NO_THROW(writer.Open(in_, out_, /* a_overwrite */ true));
+        writer.Close();
+        EXPECT_EQ(document_, Read(out_));
+    }
+}
+
+// MARK: - Append
+
+TEST_F(NativeWriterTest, WritesByteRangeAsReturned)
+{
+    casper::pdf::native::Writer      writer("test");
+    casper::pdf::SignatureAnnotation annotation = Annotation("Signature1");
+    casper::pdf::ByteRange           range;
+
+    writer.EnableDigest(settings_);
+    writer.Open(in_, out_);
+    writer.Append(annotation, range);
+    const std::string digest = writer.digest();
+    writer.Close();
+
+    const std::string out = Read(out_);
+
+    // ... original bytes are untouched, signed bytes are everything but /Contents hexadecimal string ...
+    ASSERT_GT(out.length(), document_.length());
+    EXPECT_EQ(document_, out.substr(0, document_.length()));
+    EXPECT_EQ(0u, range.before_start_);
+    EXPECT_EQ(out.length(), range.after_start_ + range.after_size_);
+    EXPECT_EQ(2u * 1024u + 2u, range.after_start_ - range.before_size_);
+    EXPECT_EQ('<', out[range.before_size_]);
+    EXPECT_EQ('>', out[range.after_start_ - 1]);
+    EXPECT_EQ(std::string(2 * 1024, '0'), out.substr(range.before_size_ + 1, 2 * 1024));
+
+    // ... /ByteRange, as written ...
+    const size_t position = out.find("/ByteRange [", document_.length());
+    ASSERT_NE(std::string::npos, position);
+    size_t written[4] = { 1, 0, 0, 0 };
+    ASSERT_EQ(4, sscanf(out.c_str() + position + 12, "%zu %zu %zu %zu", &written[0], &written[1], &written[2], &written[3]));
+    EXPECT_EQ(range.before_start_, written[0]);
+    EXPECT_EQ(range.before_size_, written[1]);
+    EXPECT_EQ(range.after_start_, written[2]);
+    EXPECT_EQ(range.after_size_, written[3]);
+
+    // ... digest calculated while writing ...
+    EXPECT_EQ(SHA256(out, range), digest);
+}
+
+TEST_F(NativeWriterTest, WritesParsableIncrementalUpdate)
+{
+    casper::pdf::native::Writer      writer("test");
+    casper::pdf::SignatureAnnotation annotation = Annotation("Signature1");
+    casper::pdf::ByteRange           range;
+
+    writer.Open(in_, out_);
+    writer.Append(annotation, range);
+    writer.Close();
+
+    casper::pdf::native::Parser parser(settings_);
+    parser.Open(out_);
+    casper::pdf::native::Value catalog, form, page;
+    parser.Resolve(*parser.trailer().Get("Root"), catalog);
+    ASSERT_NE(nullptr, catalog.Get("AcroForm"));
+    parser.Resolve(*catalog.Get("AcroForm"), form);
+    ASSERT_NE(nullptr, form.Get("Fields"));
+    EXPECT_EQ(1u, form.Get("Fields")->items().size());
+    parser.Load(3, page);
+    ASSERT_NE(nullptr, page.Get("Annots"));
+    EXPECT_EQ(1u, page.Get("Annots")->items().size());
+    parser.Close();
+
+    // ... a second signature with the same name is rejected ...
+    casper::pdf::native::Writer again("test");
+    again.Open(out_);
+    EXPECT_THROW(again.Append(annotation, range), ::cc::Exception);
+    again.Close();
+}
@@ -0,0 +1,247 @@
+/**
+ * @file load_on_demand_bench.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Placeholder append with and without \link casper::pdf::podofo::Writer::EnableLoadOnDemand \link.
+ *
+ * Usage: load_on_demand_bench [-p <pages>] [-i <image KiB>] [-r <runs>] [<document.pdf> ...]
+ *
+ * Without documents, an image-heavy one is generated: one page per image, each image an uncompressed
+ * DeviceRGB stream. Every run is made in a forked child so that peak RSS is the one of that run only.
+ */
+
+#include "casper/pdf/signer.h"
+#include "casper/pdf/annotation.h"
+
+#include "cc/exception.h"
+
+#include <string>
+#include <vector>
+#include <algorithm> // std::sort
+#include <cstdio>    // fopen, fwrite, fclose, printf
+#include <cstdlib>   // strtoull, rand
+#include <cstring>   // strcmp
+
+#include <sys/resource.h> // getrusage
+#include <sys/wait.h>     // waitpid
+#include <unistd.h>       // fork, pipe, getopt
+
+// MARK: - Helper(s)
+
+typedef struct {
+    uint64_t load_us_;    //!< Time spent loading the document, in microseconds.
+    uint64_t elapsed_us_; //!< Time spent appending the placeholder, in microseconds.
+    size_t   peak_rss_;   //!< Child peak resident set size, in bytes.
+    bool     ok_;         //!< True when placeholder was appended.
+} Sample;
+
+/**
+ * @brief Write an image-heavy document.
+ *
+ * @param a_uri   Local file URI.
+ * @param a_pages Number of pages, one image per page.
+ * @param a_kib   Image size, in KiB.
+ */
+static void Generate (const std::string& a_uri, const size_t a_pages, const size_t a_kib)
+{
+    const size_t width  = 512;
+    const size_t height = std::max(static_cast<size_t>(1), ( a_kib * 1024 ) / ( width * 3 ));
+    const size_t length = width * height * 3;
+
+    FILE* file = fopen(a_uri.c_str(), "wb");
+    if ( nullptr == file ) {
+        throw ::cc::Exception("Unable to open file '%s'!", a_uri.c_str());
+    }
+    std::vector<size_t> offsets;
+    size_t              offset = 0;
+    const auto          write  = [file, &offset] (const std::string& a_data) {
+        fwrite(a_data.data(), 1, a_data.length(), file);
+        offset += a_data.length();
+    };
+
+    // ... 1 - catalog, 2 - pages, then page, content and image for each page ...
+    write("%PDF-1.7\n%\xE2\xE3\xCF\xD3\n");
+    offsets.push_back(offset);
+    write("1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+    offsets.push_back(offset);
+    std::string kids;
+    for ( size_t page = 0 ; page < a_pages ; ++page ) {
+        kids += std::to_string(3 + page * 3) + " 0 R ";
+    }
+    write("2 0 obj\n<< /Type /Pages /Kids [ " + kids + "] /Count " + std::to_string(a_pages) + " >>\nendobj\n");
+
+    std::string pixels(length, '\0');
+    for ( size_t page = 0 ; page < a_pages ; ++page ) {
+        const size_t number  = 3 + page * 3;
+        const std::string content = "q 595 0 0 842 0 0 cm /Im0 Do Q";
+        offsets.push_back(offset);
+        write(std::to_string(number) + " 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 595 842]"
+              " /Resources << /XObject << /Im0 " + std::to_string(number + 2) + " 0 R >> >>"
+              " /Contents " + std::to_string(number + 1) + " 0 R >>\nendobj\n");
+        offsets.push_back(offset);
+        write(std::to_string(number + 1) + " 0 obj\n<< /Length " + std::to_string(content.length()) + " >>\nstream\n" + content + "\nendstream\nendobj\n");
+        for ( auto& pixel : pixels ) {
+            pixel = static_cast<char>(rand() & 0xFF);
+        }
+        offsets.push_back(offset);
+        write(std::to_string(number + 2) + " 0 obj\n<< /Type /XObject /Subtype /Image /Width " + std::to_string(width)
+              + " /Height " + std::to_string(height) + " /ColorSpace /DeviceRGB /BitsPerComponent 8 /Length " + std::to_string(length)
+              + " >>\nstream\n" + pixels + "\nendstream\nendobj\n");
+    }
+
+    const size_t xref = offset;
+    char         entry[21];
+    write("xref\n0 " + std::to_string(offsets.size() + 1) + "\n0000000000 65535 f \n");
+    for ( auto it : offsets ) {
+        snprintf(entry, sizeof(entry), "%010zu 00000 n \n", it);
+        write(entry);
+    }
+    write("trailer\n<< /Size " + std::to_string(offsets.size() + 1) + " /Root 1 0 R >>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n");
+    fclose(file);
+}
+
+/**
+ * @brief Append a placeholder in a forked child.
+ *
+ * @param a_in             PDF local URI.
+ * @param a_load_on_demand See \link casper::pdf::Signer::EnableLoadOnDemand \link.
+ *
+ * @return Child measurements.
+ */
+static Sample Run (const std::string& a_in, const bool a_load_on_demand)
+{
+    Sample sample = { 0, 0, 0, false };
+    int    fds[2];
+    if ( 0 != pipe(fds) ) {
+        return sample;
+    }
+    const pid_t pid = fork();
+    if ( 0 == pid ) {
+        close(fds[0]);
+        try {
+            casper::pdf::Signer signer("load-on-demand-bench");
+            signer.Set(casper::pdf::Signer::WriterBackend::PoDoFo);
+            signer.EnableLoadOnDemand(a_load_on_demand);
+
+            casper::pdf::SignatureAnnotation annotation("Signature1");
+            annotation.Set({ 0, 0, 0, 0 }, 1, /* a_visible */ false);
+            annotation.Set(casper::pdf::SignatureAnnotation::SignatureInfo({ "", "bench", "bench", "bench", "", "200101000000Z", 8192 }));
+
+            const std::string out = a_in + ( true == a_load_on_demand ? ".on.pdf" : ".off.pdf" );
+            signer.SetPlaceholder(a_in, out, annotation);
+            (void)unlink(out.c_str());
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            sample.load_us_    = signer.placeholder_stats().load_us_;
+            sample.elapsed_us_ = signer.placeholder_stats().elapsed_us_;
+            sample.peak_rss_   = static_cast<size_t>(usage.ru_maxrss) * 1024;
+            sample.ok_         = true;
+        } catch (const ::cc::Exception& a_exception) {
+            fprintf(stderr, "%s\n", a_exception.what());
+        }
+        (void)!write(fds[1], &sample, sizeof(sample));
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if ( pid > 0 ) {
+        (void)!read(fds[0], &sample, sizeof(sample));
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return sample;
+}
+
+/**
+ * @return Median sample, by elapsed time.
+ */
+static Sample Median (std::vector<Sample>& a_samples)
+{
+    std::sort(a_samples.begin(), a_samples.end(), [] (const Sample& a_lhs, const Sample& a_rhs) {
+        return a_lhs.elapsed_us_ < a_rhs.elapsed_us_;
+    });
+    return a_samples[a_samples.size() / 2];
+}
+
+// MARK: - Main
+
+int main (int a_argc, char** a_argv)
+{
+    size_t pages = 200;
+    size_t kib   = 512;
+    size_t runs  = 5;
+    int    opt;
+    while ( -1 != ( opt = getopt(a_argc, a_argv, "p:i:r:") ) ) {
+        switch (opt) {
+            case 'p': pages = static_cast<size_t>(strtoull(optarg, nullptr, 10)); break;
+            case 'i': kib   = static_cast<size_t>(strtoull(optarg, nullptr, 10)); break;
+            case 'r': runs  = std::max(static_cast<size_t>(1), static_cast<size_t>(strtoull(optarg, nullptr, 10))); break;
+            default:
+                fprintf(stderr, "usage: %s [-p <pages>] [-i <image KiB>] [-r <runs>] [<document.pdf> ...]\n", a_argv[0]);
+                return -1;
+        }
+    }
+
+    std::vector<std::string> documents(a_argv + optind, a_argv + a_argc);
+    std::string              generated;
+    if ( 0 == documents.size() ) {
+        generated = "/tmp/casper-load-on-demand-bench-" + std::to_string(getpid()) + ".pdf";
+        try {
+            Generate(generated, pages, kib);
+        } catch (const ::cc::Exception& a_exception) {
+            fprintf(stderr, "%s\n", a_exception.what());
+            return -1;
+        }
+        documents.push_back(generated);
+    }
+
+    casper::pdf::Signer::Setup();
+
+    printf("%-48s %-14s %12s %12s %12s\n", "document", "load-on-demand", "load ms", "append ms", "peak RSS MiB");
+    int rv = 0;
+    for ( auto& document : documents ) {
+        for ( auto mode : { false, true } ) {
+            std::vector<Sample> samples;
+            for ( size_t run = 0 ; run < runs ; ++run ) {
+                const Sample sample = Run(document, mode);
+                if ( false == sample.ok_ ) {
+                    rv = -1;
+                    break;
+                }
+                samples.push_back(sample);
+            }
+            if ( 0 == samples.size() ) {
+                printf("%-48s %-14s %12s %12s %12s\n", document.c_str(), ( true == mode ? "on" : "off" ), "-", "-", "-");
+                continue;
+            }
+            const Sample median = Median(samples);
+            printf("%-48s %-14s %12.1f %12.1f %12.1f\n", document.c_str(), ( true == mode ? "on" : "off" ),
+                   static_cast<double>(median.load_us_) / 1000.0, static_cast<double>(median.elapsed_us_) / 1000.0,
+                   static_cast<double>(median.peak_rss_) / ( 1024.0 * 1024.0 ));
+        }
+    }
+
+    if ( 0 != generated.length() ) {
+        (void)unlink(generated.c_str());
+    }
+    return rv;
+}
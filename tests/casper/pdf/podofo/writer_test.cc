@@ -0,0 +1,257 @@
+/**
+ * @file writer_test.cc
+ *
+ * Copyright (c) 2011-2020 Cloudware S.A. All rights reserved.
+ *
+ * This file is part of casper-pdf-signer.
+ *
+ * casper-pdf-signer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * casper-pdf-signer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with casper. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "casper/pdf/podofo/writer.h"
+#include "casper/pdf/native/writer.h"
+#include "casper/pdf/native/parser.h"
+
+#include "cc/exception.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdio>  // fopen, fread, fwrite, fclose, remove, snprintf, sscanf
+#include <cstdlib> // mkstemp
+
+#include <unistd.h> // close
+
+#include <openssl/evp.h>
+
+// MARK: - Helper(s)
+
+/**
+ * @brief Same document, same annotation, appended by PoDoFo and by the native writer.
+ */
+class ByteRangeTest : public ::testing::Test
+{
+
+protected: // Data Type(s)
+
+    typedef struct {
+        std::string            uri_;
+        std::string            data_;
+        casper::pdf::ByteRange range_;
+        std::string            digest_;
+    } Output;
+
+protected: // Data
+
+    std::string                in_;
+    std::string                document_;
+    casper::io::File::Settings settings_;
+    Output                     podofo_;
+    Output                     native_;
+
+protected: // Method(s) / Function(s)
+
+    static void SetUpTestCase ()
+    {
+        casper::pdf::podofo::Writer::Setup();
+    }
+
+    virtual void SetUp ()
+    {
+        in_          = Temporary();
+        podofo_.uri_ = Temporary();
+        native_.uri_ = Temporary();
+        settings_    = { casper::io::File::Backend::POSIX, 4096, 4 };
+        // ... two pages, cross-reference table ...
+        const std::vector<std::string> objects = {
+            "<< /Type /Catalog /Pages 2 0 R >>",
+            "<< /Type /Pages /Kids [3 0 R 4 0 R] /Count 2 /MediaBox [0 0 595 842] >>",
+            "<< /Type /Page /Parent 2 0 R /Resources << >> >>",
+            "<< /Type /Page /Parent 2 0 R /Resources << >> >>"
+        };
+        std::vector<size_t> offsets;
+        document_ = "%PDF-1.7\n";
+        for ( size_t idx = 0 ; idx < objects.size() ; ++idx ) {
+            offsets.push_back(document_.length());
+            document_ += std::to_string(idx + 1) + " 0 obj\n" + objects[idx] + "\nendobj\n";
+        }
+        const size_t xref = document_.length();
+        document_ += "xref\n0 5\n0000000000 65535 f \n";
+        for ( auto offset : offsets ) {
+            char entry[21];
+            snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offset);
+            document_ += entry;
+        }
+        document_ += "trailer\n<< /Size 5 /Root 1 0 R >>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n";
+        Write(in_, document_);
+
+        casper::pdf::SignatureAnnotation annotation("Signature1");
+        annotation.Set({ 0, 0, 0, 0 }, 2, /* a_visible */ false);
+        annotation.Set(casper::pdf::SignatureAnnotation::SignatureInfo({ "", "author", "reason", "", "", "200101000000Z", 4096 }));
+        {
+            casper::pdf::podofo::Writer writer("test");
+            writer.EnableDigest(settings_);
+            writer.Open(in_, podofo_.uri_);
+            writer.Append(annotation, podofo_.range_);
+            writer.Close();
+            podofo_.digest_ = writer.digest();
+            podofo_.data_   = Read(podofo_.uri_);
+        }
+        {
+            casper::pdf::native::Writer writer("test");
+            writer.EnableDigest(settings_);
+            writer.Open(in_, native_.uri_);
+            writer.Append(annotation, native_.range_);
+            writer.Close();
+            native_.digest_ = writer.digest();
+            native_.data_   = Read(native_.uri_);
+        }
+    }
+
+    virtual void TearDown ()
+    {
+        remove(in_.c_str());
+        remove(podofo_.uri_.c_str());
+        remove(native_.uri_.c_str());
+    }
+
+    static std::string Temporary ()
+    {
+        char tmp[] = "/tmp/casper-byte-range-XXXXXX";
+        const int fd = mkstemp(tmp);
+        EXPECT_NE(-1, fd);
+        close(fd);
+        return tmp;
+    }
+
+    static void Write (const std::string& a_uri, const std::string& a_data)
+    {
+        FILE* file = fopen(a_uri.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(a_data.length(), fwrite(a_data.data(), 1, a_data.length(), file));
+        fclose(file);
+    }
+
+    static std::string Read (const std::string& a_uri)
+    {
+        std::string data;
+        FILE*       file = fopen(a_uri.c_str(), "rb");
+        EXPECT_NE(nullptr, file);
+        if ( nullptr != file ) {
+            char   buffer[4096];
+            size_t length;
+            while ( 0 != ( length = fread(buffer, 1, sizeof(buffer), file) ) ) {
+                data.append(buffer, length);
+            }
+            fclose(file);
+        }
+        return data;
+    }
+
+    /**
+     * @return /ByteRange, as written in the incremental update.
+     */
+    static casper::pdf::ByteRange Written (const Output& a_output, const size_t a_from)
+    {
+        casper::pdf::ByteRange range = { 1, 0, 0, 0 };
+        const size_t position = a_output.data_.find("/ByteRange", a_from);
+        EXPECT_NE(std::string::npos, position);
+        if ( std::string::npos != position ) {
+            const size_t open = a_output.data_.find('[', position);
+            EXPECT_EQ(4, sscanf(a_output.data_.c_str() + open + 1, "%zu %zu %zu %zu",
+                                &range.before_start_, &range.before_size_, &range.after_start_, &range.after_size_));
+        }
+        return range;
+    }
+
+    static std::string SHA256 (const Output& a_output)
+    {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int  length  = 0;
+        EVP_MD_CTX*   context = EVP_MD_CTX_new();
+        EVP_DigestInit_ex(context, EVP_sha256(), nullptr);
+        EVP_DigestUpdate(context, a_output.data_.data() + a_output.range_.before_start_, a_output.range_.before_size_);
+        EVP_DigestUpdate(context, a_output.data_.data() + a_output.range_.after_start_, a_output.range_.after_size_);
+        EVP_DigestFinal_ex(context, md, &length);
+        EVP_MD_CTX_free(context);
+        unsigned char encoded[( ( EVP_MAX_MD_SIZE + 2 ) / 3 ) * 4 + 1];
+        const int     encoded_length = EVP_EncodeBlock(encoded, md, static_cast<int>(length));
+        return std::string(reinterpret_cast<const char*>(encoded), static_cast<size_t>(encoded_length));
+    }
+
+    void Verify (const Output& a_output)
+    {
+        // ... original bytes are untouched ...
+        ASSERT_GT(a_output.data_.length(), document_.length());
+        EXPECT_EQ(document_, a_output.data_.substr(0, document_.length()));
+        // ... /ByteRange covers everything but /Contents hexadecimal string ...
+        EXPECT_EQ(0u, a_output.range_.before_start_);
+        EXPECT_GE(a_output.range_.before_size_, document_.length());
+        EXPECT_EQ(a_output.data_.length(), a_output.range_.after_start_ + a_output.range_.after_size_);
+        EXPECT_EQ('<', a_output.data_[a_output.range_.before_size_]);
+        EXPECT_EQ('>', a_output.data_[a_output.range_.after_start_ - 1]);
+        // ... as returned, as written and as hashed ...
+        const casper::pdf::ByteRange written = Written(a_output, document_.length());
+        EXPECT_EQ(a_output.range_.before_start_, written.before_start_);
+        EXPECT_EQ(a_output.range_.before_size_, written.before_size_);
+        EXPECT_EQ(a_output.range_.after_start_, written.after_start_);
+        EXPECT_EQ(a_output.range_.after_size_, written.after_size_);
+        EXPECT_EQ(SHA256(a_output), a_output.digest_);
+    }
+
+};
+
+// MARK: - /ByteRange
+
+TEST_F(ByteRangeTest, PoDoFoWritesConsistentByteRange)
+{
+    Verify(podofo_);
+}
+
+TEST_F(ByteRangeTest, NativeWritesConsistentByteRange)
+{
+    Verify(native_);
+}
+
+TEST_F(ByteRangeTest, NativeMatchesPoDoFo)
+{
+    // ... same /Contents size, both appended after the original document ...
+    EXPECT_EQ(podofo_.range_.after_start_ - podofo_.range_.before_size_, native_.range_.after_start_ - native_.range_.before_size_);
+    EXPECT_EQ(2u * 4096u + 2u, native_.range_.after_start_ - native_.range_.before_size_);
+
+    // ... both signature fields are found, by name, on the same page ...
+    for ( auto output : { &podofo_, &native_ } ) {
+        casper::pdf::native::Parser parser(settings_);
+        parser.Open(output->uri_);
+        casper::pdf::native::Value catalog, form, fields, page;
+        parser.Resolve(*parser.trailer().Get("Root"), catalog);
+        ASSERT_NE(nullptr, catalog.Get("AcroForm"));
+        parser.Resolve(*catalog.Get("AcroForm"), form);
+        ASSERT_NE(nullptr, form.Get("Fields"));
+        parser.Resolve(*form.Get("Fields"), fields);
+        ASSERT_EQ(1u, fields.items().size());
+        casper::pdf::native::Value field;
+        parser.Resolve(fields.items()[0], field);
+        ASSERT_NE(nullptr, field.Get("T"));
+        EXPECT_EQ("Signature1", field.Get("T")->Text());
+        parser.Load(4, page);
+        ASSERT_NE(nullptr, page.Get("Annots"));
+        casper::pdf::native::Value annots;
+        parser.Resolve(*page.Get("Annots"), annots);
+        ASSERT_EQ(1u, annots.items().size());
+        EXPECT_EQ(fields.items()[0].integer(), annots.items()[0].integer());
+        parser.Close();
+    }
+}